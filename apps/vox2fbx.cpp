@@ -28,6 +28,9 @@
 #define OGT_VOXEL_MESHIFY_IMPLEMENTATION
 #include "../src/ogt_voxel_meshify.h"
 
+#include <string>
+#include <vector>
+
 FILE * open_file(const char *filename, const char *mode)
 {
 #if defined(_MSC_VER) && _MSC_VER >= 1400
@@ -71,14 +74,16 @@ void print_help() {
     printf(
         "vox2fbx v1.0 by Justin Paver - source code available here: http://github.com/jpaver/opengametools \n"
         "\n"
-        "This tool extracts models out of MagicaVoxel .vox files and saves them as meshes within individual ascii .fbx files.\n"
+        "This tool extracts models out of MagicaVoxel .vox files and saves them as meshes within individual ascii or binary .fbx files.\n"
         "\n"
         " usage: vox2fbx [optional args] <input_file.vox> <input_file2.vox> ... \n"
         "\n"
         " [optional args] can be one or multiple of:\n"
         " --mesh_algorithm <algo> : (default: polygon) sets the meshing mode where <algo> is one of: simple, greedy or polygon\n"
         " --named-models-only     : (default: disabled) will only generate an fbx for models in the vox file that have named instances\n"
-        " --y-as-up               : (default: disabled) rotate model on export so that y is up"
+        " --y-as-up               : (default: disabled) rotate model on export so that y is up\n"
+        " --binary                : (default: disabled) write binary FBX 7.4 files instead of ascii FBX 6.1 files. These are much smaller\n"
+        "                           and faster to write and import, and store colors as an index into the palette colors of the mesh"
         "\n"
         "examples:\n"
         "  vox2fbx --mesh_algorithm greedy --named-models-only test_scene.vox\n"
@@ -255,6 +260,383 @@ bool write_mesh_to_fbx(const char* output_filename, const ogt_mesh* mesh, const
     return true;
 }
 
+// a binary FBX 7.4 file being assembled in memory. Each node record starts with its end offset, property count and property
+// list length, which are only known once its properties and children are written, so the header of each open node is
+// patched when its first child is added or when it is closed.
+struct fbx_binary_node {
+    size_t   header_offset;
+    size_t   property_offset;
+    uint32_t property_count;
+    bool     has_children;
+};
+
+struct fbx_binary_writer {
+    std::vector<uint8_t>         data;
+    std::vector<fbx_binary_node> open_nodes;
+};
+
+static const uint32_t k_fbx_binary_version       = 7400;
+static const size_t   k_fbx_binary_sentinel_size = 13;     // a null node record that ends each nested list of nodes in version 7.4
+
+// these are the identifiers that are written by every file that has this creation time. Loaders check the ids match the time.
+static const uint8_t  k_fbx_binary_file_id[16]   = { 0x28, 0xb3, 0x2a, 0xeb, 0xb6, 0x24, 0xcc, 0xc2, 0xbf, 0xc8, 0xb0, 0x2a, 0xa9, 0x2b, 0xfc, 0xf1 };
+static const uint8_t  k_fbx_binary_footer_id[16] = { 0xfa, 0xbc, 0xab, 0x09, 0xd0, 0xc8, 0xd4, 0x66, 0xb1, 0x76, 0xfb, 0x83, 0x1c, 0xf7, 0x26, 0x7e };
+static const uint8_t  k_fbx_binary_footer_magic[16] = { 0xf8, 0x5a, 0x8c, 0x6a, 0xde, 0xf5, 0xd9, 0x7e, 0xec, 0xe9, 0x0c, 0xe3, 0x75, 0x8f, 0x29, 0x0b };
+static const char*    k_fbx_binary_creation_time = "1970-01-01 10:00:00:000";
+
+void fbx_write(fbx_binary_writer& w, const void* data, size_t size) {
+    w.data.insert(w.data.end(), (const uint8_t*)data, (const uint8_t*)data + size);
+}
+
+void fbx_write_u32(fbx_binary_writer& w, uint32_t value) {
+    fbx_write(w, &value, sizeof(value));
+}
+
+void fbx_patch_u32(fbx_binary_writer& w, size_t offset, size_t value) {
+    uint32_t value32 = (uint32_t)value;
+    memcpy(&w.data[offset], &value32, sizeof(value32));
+}
+
+void fbx_begin_node(fbx_binary_writer& w, const char* name) {
+    if (!w.open_nodes.empty()) {
+        fbx_binary_node& parent = w.open_nodes.back();
+        if (!parent.has_children) {
+            parent.has_children = true;
+            fbx_patch_u32(w, parent.header_offset + 8, w.data.size() - parent.property_offset);
+        }
+    }
+    fbx_binary_node node;
+    node.header_offset  = w.data.size();
+    node.property_count = 0;
+    node.has_children   = false;
+    uint8_t name_length = (uint8_t)strlen(name);
+    fbx_write_u32(w, 0);    // end offset
+    fbx_write_u32(w, 0);    // property count
+    fbx_write_u32(w, 0);    // property list length
+    fbx_write(w, &name_length, 1);
+    fbx_write(w, name, name_length);
+    node.property_offset = w.data.size();
+    w.open_nodes.push_back(node);
+}
+
+void fbx_end_node(fbx_binary_writer& w) {
+    fbx_binary_node node = w.open_nodes.back();
+    w.open_nodes.pop_back();
+    if (!node.has_children)
+        fbx_patch_u32(w, node.header_offset + 8, w.data.size() - node.property_offset);
+    // nodes with children, or without any properties, end with a null record.
+    if (node.has_children || !node.property_count)
+        w.data.resize(w.data.size() + k_fbx_binary_sentinel_size, 0);
+    fbx_patch_u32(w, node.header_offset + 0, w.data.size());
+    fbx_patch_u32(w, node.header_offset + 4, node.property_count);
+}
+
+void fbx_begin_property(fbx_binary_writer& w, char type) {
+    w.open_nodes.back().property_count++;
+    fbx_write(w, &type, 1);
+}
+
+void fbx_prop_int32(fbx_binary_writer& w, int32_t value)  { fbx_begin_property(w, 'I'); fbx_write(w, &value, sizeof(value)); }
+void fbx_prop_int64(fbx_binary_writer& w, int64_t value)  { fbx_begin_property(w, 'L'); fbx_write(w, &value, sizeof(value)); }
+void fbx_prop_double(fbx_binary_writer& w, double value)  { fbx_begin_property(w, 'D'); fbx_write(w, &value, sizeof(value)); }
+void fbx_prop_bool(fbx_binary_writer& w, bool value)      { uint8_t byte = value ? 1 : 0; fbx_begin_property(w, 'C'); fbx_write(w, &byte, 1); }
+
+// strings are not zero terminated in binary files, and may contain zeroes, eg. to separate the name and class of an object.
+void fbx_prop_string(fbx_binary_writer& w, const char* str, size_t length) {
+    fbx_begin_property(w, 'S');
+    fbx_write_u32(w, (uint32_t)length);
+    fbx_write(w, str, length);
+}
+
+void fbx_prop_string(fbx_binary_writer& w, const char* str) {
+    fbx_prop_string(w, str, strlen(str));
+}
+
+void fbx_prop_raw(fbx_binary_writer& w, const void* data, size_t size) {
+    fbx_begin_property(w, 'R');
+    fbx_write_u32(w, (uint32_t)size);
+    fbx_write(w, data, size);
+}
+
+// arrays are stored uncompressed (encoding 0), so no zlib is needed to read or write them.
+void fbx_prop_array(fbx_binary_writer& w, char type, const void* data, uint32_t count, size_t element_size) {
+    fbx_begin_property(w, type);
+    fbx_write_u32(w, count);
+    fbx_write_u32(w, 0);
+    fbx_write_u32(w, (uint32_t)(count * element_size));
+    fbx_write(w, data, count * element_size);
+}
+
+void fbx_prop_double_array(fbx_binary_writer& w, const std::vector<double>& values) { fbx_prop_array(w, 'd', values.data(), (uint32_t)values.size(), sizeof(double)); }
+void fbx_prop_int32_array(fbx_binary_writer& w, const std::vector<int32_t>& values) { fbx_prop_array(w, 'i', values.data(), (uint32_t)values.size(), sizeof(int32_t)); }
+
+void fbx_node_int32(fbx_binary_writer& w, const char* name, int32_t value) {
+    fbx_begin_node(w, name);
+    fbx_prop_int32(w, value);
+    fbx_end_node(w);
+}
+
+void fbx_node_string(fbx_binary_writer& w, const char* name, const char* value) {
+    fbx_begin_node(w, name);
+    fbx_prop_string(w, value);
+    fbx_end_node(w);
+}
+
+// writes an int property within a Properties70 node
+void fbx_node_p_int32(fbx_binary_writer& w, const char* name, int32_t value) {
+    fbx_begin_node(w, "P");
+    fbx_prop_string(w, name);
+    fbx_prop_string(w, "int");
+    fbx_prop_string(w, "Integer");
+    fbx_prop_string(w, "");
+    fbx_prop_int32(w, value);
+    fbx_end_node(w);
+}
+
+// the name of an object in a binary file is followed by "\x00\x01" and its class.
+std::string fbx_object_name(const char* name, const char* class_name) {
+    return std::string(name) + std::string("\x00\x01", 2) + class_name;
+}
+
+bool write_mesh_to_fbx_binary(const char* output_filename, const ogt_mesh* mesh, const char* mesh_name)
+{
+    const int64_t k_geometry_id = 1000;
+    const int64_t k_model_id    = 2000;
+    const int64_t k_document_id = 3000;
+
+    fbx_binary_writer w;
+    w.data.reserve(1024 + (mesh->vertex_count * 48) + (mesh->index_count * 8));
+    fbx_write(w, "Kaydara FBX Binary  \x00\x1a\x00", 23);
+    fbx_write_u32(w, k_fbx_binary_version);
+
+    fbx_begin_node(w, "FBXHeaderExtension");
+    {
+        fbx_node_int32(w, "FBXHeaderVersion", 1003);
+        fbx_node_int32(w, "FBXVersion", (int32_t)k_fbx_binary_version);
+        fbx_node_int32(w, "EncryptionType", 0);
+        fbx_begin_node(w, "CreationTimeStamp");
+        {
+            fbx_node_int32(w, "Version", 1000);
+            fbx_node_int32(w, "Year", 1970);
+            fbx_node_int32(w, "Month", 1);
+            fbx_node_int32(w, "Day", 1);
+            fbx_node_int32(w, "Hour", 10);
+            fbx_node_int32(w, "Minute", 0);
+            fbx_node_int32(w, "Second", 0);
+            fbx_node_int32(w, "Millisecond", 0);
+        }
+        fbx_end_node(w);
+        fbx_node_string(w, "Creator", "http://github.com/jpaver/opengametools vox2fbx");
+    }
+    fbx_end_node(w);
+    fbx_begin_node(w, "FileId");
+    fbx_prop_raw(w, k_fbx_binary_file_id, sizeof(k_fbx_binary_file_id));
+    fbx_end_node(w);
+    fbx_node_string(w, "CreationTime", k_fbx_binary_creation_time);
+    fbx_node_string(w, "Creator", "http://github.com/jpaver/opengametools vox2fbx");
+
+    // y is up as per the default of fbx. The mesh is only rotated so that this is true when --y-as-up is specified.
+    fbx_begin_node(w, "GlobalSettings");
+    {
+        fbx_node_int32(w, "Version", 1000);
+        fbx_begin_node(w, "Properties70");
+        fbx_node_p_int32(w, "UpAxis", 1);
+        fbx_node_p_int32(w, "UpAxisSign", 1);
+        fbx_node_p_int32(w, "FrontAxis", 2);
+        fbx_node_p_int32(w, "FrontAxisSign", 1);
+        fbx_node_p_int32(w, "CoordAxis", 0);
+        fbx_node_p_int32(w, "CoordAxisSign", 1);
+        fbx_begin_node(w, "P");
+        fbx_prop_string(w, "UnitScaleFactor");
+        fbx_prop_string(w, "double");
+        fbx_prop_string(w, "Number");
+        fbx_prop_string(w, "");
+        fbx_prop_double(w, 1.0);
+        fbx_end_node(w);
+        fbx_end_node(w);
+    }
+    fbx_end_node(w);
+
+    fbx_begin_node(w, "Documents");
+    {
+        fbx_node_int32(w, "Count", 1);
+        fbx_begin_node(w, "Document");
+        fbx_prop_int64(w, k_document_id);
+        fbx_prop_string(w, "");
+        fbx_prop_string(w, "Scene");
+        fbx_begin_node(w, "RootNode");
+        fbx_prop_int64(w, 0);
+        fbx_end_node(w);
+        fbx_end_node(w);
+    }
+    fbx_end_node(w);
+    fbx_begin_node(w, "References");
+    fbx_end_node(w);
+
+    fbx_begin_node(w, "Definitions");
+    {
+        const char* object_types[3] = { "GlobalSettings", "Model", "Geometry" };
+        fbx_node_int32(w, "Version", 100);
+        fbx_node_int32(w, "Count", 3);
+        for (uint32_t i = 0; i < 3; i++) {
+            fbx_begin_node(w, "ObjectType");
+            fbx_prop_string(w, object_types[i]);
+            fbx_node_int32(w, "Count", 1);
+            fbx_end_node(w);
+        }
+    }
+    fbx_end_node(w);
+
+    fbx_begin_node(w, "Objects");
+    {
+        std::string geometry_name = fbx_object_name(mesh_name, "Geometry");
+        fbx_begin_node(w, "Geometry");
+        fbx_prop_int64(w, k_geometry_id);
+        fbx_prop_string(w, geometry_name.c_str(), geometry_name.size());
+        fbx_prop_string(w, "Mesh");
+        {
+            std::vector<double> values(mesh->vertex_count * 3);
+            for (uint32_t i = 0; i < mesh->vertex_count; i++) {
+                values[i * 3 + 0] = mesh->vertices[i].pos.x;
+                values[i * 3 + 1] = mesh->vertices[i].pos.y;
+                values[i * 3 + 2] = mesh->vertices[i].pos.z;
+            }
+            fbx_begin_node(w, "Vertices");
+            fbx_prop_double_array(w, values);
+            fbx_end_node(w);
+
+            // the last index of each polygon is stored as its bitwise not, and triangles are reversed as per the ascii writer.
+            std::vector<int32_t> polygon_vertex_indices(mesh->index_count);
+            for (uint32_t i = 0; i < mesh->index_count; i += 3) {
+                polygon_vertex_indices[i + 0] = (int32_t)mesh->indices[i + 2];
+                polygon_vertex_indices[i + 1] = (int32_t)mesh->indices[i + 1];
+                polygon_vertex_indices[i + 2] = ~(int32_t)mesh->indices[i + 0];
+            }
+            fbx_begin_node(w, "PolygonVertexIndex");
+            fbx_prop_int32_array(w, polygon_vertex_indices);
+            fbx_end_node(w);
+            fbx_node_int32(w, "GeometryVersion", 124);
+
+            for (uint32_t i = 0; i < mesh->vertex_count; i++) {
+                values[i * 3 + 0] = mesh->vertices[i].normal.x;
+                values[i * 3 + 1] = mesh->vertices[i].normal.y;
+                values[i * 3 + 2] = mesh->vertices[i].normal.z;
+            }
+            fbx_begin_node(w, "LayerElementNormal");
+            fbx_prop_int32(w, 0);
+            fbx_node_int32(w, "Version", 101);
+            fbx_node_string(w, "Name", "");
+            fbx_node_string(w, "MappingInformationType", "ByVertice");
+            fbx_node_string(w, "ReferenceInformationType", "Direct");
+            fbx_begin_node(w, "Normals");
+            fbx_prop_double_array(w, values);
+            fbx_end_node(w);
+            fbx_end_node(w);
+
+            // colors are stored once for each distinct palette color that the mesh uses, and each polygon vertex
+            // refers to one of them by index, rather than every polygon vertex storing a color of its own. Vertices
+            // already carry their palette index, so a remap from palette index to color index finds each in O(1).
+            int32_t palette_to_color_index[256];
+            for (uint32_t i = 0; i < 256; i++)
+                palette_to_color_index[i] = -1;
+            std::vector<double>  colors;
+            std::vector<int32_t> vertex_color_index(mesh->vertex_count);
+            for (uint32_t i = 0; i < mesh->vertex_count; i++) {
+                const ogt_mesh_vertex& vertex = mesh->vertices[i];
+                int32_t& color_index = palette_to_color_index[vertex.palette_index & 255];
+                if (color_index < 0) {
+                    color_index = (int32_t)(colors.size() / 4);
+                    colors.push_back(vertex.color.r / 255.0f);
+                    colors.push_back(vertex.color.g / 255.0f);
+                    colors.push_back(vertex.color.b / 255.0f);
+                    colors.push_back(1.0f);
+                }
+                vertex_color_index[i] = color_index;
+            }
+            std::vector<int32_t> color_indices(mesh->index_count);
+            for (uint32_t i = 0; i < mesh->index_count; i++)
+                color_indices[i] = vertex_color_index[polygon_vertex_indices[i] < 0 ? ~polygon_vertex_indices[i] : polygon_vertex_indices[i]];
+            fbx_begin_node(w, "LayerElementColor");
+            fbx_prop_int32(w, 0);
+            fbx_node_int32(w, "Version", 101);
+            fbx_node_string(w, "Name", "colorSet1");
+            fbx_node_string(w, "MappingInformationType", "ByPolygonVertex");
+            fbx_node_string(w, "ReferenceInformationType", "IndexToDirect");
+            fbx_begin_node(w, "Colors");
+            fbx_prop_double_array(w, colors);
+            fbx_end_node(w);
+            fbx_begin_node(w, "ColorIndex");
+            fbx_prop_int32_array(w, color_indices);
+            fbx_end_node(w);
+            fbx_end_node(w);
+
+            fbx_begin_node(w, "Layer");
+            fbx_prop_int32(w, 0);
+            fbx_node_int32(w, "Version", 100);
+            fbx_begin_node(w, "LayerElement");
+            fbx_node_string(w, "Type", "LayerElementNormal");
+            fbx_node_int32(w, "TypedIndex", 0);
+            fbx_end_node(w);
+            fbx_begin_node(w, "LayerElement");
+            fbx_node_string(w, "Type", "LayerElementColor");
+            fbx_node_int32(w, "TypedIndex", 0);
+            fbx_end_node(w);
+            fbx_end_node(w);
+        }
+        fbx_end_node(w);
+
+        std::string model_name = fbx_object_name(mesh_name, "Model");
+        fbx_begin_node(w, "Model");
+        fbx_prop_int64(w, k_model_id);
+        fbx_prop_string(w, model_name.c_str(), model_name.size());
+        fbx_prop_string(w, "Mesh");
+        {
+            fbx_node_int32(w, "Version", 232);
+            fbx_begin_node(w, "Properties70");
+            fbx_end_node(w);
+            fbx_begin_node(w, "Shading");
+            fbx_prop_bool(w, true);
+            fbx_end_node(w);
+            fbx_node_string(w, "Culling", "CullingOff");
+        }
+        fbx_end_node(w);
+    }
+    fbx_end_node(w);
+
+    // the model is parented to the scene root (id 0) and the geometry to the model.
+    fbx_begin_node(w, "Connections");
+    {
+        const int64_t connections[2][2] = { { k_model_id, 0 }, { k_geometry_id, k_model_id } };
+        for (uint32_t i = 0; i < 2; i++) {
+            fbx_begin_node(w, "C");
+            fbx_prop_string(w, "OO");
+            fbx_prop_int64(w, connections[i][0]);
+            fbx_prop_int64(w, connections[i][1]);
+            fbx_end_node(w);
+        }
+    }
+    fbx_end_node(w);
+
+    // the top level list of nodes ends with a null record, followed by the footer.
+    w.data.resize(w.data.size() + k_fbx_binary_sentinel_size, 0);
+    fbx_write(w, k_fbx_binary_footer_id, sizeof(k_fbx_binary_footer_id));
+    fbx_write_u32(w, 0);
+    size_t padding = ((w.data.size() + 15) & ~(size_t)15) - w.data.size();
+    w.data.resize(w.data.size() + (padding ? padding : 16), 0);
+    fbx_write_u32(w, k_fbx_binary_version);
+    w.data.resize(w.data.size() + 120, 0);
+    fbx_write(w, k_fbx_binary_footer_magic, sizeof(k_fbx_binary_footer_magic));
+
+    FILE* fout = open_file(output_filename, "wb");
+    if (!fout) {
+        return false;
+    }
+    bool ok = fwrite(w.data.data(), 1, w.data.size(), fout) == w.data.size();
+    if (fclose(fout) != 0)
+        ok = false;
+    return ok;
+}
+
 int32_t main(int32_t argc, char** argv) {
     // just print help if no args are provided
     if (argc == 1) {
@@ -266,6 +648,7 @@ int32_t main(int32_t argc, char** argv) {
     const char* mesh_algorithm = "polygon";
     bool named_models_only     = false;
     bool y_as_up               = false;
+    bool binary                = false;
 
     // parse arguments and override default parameter values.
     int32_t start_input_index = INT32_MAX;
@@ -282,6 +665,10 @@ int32_t main(int32_t argc, char** argv) {
             y_as_up = true;
             i++;
         }
+        else if (strcmp(argv[i], "--binary") == 0) {
+            binary = true;
+            i++;
+        }
         else if (strncmp(argv[i], "--", 2) == 0) {
             printf("ERROR: unrecognized parameter '%s'", argv[i]);
             return 1;
@@ -409,7 +796,8 @@ int32_t main(int32_t argc, char** argv) {
                 }
             }
 
-            if (!write_mesh_to_fbx(output_filename, mesh, model_name)) {
+            bool written = binary ? write_mesh_to_fbx_binary(output_filename, mesh, model_name) : write_mesh_to_fbx(output_filename, mesh, model_name);
+            if (!written) {
                 printf("ERROR: could not open file '%s' for write - aborting!", output_filename);
                 return 6;
             }
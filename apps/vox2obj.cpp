@@ -32,6 +32,8 @@
 #endif
 #include <stdio.h>
 #include <algorithm>
+#include <atomic>
+#include <thread>
 #include <vector>
 #include <string>
 #include <math.h>
@@ -137,28 +139,141 @@ void write_tga_24bit(const uint8_t* pixels, uint32_t width, uint32_t height, FIL
     }
 }
 
-FILE* open_obj_file(const char* filename)
+// a buffered writer for .obj text. Numbers are formatted by hand straight into a large buffer which is only
+// written to the file when it fills up, as calling fprintf for every vertex and face dominates export time for
+// long animations with many instances.
+struct obj_writer {
+    FILE*  fout;
+    char*  buffer;
+    size_t used;
+    bool   error;
+};
+
+static const size_t k_obj_writer_buffer_size = 4 * 1024 * 1024;
+static const size_t k_obj_writer_max_line    = 256;     // no line we write with the obj_write_* functions is longer than this
+
+void obj_flush(obj_writer& writer) {
+    if (writer.used && fwrite(writer.buffer, 1, writer.used, writer.fout) != writer.used)
+        writer.error = true;
+    writer.used = 0;
+}
+
+// returns where the next line of up to k_obj_writer_max_line bytes can be formatted, flushing the buffer if needed.
+char* obj_line_begin(obj_writer& writer) {
+    if (writer.used + k_obj_writer_max_line > k_obj_writer_buffer_size)
+        obj_flush(writer);
+    return writer.buffer + writer.used;
+}
+
+void obj_line_end(obj_writer& writer, const char* end) {
+    writer.used = (size_t)(end - writer.buffer);
+}
+
+char* format_string(char* out, const char* str) {
+    while (*str)
+        *out++ = *str++;
+    return out;
+}
+
+char* format_uint(char* out, uint64_t value) {
+    char digits[20];
+    uint32_t count = 0;
+    do {
+        digits[count++] = (char)('0' + (value % 10));
+        value /= 10;
+    } while (value);
+    while (count)
+        *out++ = digits[--count];
+    return out;
+}
+
+char* format_int(char* out, int32_t value) {
+    if (value < 0) {
+        *out++ = '-';
+        return format_uint(out, (uint64_t)(-(int64_t)value));
+    }
+    return format_uint(out, (uint64_t)value);
+}
+
+// formats a value exactly as printf("%f") does. A float multiplied by 1e6 is always exactly representable
+// as a double (a 24 bit mantissa times 15625 needs at most 38 bits), so rounding that product to an integer
+// in the default round-half-to-even mode yields the same 6 decimal places as printf. Values too large for
+// the product to fit in 53 bits, infinities and NaNs fall back to snprintf.
+char* format_float(char* out, float value) {
+    double scaled = fabs((double)value * 1000000.0);
+    if (!(scaled < 9007199254740992.0))
+        return out + snprintf(out, 64, "%f", value);
+    uint64_t fixed = (uint64_t)nearbyint(scaled);
+    if (signbit(value))
+        *out++ = '-';
+    out = format_uint(out, fixed / 1000000);
+    *out++ = '.';
+    uint32_t fraction = (uint32_t)(fixed % 1000000);
+    for (uint32_t divisor = 100000; divisor; divisor /= 10)
+        *out++ = (char)('0' + ((fraction / divisor) % 10));
+    return out;
+}
+
+void obj_write_string(obj_writer& writer, const char* str) {
+    size_t length = strlen(str);
+    if (writer.used + length > k_obj_writer_buffer_size)
+        obj_flush(writer);
+    if (length > k_obj_writer_buffer_size) {
+        if (fwrite(str, 1, length, writer.fout) != length)
+            writer.error = true;
+        return;
+    }
+    memcpy(writer.buffer + writer.used, str, length);
+    writer.used += length;
+}
+
+bool open_obj_file(obj_writer& writer, const char* filename)
 {
-    FILE * fout = open_file(filename, "wb");
-    if (!fout) {
+    writer.fout = open_file(filename, "wb");
+    if (!writer.fout) {
         printf("could not open file '%s' for write - aborting!", filename);
-        return nullptr;
+        return false;
     }
     printf("writing file %s\n", filename);
+    writer.buffer = new char[k_obj_writer_buffer_size];
+    writer.used   = 0;
+    writer.error  = false;
+
     // there will only ever be 6 normals, so write them out only once.
-    fprintf(fout, "vn 1 0 0\n");
-    fprintf(fout, "vn -1 0 0\n");
-    fprintf(fout, "vn 0 1 0\n");
-    fprintf(fout, "vn 0 -1 0\n");
-    fprintf(fout, "vn 0 0 1\n");
-    fprintf(fout, "vn 0 0 -1\n");
+    obj_write_string(writer, "vn 1 0 0\n");
+    obj_write_string(writer, "vn -1 0 0\n");
+    obj_write_string(writer, "vn 0 1 0\n");
+    obj_write_string(writer, "vn 0 -1 0\n");
+    obj_write_string(writer, "vn 0 0 1\n");
+    obj_write_string(writer, "vn 0 0 -1\n");
 
     // there will only ever be up to 256 texcoords, so write them out only once
     for (uint32_t i = 0; i < 256; i++) {
         float u = (0.5f + (float)i) * (1.0f / 256.0f);
-        fprintf(fout, "vt %f 0.5\n", u);
+        char* out = obj_line_begin(writer);
+        out = format_string(out, "vt ");
+        out = format_float(out, u);
+        out = format_string(out, " 0.5\n");
+        obj_line_end(writer, out);
     }
-    return fout;
+    return true;
+}
+
+// flushes and closes the file, returning false if any of it could not be written.
+bool close_obj_file(obj_writer& writer)
+{
+    if (!writer.fout)
+        return true;
+    obj_flush(writer);
+    bool ok = !writer.error;
+    if (fclose(writer.fout) != 0)
+        ok = false;
+    delete[] writer.buffer;
+    writer.fout   = nullptr;
+    writer.buffer = nullptr;
+    if (!ok)
+        printf("ERROR: failed to write all of the .obj file\n");
+    return ok;
 }
 
 // converts input value to a string and pds with zeroes to a given length
@@ -174,6 +289,36 @@ std::string zero_padded_string(uint32_t value, uint32_t num_zeroes) {
     return ret;
 }
 
+// runs the jobs of the meshify library across a number of threads, where each thread takes the next job until all are done.
+// user_data points to the uint32_t number of threads to use, including the calling thread.
+void parallel_for_threads(ogt_voxel_meshify_job_func job_func, void* job_data, uint32_t job_count, void* user_data) {
+    uint32_t thread_count = std::min(*(const uint32_t*)user_data, job_count);
+    std::atomic<uint32_t> next_job_index(0);
+    auto run_jobs = [&]() {
+        for (uint32_t job_index = next_job_index++; job_index < job_count; job_index = next_job_index++)
+            job_func(job_index, job_data);
+    };
+    std::vector<std::thread> threads;
+    for (uint32_t i = 1; i < thread_count; i++)
+        threads.emplace_back(run_jobs);
+    run_jobs();
+    for (size_t i = 0; i < threads.size(); i++)
+        threads[i].join();
+}
+
+bool is_instance_visible(const ogt_vox_scene* scene, const ogt_vox_instance* instance) {
+    // skip this instance if it's hidden in the .vox file
+    if (instance->hidden)
+        return false;
+    // skip this instance if it's part of a hidden layer in the .vox file
+    if (scene->layers[instance->layer_index].hidden)
+        return false;
+    // skip this instance if it's part of a hidden group
+    if (instance->group_index != k_invalid_group_index && scene->groups[instance->group_index].hidden)
+        return false;
+    return true;
+}
+
 void get_frame_min_max(const ogt_vox_scene* scene, uint32_t& frame_min, uint32_t& frame_max) {
     // if frame_min/frame_max are all -1, we determine the frame range from the keyframes within the specified file.
     if (frame_min == UINT32_MAX && frame_max == UINT32_MAX) {
@@ -255,19 +400,77 @@ bool export_scene_anim_as_vox(const ogt_vox_scene* scene, const std::string& out
     return ret;
 }
 
-bool export_scene_anim_as_obj(const ogt_vox_scene* scene, const std::string& out_name, bool out_file_per_frame, float voxel_scale, uint32_t frame_min, uint32_t frame_max, const char* mesh_algorithm) {
-    get_frame_min_max(scene, frame_min, frame_max);
+static const ogt_voxel_meshify_context k_default_meshify_context = {};
 
+// meshes every model that is used by a visible instance within the frame range, with each model meshed in its own job
+// on thread_count threads. model_mesh_index maps each model index of the scene to its range within the result, or to
+// UINT32_MAX if it isn't used. The color alpha of each vertex is its palette index, and positions are biased so that
+// the center/pivot of each model is at (0,0,0). Destroy the result with k_default_meshify_context.
+ogt_mesh_models* mesh_used_models(const ogt_vox_scene* scene, uint32_t frame_min, uint32_t frame_max, const char* mesh_algorithm, uint32_t thread_count, std::vector<uint32_t>& model_mesh_index) {
     // put the color index into the alpha component of every color in the palette
     ogt_vox_palette palette = scene->palette;
     for (uint32_t i = 0; i < 256; i++) {
         palette.color[i].a = (uint8_t)i;
     }
 
-    // meshify all models.
-    ogt_voxel_meshify_context meshify_context = {};
-    std::vector<ogt_mesh*> meshes;
-    meshes.resize(scene->num_models, nullptr);
+    // find every model that is used by a visible instance within the frame range, in the order they are first used.
+    std::vector<uint32_t>             mesh_model_index;
+    std::vector<ogt_mesh_voxel_model> voxel_models;
+    model_mesh_index.assign(scene->num_models, UINT32_MAX);
+    for (uint32_t frame_index = frame_min; frame_index <= frame_max; frame_index++) {
+        for (uint32_t instance_index = 0; instance_index < scene->num_instances; instance_index++) {
+            const ogt_vox_instance* instance = &scene->instances[instance_index];
+            if (!is_instance_visible(scene, instance))
+                continue;
+            uint32_t model_index = ogt_vox_sample_instance_model(instance, frame_index);
+            const ogt_vox_model* model = scene->models[model_index];
+            if (!model || model_mesh_index[model_index] != UINT32_MAX)
+                continue;
+            model_mesh_index[model_index] = (uint32_t)voxel_models.size();
+            mesh_model_index.push_back(model_index);
+            ogt_mesh_voxel_model voxel_model = { model->voxel_data, model->size_x, model->size_y, model->size_z };
+            voxel_models.push_back(voxel_model);
+        }
+    }
+
+    // meshify all of those models up front, with each model meshed on its own thread.
+    ogt_voxel_meshify_context meshify_context = k_default_meshify_context;
+    if (thread_count > 1) {
+        meshify_context.parallel_for_func      = parallel_for_threads;
+        meshify_context.parallel_for_user_data = &thread_count;
+    }
+    ogt_mesh_algorithm algorithm = (strcmp(mesh_algorithm, "polygon") == 0) ? ogt_mesh_algorithm_polygon :
+                                   (strcmp(mesh_algorithm, "greedy") == 0)  ? ogt_mesh_algorithm_greedy : 
+                                                                              ogt_mesh_algorithm_simple;
+    for (size_t i = 0; i < voxel_models.size(); i++)
+        printf("  - generating mesh for model of size %u x %u x %u using mesh_algorithm %s\n", voxel_models[i].size_x, voxel_models[i].size_y, voxel_models[i].size_z, mesh_algorithm);
+    ogt_mesh_models* meshes = ogt_mesh_from_paletted_voxel_models(&meshify_context, voxel_models.data(), (uint32_t)voxel_models.size(), (const ogt_mesh_rgba*)&palette.color[0], algorithm, 0);
+    if (!meshes) {
+        printf("ERROR: failed to generate meshes for %u models\n", (uint32_t)voxel_models.size());
+        return nullptr;
+    }
+    for (uint32_t mesh_index = 0; mesh_index < meshes->model_count; mesh_index++) {
+        const ogt_vox_model*        model = scene->models[mesh_model_index[mesh_index]];
+        const ogt_mesh_model_range& range = meshes->model_ranges[mesh_index];
+        for (uint32_t i = range.vertex_offset; i < range.vertex_offset + range.vertex_count; i++) {
+            // pre-bias the mesh vertices by the model dimensions - resets the center/pivot so it is at (0,0,0)
+            ogt_mesh_vec3& pos = meshes->mesh.vertices[i].pos;
+            pos.x -= (float)(model->size_x / 2);
+            pos.y -= (float)(model->size_y / 2);
+            pos.z -= (float)(model->size_z / 2);
+        }
+    }
+    return meshes;
+}
+
+bool export_scene_anim_as_obj(const ogt_vox_scene* scene, const std::string& out_name, bool out_file_per_frame, float voxel_scale, uint32_t frame_min, uint32_t frame_max, const char* mesh_algorithm, uint32_t thread_count) {
+    get_frame_min_max(scene, frame_min, frame_max);
+
+    // put the color index into the alpha component of every color in the palette
+    ogt_vox_palette palette = scene->palette;
+    for (uint32_t i = 0; i < 256; i++) {
+        palette.color[i].a = (uint8_t)i;
+    }
 
     // go through all frames
     std::string out_texture_name = out_name + ".tga";
@@ -311,87 +514,72 @@ bool export_scene_anim_as_obj(const ogt_vox_scene* scene, const std::string& out
         fclose(fout);
     }
 
+    // meshify all models that are used within the frame range up front
+    std::vector<uint32_t> model_mesh_index;
+    ogt_mesh_models* meshes = mesh_used_models(scene, frame_min, frame_max, mesh_algorithm, thread_count, model_mesh_index);
+    if (!meshes)
+        return false;
+    for (uint32_t i = 0; i < meshes->mesh.vertex_count; i++) {
+        // the normal is always a unit vector aligned on one of the 6 cardinal directions, here we just
+        // precompute which index it was (same order as the 'vn' tags we wrote out when opening the file)
+        // and write it as a uint32_t into the x field. This allows us to avoid do this index conversion
+        // for every vert in a mesh, and not for every vert multiplied by the number of instances.
+        ogt_mesh_vec3& normal = meshes->mesh.vertices[i].normal;
+        uint32_t normal_index = normal.x != 0 ? (normal.x > 0.0f ? 0 : 1) :
+                                normal.y != 0 ? (normal.y > 0.0f ? 2 : 3) :
+                                (normal.z > 0.0f ? 4 : 5);
+        *(uint32_t*)&normal.x = normal_index;
+    }
+
     // write geometry data
     bool error = false;
     {
-        FILE* fout = nullptr;
+        obj_writer obj = {};
         uint32_t base_vertex_index = 0;
         for (uint32_t frame_index = frame_min; frame_index <= frame_max; frame_index++) {
             if (out_file_per_frame) {
-                if (fout)
-                    fclose(fout);
+                if (!close_obj_file(obj)) {
+                    error = true;
+                    break;
+                }
                 std::string out_obj_name = out_name + "-" + zero_padded_string(frame_index, 3) + ".obj";
-                fout = open_obj_file(out_obj_name.c_str());
-                if (!fout) {
+                if (!open_obj_file(obj, out_obj_name.c_str())) {
                     printf("could not open file '%s' for write - aborting!", out_obj_name.c_str());
                     error = true;
                     break;
                 }
                 base_vertex_index = 0;
             }
-            else if (!fout) {
+            else if (!obj.fout) {
                 std::string out_obj_name = out_name + ".obj";
-                fout = open_obj_file(out_obj_name.c_str());
-                if (!fout) {
+                if (!open_obj_file(obj, out_obj_name.c_str())) {
                     printf("could not open file '%s' for write - aborting!", out_obj_name.c_str());
                     error = true;
                     break;
                 }
             }
 
-            fprintf(fout, "o frame_%03u\n", frame_index);
-            fprintf(fout, "mtllib %s\n", out_material_name.c_str());
-            fprintf(fout, "usemtl palette\n");
+            obj_write_string(obj, ("o frame_" + zero_padded_string(frame_index, 3) + "\n").c_str());
+            obj_write_string(obj, "mtllib ");
+            obj_write_string(obj, out_material_name.c_str());
+            obj_write_string(obj, "\n");
+            obj_write_string(obj, "usemtl palette\n");
 
             for (uint32_t instance_index = 0; instance_index < scene->num_instances; instance_index++) {
                 const ogt_vox_instance* instance = &scene->instances[instance_index];
-                // skip this instance if it's hidden in the .vox file
-                if (instance->hidden)
-                    continue;
-                // skip this instance if it's part of a hidden layer in the .vox file
-                if (scene->layers[instance->layer_index].hidden)
-                    continue;
-                // skip this instance if it's part of a hidden group
-                if (instance->group_index != k_invalid_group_index && scene->groups[instance->group_index].hidden)
+                if (!is_instance_visible(scene, instance))
                     continue;
 
                 ogt_vox_transform transform   = ogt_vox_sample_instance_transform_global(instance, frame_index, scene);
                 uint32_t          model_index = ogt_vox_sample_instance_model(instance, frame_index);
 
-                // just in time generate the mesh for this model if we haven't already done so.
-                const ogt_vox_model* model = scene->models[model_index];
-                if (model && !meshes[model_index]) {
-                    // generate a mesh for this model using the mesh_algorithm specified
-                    printf("  - generating mesh for model of size %u x %u x %u using mesh_algorithm %s\n", model->size_x, model->size_y, model->size_z, mesh_algorithm);
-                    ogt_mesh* mesh =
-                        (strcmp(mesh_algorithm, "polygon") == 0) ? ogt_mesh_from_paletted_voxels_polygon(&meshify_context, model->voxel_data, model->size_x, model->size_y, model->size_z, (const ogt_mesh_rgba*)&palette.color[0]) :
-                        (strcmp(mesh_algorithm, "greedy") == 0) ? ogt_mesh_from_paletted_voxels_greedy(&meshify_context, model->voxel_data, model->size_x, model->size_y, model->size_z, (const ogt_mesh_rgba*)&palette.color[0]) :
-                        (strcmp(mesh_algorithm, "simple") == 0) ? ogt_mesh_from_paletted_voxels_simple(&meshify_context, model->voxel_data, model->size_x, model->size_y, model->size_z, (const ogt_mesh_rgba*)&palette.color[0]) :
-                        NULL;
-
-                    for (uint32_t i = 0; i < mesh->vertex_count; i++) {
-                        // pre-bias the mesh vertices by the model dimensions - resets the center/pivot so it is at (0,0,0)
-                        mesh->vertices[i].pos.x -= (float)(model->size_x / 2);
-                        mesh->vertices[i].pos.y -= (float)(model->size_y / 2);
-                        mesh->vertices[i].pos.z -= (float)(model->size_z / 2);
-                        // the normal is always a unit vector aligned on one of the 6 cardinal directions, here we just
-                        // precompute which index it was (same order as the 'vn' tags we wrote out when opening the file)
-                        // and write it as a uint32_t into the x field. This allows us to avoid do this index conversion
-                        // for every vert in a mesh, and not for every vert multiplied by the number of instances.
-                        ogt_mesh_vec3& normal = mesh->vertices[i].normal;
-                        uint32_t normal_index = normal.x != 0 ? (normal.x > 0.0f ? 0 : 1) :
-                                                normal.y != 0 ? (normal.y > 0.0f ? 2 : 3) :
-                                                (normal.z > 0.0f ? 4 : 5);
-                        *(uint32_t*)&normal.x = normal_index;
-                    }
-                    // cache this mesh so we don't need to do it multiple times.
-                    meshes[model_index] = mesh;
-                }
-
                 // some instances can have no geometry, so we just skip em
-                const ogt_mesh* mesh = meshes[model_index];
-                if (!mesh)
+                if (model_mesh_index[model_index] == UINT32_MAX)
                     continue;
+                // the indices of the combined mesh include the vertex offset of the model, which we remove to index its vertices.
+                const ogt_mesh_model_range& range    = meshes->model_ranges[model_mesh_index[model_index]];
+                const ogt_mesh_vertex*      vertices = &meshes->mesh.vertices[range.vertex_offset];
+                const uint32_t*             indices  = &meshes->mesh.indices[range.index_offset];
 
                 if (voxel_scale != 1.0f) {
                     // bake voxel scale into the transform to avoid doing the scale per vertex.
@@ -400,42 +588,421 @@ bool export_scene_anim_as_obj(const ogt_vox_scene* scene, const std::string& out
                         transform_data[i] *= voxel_scale;
                     }
                     // scaling vertex positions, so we do floating point writes
-                    for (size_t i = 0; i < mesh->vertex_count; i++) {
-                        ogt_mesh_vec3 pos = transform_point(transform, mesh->vertices[i].pos);
-                        fprintf(fout, "v %f %f %f\n", pos.x, pos.y, pos.z);
+                    for (size_t i = 0; i < range.vertex_count; i++) {
+                        ogt_mesh_vec3 pos = transform_point(transform, vertices[i].pos);
+                        char* out = obj_line_begin(obj);
+                        *out++ = 'v';
+                        *out++ = ' ';
+                        out = format_float(out, pos.x);
+                        *out++ = ' ';
+                        out = format_float(out, pos.y);
+                        *out++ = ' ';
+                        out = format_float(out, pos.z);
+                        *out++ = '\n';
+                        obj_line_end(obj, out);
                     }
                 }
                 else {
                     // we're not scaling positions, can write them much more compactly (smaller .obj file size) as int.
-                    for (size_t i = 0; i < mesh->vertex_count; i++) {
-                        ogt_mesh_vec3 pos = transform_point(transform, mesh->vertices[i].pos);
-                        fprintf(fout, "v %i %i %i\n", (int32_t)pos.x, (int32_t)pos.y, (int32_t)pos.z);
+                    for (size_t i = 0; i < range.vertex_count; i++) {
+                        ogt_mesh_vec3 pos = transform_point(transform, vertices[i].pos);
+                        char* out = obj_line_begin(obj);
+                        *out++ = 'v';
+                        *out++ = ' ';
+                        out = format_int(out, (int32_t)pos.x);
+                        *out++ = ' ';
+                        out = format_int(out, (int32_t)pos.y);
+                        *out++ = ' ';
+                        out = format_int(out, (int32_t)pos.z);
+                        *out++ = '\n';
+                        obj_line_end(obj, out);
                     }
                 }
                 // write faces
-                for (size_t i = 0; i < mesh->index_count; i += 3) {
-                    uint32_t v_i0 = base_vertex_index + mesh->indices[i + 0] + 1;
-                    uint32_t v_i1 = base_vertex_index + mesh->indices[i + 1] + 1;
-                    uint32_t v_i2 = base_vertex_index + mesh->indices[i + 2] + 1;
-                    uint32_t t_i0 = mesh->vertices[mesh->indices[i+0]].color.a + 1;
-                    uint32_t t_i1 = mesh->vertices[mesh->indices[i+1]].color.a + 1;
-                    uint32_t t_i2 = mesh->vertices[mesh->indices[i+2]].color.a + 1;
-                    uint32_t n_i0 = *((uint32_t*)&mesh->vertices[mesh->indices[i+0]].normal.x) + 1;
-                    uint32_t n_i1 = *((uint32_t*)&mesh->vertices[mesh->indices[i+1]].normal.x) + 1;
-                    uint32_t n_i2 = *((uint32_t*)&mesh->vertices[mesh->indices[i+2]].normal.x) + 1;
-                    fprintf(fout, "f %u/%u/%u %u/%u/%u %u/%u/%u\n", v_i0, t_i0, n_i0, v_i1, t_i1, n_i1, v_i2, t_i2, n_i2);
+                for (size_t i = 0; i < range.index_count; i += 3) {
+                    uint32_t i0 = indices[i + 0] - range.vertex_offset;
+                    uint32_t i1 = indices[i + 1] - range.vertex_offset;
+                    uint32_t i2 = indices[i + 2] - range.vertex_offset;
+                    uint32_t v_i0 = base_vertex_index + i0 + 1;
+                    uint32_t v_i1 = base_vertex_index + i1 + 1;
+                    uint32_t v_i2 = base_vertex_index + i2 + 1;
+                    uint32_t t_i0 = vertices[i0].color.a + 1;
+                    uint32_t t_i1 = vertices[i1].color.a + 1;
+                    uint32_t t_i2 = vertices[i2].color.a + 1;
+                    uint32_t n_i0 = *((uint32_t*)&vertices[i0].normal.x) + 1;
+                    uint32_t n_i1 = *((uint32_t*)&vertices[i1].normal.x) + 1;
+                    uint32_t n_i2 = *((uint32_t*)&vertices[i2].normal.x) + 1;
+                    const uint32_t face[9] = { v_i0, t_i0, n_i0, v_i1, t_i1, n_i1, v_i2, t_i2, n_i2 };
+                    char* out = obj_line_begin(obj);
+                    *out++ = 'f';
+                    for (uint32_t j = 0; j < 9; j++) {
+                        *out++ = (j % 3) ? '/' : ' ';
+                        out = format_uint(out, face[j]);
+                    }
+                    *out++ = '\n';
+                    obj_line_end(obj, out);
                 }
-                base_vertex_index += mesh->vertex_count;
+                base_vertex_index += range.vertex_count;
             }
         }
 
-        if (fout) {
-            fclose(fout);
-        }
+        if (!close_obj_file(obj))
+            error = true;
     }
+    ogt_mesh_models_destroy(&k_default_meshify_context, meshes);
     return !error;
 }
 
+// a binary glTF 2.0 (.glb) file being assembled in memory: the JSON document and the binary buffer that it refers to.
+struct glb_builder {
+    std::vector<uint8_t> bin;
+    std::string          buffer_views;
+    std::string          accessors;
+    uint32_t             buffer_view_count;
+    uint32_t             accessor_count;
+};
+
+// glTF component types and buffer view targets
+static const uint32_t k_gltf_unsigned_byte   = 5121;
+static const uint32_t k_gltf_unsigned_short  = 5123;
+static const uint32_t k_gltf_unsigned_int    = 5125;
+static const uint32_t k_gltf_float           = 5126;
+static const uint32_t k_gltf_array_buffer    = 34962;
+static const uint32_t k_gltf_element_buffer  = 34963;
+
+std::string gltf_float(float value) {
+    char str[32];
+    snprintf(str, sizeof(str), "%.9g", value);
+    return str;
+}
+
+std::string gltf_string(const char* str) {
+    std::string ret = "\"";
+    for (; *str; str++) {
+        if (*str == '"' || *str == '\\') {
+            ret += '\\';
+            ret += *str;
+        }
+        else if ((uint8_t)*str < 0x20) {
+            char escaped[8];
+            snprintf(escaped, sizeof(escaped), "\\u%04x", (uint32_t)(uint8_t)*str);
+            ret += escaped;
+        }
+        else {
+            ret += *str;
+        }
+    }
+    return ret + "\"";
+}
+
+// appends data to the binary buffer as a new buffer view aligned to 4 bytes, and returns the index of the view.
+uint32_t glb_add_buffer_view(glb_builder& glb, const void* data, size_t size, uint32_t target) {
+    while (glb.bin.size() & 3)
+        glb.bin.push_back(0);
+    size_t offset = glb.bin.size();
+    glb.bin.insert(glb.bin.end(), (const uint8_t*)data, (const uint8_t*)data + size);
+    glb.buffer_views += std::string(glb.buffer_view_count ? "," : "") + "{\"buffer\":0,\"byteOffset\":" + std::to_string(offset) + ",\"byteLength\":" + std::to_string(size);
+    if (target)
+        glb.buffer_views += ",\"target\":" + std::to_string(target);
+    glb.buffer_views += "}";
+    return glb.buffer_view_count++;
+}
+
+// adds an accessor for count elements of the given type in a buffer view, and returns the index of the accessor.
+// min_max is appended as is, and is required for positions and animation inputs.
+uint32_t glb_add_accessor(glb_builder& glb, uint32_t buffer_view, uint32_t component_type, bool normalized, uint32_t count, const char* type, const std::string& min_max = std::string()) {
+    glb.accessors += std::string(glb.accessor_count ? "," : "") + "{\"bufferView\":" + std::to_string(buffer_view) + ",\"componentType\":" + std::to_string(component_type) +
+        (normalized ? ",\"normalized\":true" : "") + ",\"count\":" + std::to_string(count) + ",\"type\":\"" + type + "\"" + min_max + "}";
+    return glb.accessor_count++;
+}
+
+// the translation, rotation and scale of a node, as glTF animations can't animate a matrix.
+struct gltf_trs {
+    float t[3];
+    float r[4];     // quaternion as x, y, z, w
+    float s[3];
+};
+
+// MagicaVoxel transforms are made of a translation and a rotation that can include a mirror. A mirror is stored as a
+// scale of -1, which leaves a proper rotation that can be expressed as a quaternion.
+gltf_trs gltf_trs_from_transform(const ogt_vox_transform& transform) {
+    // the transform is laid out as a column major matrix with the translation in the last column, the same as glTF.
+    const float* m = &transform.m00;
+    float r[3][3];
+    for (uint32_t row = 0; row < 3; row++)
+        for (uint32_t col = 0; col < 3; col++)
+            r[row][col] = m[(col * 4) + row];
+    float det = r[0][0] * (r[1][1] * r[2][2] - r[1][2] * r[2][1]) - r[0][1] * (r[1][0] * r[2][2] - r[1][2] * r[2][0]) + r[0][2] * (r[1][0] * r[2][1] - r[1][1] * r[2][0]);
+    float scale = det < 0.0f ? -1.0f : 1.0f;
+    for (uint32_t row = 0; row < 3; row++)
+        for (uint32_t col = 0; col < 3; col++)
+            r[row][col] *= scale;
+
+    gltf_trs trs;
+    trs.t[0] = m[12];
+    trs.t[1] = m[13];
+    trs.t[2] = m[14];
+    trs.s[0] = trs.s[1] = trs.s[2] = scale;
+    float trace = r[0][0] + r[1][1] + r[2][2];
+    if (trace > 0.0f) {
+        float k = sqrtf(trace + 1.0f) * 2.0f;
+        trs.r[3] = 0.25f * k;
+        trs.r[0] = (r[2][1] - r[1][2]) / k;
+        trs.r[1] = (r[0][2] - r[2][0]) / k;
+        trs.r[2] = (r[1][0] - r[0][1]) / k;
+    }
+    else if (r[0][0] > r[1][1] && r[0][0] > r[2][2]) {
+        float k = sqrtf(1.0f + r[0][0] - r[1][1] - r[2][2]) * 2.0f;
+        trs.r[3] = (r[2][1] - r[1][2]) / k;
+        trs.r[0] = 0.25f * k;
+        trs.r[1] = (r[0][1] + r[1][0]) / k;
+        trs.r[2] = (r[0][2] + r[2][0]) / k;
+    }
+    else if (r[1][1] > r[2][2]) {
+        float k = sqrtf(1.0f + r[1][1] - r[0][0] - r[2][2]) * 2.0f;
+        trs.r[3] = (r[0][2] - r[2][0]) / k;
+        trs.r[0] = (r[0][1] + r[1][0]) / k;
+        trs.r[1] = 0.25f * k;
+        trs.r[2] = (r[1][2] + r[2][1]) / k;
+    }
+    else {
+        float k = sqrtf(1.0f + r[2][2] - r[0][0] - r[1][1]) * 2.0f;
+        trs.r[3] = (r[1][0] - r[0][1]) / k;
+        trs.r[0] = (r[0][2] + r[2][0]) / k;
+        trs.r[1] = (r[1][2] + r[2][1]) / k;
+        trs.r[2] = 0.25f * k;
+    }
+    return trs;
+}
+
+// converts an 8-bit srgb color channel to a linear 16-bit one, as glTF vertex colors are linear.
+uint16_t srgb_to_linear_u16(uint8_t value) {
+    float c = (float)value / 255.0f;
+    float linear = c <= 0.04045f ? c / 12.92f : powf((c + 0.055f) / 1.055f, 2.4f);
+    return (uint16_t)(linear * 65535.0f + 0.5f);
+}
+
+// adds an animation channel for one path of a node, with a key wherever the sampled value changes. MagicaVoxel animation
+// snaps from frame to frame, so the channel uses step interpolation, which makes those keys exact. Nothing is added if the
+// value never changes, as the node already has the value of the first frame.
+void glb_add_channel(glb_builder& glb, std::string& samplers, std::string& channels, uint32_t& sampler_count, uint32_t node_index, const char* path,
+    const std::vector<float>& frame_values, uint32_t components, float seconds_per_frame)
+{
+    const uint32_t frame_count = (uint32_t)(frame_values.size() / components);
+    std::vector<float> times;
+    std::vector<float> values;
+    for (uint32_t frame = 0; frame < frame_count; frame++) {
+        const float* value = &frame_values[frame * components];
+        if (frame && memcmp(value, value - components, components * sizeof(float)) == 0)
+            continue;
+        times.push_back((float)frame * seconds_per_frame);
+        values.insert(values.end(), value, value + components);
+    }
+    if (times.size() < 2)
+        return;
+    uint32_t input_view  = glb_add_buffer_view(glb, times.data(), times.size() * sizeof(float), 0);
+    uint32_t output_view = glb_add_buffer_view(glb, values.data(), values.size() * sizeof(float), 0);
+    uint32_t input  = glb_add_accessor(glb, input_view, k_gltf_float, false, (uint32_t)times.size(), "SCALAR", ",\"min\":[" + gltf_float(times.front()) + "],\"max\":[" + gltf_float(times.back()) + "]");
+    uint32_t output = glb_add_accessor(glb, output_view, k_gltf_float, false, (uint32_t)times.size(), components == 4 ? "VEC4" : "VEC3");
+    samplers += std::string(sampler_count ? "," : "") + "{\"input\":" + std::to_string(input) + ",\"output\":" + std::to_string(output) + ",\"interpolation\":\"STEP\"}";
+    channels += std::string(sampler_count ? "," : "") + "{\"sampler\":" + std::to_string(sampler_count) + ",\"target\":{\"node\":" + std::to_string(node_index) + ",\"path\":\"" + path + "\"}}";
+    sampler_count++;
+}
+
+// writes the scene to a single binary glTF file. Each used model is stored once as a mesh, each visible instance is a node
+// that refers to it, and the frame range is stored as an animation of node transforms. Instances that switch between models
+// have a child node for each of their models, where only the one used on each frame is visible (ie. has a non-zero scale).
+bool export_scene_anim_as_glb(const ogt_vox_scene* scene, const std::string& out_name, float voxel_scale, uint32_t frame_min, uint32_t frame_max, const char* mesh_algorithm, uint32_t thread_count, float frames_per_second) {
+    get_frame_min_max(scene, frame_min, frame_max);
+
+    std::vector<uint32_t> model_mesh_index;
+    ogt_mesh_models* meshes = mesh_used_models(scene, frame_min, frame_max, mesh_algorithm, thread_count, model_mesh_index);
+    if (!meshes)
+        return false;
+
+    glb_builder glb;
+    glb.buffer_view_count = 0;
+    glb.accessor_count    = 0;
+
+    // write each mesh once. Colors are looked up in the palette by the index that was stored in their alpha.
+    std::string gltf_meshes;
+    uint32_t gltf_mesh_count = 0;
+    std::vector<int32_t> mesh_gltf_index(meshes->model_count, -1);
+    for (uint32_t mesh_index = 0; mesh_index < meshes->model_count; mesh_index++) {
+        const ogt_mesh_model_range& range = meshes->model_ranges[mesh_index];
+        if (!range.index_count)
+            continue;
+        const ogt_mesh_vertex* vertices = &meshes->mesh.vertices[range.vertex_offset];
+        std::vector<float>    positions(range.vertex_count * 3);
+        std::vector<float>    normals(range.vertex_count * 3);
+        std::vector<uint16_t> colors(range.vertex_count * 4);
+        float pos_min[3] = {  1e30f,  1e30f,  1e30f };
+        float pos_max[3] = { -1e30f, -1e30f, -1e30f };
+        for (uint32_t i = 0; i < range.vertex_count; i++) {
+            const float* pos = &vertices[i].pos.x;
+            for (uint32_t c = 0; c < 3; c++) {
+                positions[i * 3 + c] = pos[c];
+                pos_min[c] = std::min(pos_min[c], pos[c]);
+                pos_max[c] = std::max(pos_max[c], pos[c]);
+            }
+            normals[i * 3 + 0] = vertices[i].normal.x;
+            normals[i * 3 + 1] = vertices[i].normal.y;
+            normals[i * 3 + 2] = vertices[i].normal.z;
+            const ogt_vox_rgba& color = scene->palette.color[vertices[i].color.a];
+            colors[i * 4 + 0] = srgb_to_linear_u16(color.r);
+            colors[i * 4 + 1] = srgb_to_linear_u16(color.g);
+            colors[i * 4 + 2] = srgb_to_linear_u16(color.b);
+            colors[i * 4 + 3] = 65535;
+        }
+        // indices are 16-bit wherever the mesh is small enough. glTF reserves the maximum value of the index type for 
+        // primitive restart, so 16-bit indices can only address 65535 vertices.
+        const uint32_t* indices = &meshes->mesh.indices[range.index_offset];
+        uint32_t index_view;
+        uint32_t index_type;
+        if (range.vertex_count < 65536) {
+            std::vector<uint16_t> indices16(range.index_count);
+            for (uint32_t i = 0; i < range.index_count; i++)
+                indices16[i] = (uint16_t)(indices[i] - range.vertex_offset);
+            index_view = glb_add_buffer_view(glb, indices16.data(), indices16.size() * sizeof(uint16_t), k_gltf_element_buffer);
+            index_type = k_gltf_unsigned_short;
+        }
+        else {
+            std::vector<uint32_t> indices32(range.index_count);
+            for (uint32_t i = 0; i < range.index_count; i++)
+                indices32[i] = indices[i] - range.vertex_offset;
+            index_view = glb_add_buffer_view(glb, indices32.data(), indices32.size() * sizeof(uint32_t), k_gltf_element_buffer);
+            index_type = k_gltf_unsigned_int;
+        }
+        std::string min_max = ",\"min\":[" + gltf_float(pos_min[0]) + "," + gltf_float(pos_min[1]) + "," + gltf_float(pos_min[2]) + "]" +
+                              ",\"max\":[" + gltf_float(pos_max[0]) + "," + gltf_float(pos_max[1]) + "," + gltf_float(pos_max[2]) + "]";
+        uint32_t position_accessor = glb_add_accessor(glb, glb_add_buffer_view(glb, positions.data(), positions.size() * sizeof(float), k_gltf_array_buffer), k_gltf_float, false, range.vertex_count, "VEC3", min_max);
+        uint32_t normal_accessor   = glb_add_accessor(glb, glb_add_buffer_view(glb, normals.data(), normals.size() * sizeof(float), k_gltf_array_buffer), k_gltf_float, false, range.vertex_count, "VEC3");
+        uint32_t color_accessor    = glb_add_accessor(glb, glb_add_buffer_view(glb, colors.data(), colors.size() * sizeof(uint16_t), k_gltf_array_buffer), k_gltf_unsigned_short, true, range.vertex_count, "VEC4");
+        uint32_t index_accessor    = glb_add_accessor(glb, index_view, index_type, false, range.index_count, "SCALAR");
+
+        gltf_meshes += std::string(gltf_mesh_count ? "," : "") + "{\"primitives\":[{\"attributes\":{\"POSITION\":" + std::to_string(position_accessor) +
+            ",\"NORMAL\":" + std::to_string(normal_accessor) + ",\"COLOR_0\":" + std::to_string(color_accessor) + "},\"indices\":" + std::to_string(index_accessor) + ",\"material\":0}]}";
+        mesh_gltf_index[mesh_index] = (int32_t)gltf_mesh_count++;
+    }
+
+    // node 0 is the root, which converts from the z-up of MagicaVoxel to the y-up of glTF and applies the voxel scale.
+    const float seconds_per_frame = 1.0f / frames_per_second;
+    const uint32_t frame_count = frame_max - frame_min + 1;
+    std::vector<std::string> nodes(1);
+    std::string root_children;
+    std::string samplers;
+    std::string channels;
+    uint32_t sampler_count = 0;
+    for (uint32_t instance_index = 0; instance_index < scene->num_instances; instance_index++) {
+        const ogt_vox_instance* instance = &scene->instances[instance_index];
+        if (!is_instance_visible(scene, instance))
+            continue;
+
+        // sample the transform and model of the instance on every frame, and find which of the models have geometry.
+        std::vector<float>    translations(frame_count * 3), rotations(frame_count * 4), scales(frame_count * 3);
+        std::vector<int32_t>  frame_meshes(frame_count);
+        std::vector<int32_t>  used_meshes;
+        for (uint32_t frame = 0; frame < frame_count; frame++) {
+            gltf_trs trs = gltf_trs_from_transform(ogt_vox_sample_instance_transform_global(instance, frame_min + frame, scene));
+            memcpy(&translations[frame * 3], trs.t, sizeof(trs.t));
+            memcpy(&rotations[frame * 4], trs.r, sizeof(trs.r));
+            memcpy(&scales[frame * 3], trs.s, sizeof(trs.s));
+            uint32_t model_index = ogt_vox_sample_instance_model(instance, frame_min + frame);
+            frame_meshes[frame] = model_mesh_index[model_index] == UINT32_MAX ? -1 : mesh_gltf_index[model_mesh_index[model_index]];
+            if (frame_meshes[frame] >= 0 && std::find(used_meshes.begin(), used_meshes.end(), frame_meshes[frame]) == used_meshes.end())
+                used_meshes.push_back(frame_meshes[frame]);
+        }
+        if (used_meshes.empty())
+            continue;
+
+        const uint32_t node_index = (uint32_t)nodes.size();
+        std::string name = instance->name ? std::string(instance->name) : "instance_" + std::to_string(instance_index);
+        std::string node = "{\"name\":" + gltf_string(name.c_str()) +
+            ",\"translation\":[" + gltf_float(translations[0]) + "," + gltf_float(translations[1]) + "," + gltf_float(translations[2]) + "]" +
+            ",\"rotation\":[" + gltf_float(rotations[0]) + "," + gltf_float(rotations[1]) + "," + gltf_float(rotations[2]) + "," + gltf_float(rotations[3]) + "]" +
+            ",\"scale\":[" + gltf_float(scales[0]) + "," + gltf_float(scales[1]) + "," + gltf_float(scales[2]) + "]";
+        root_children += std::string(root_children.empty() ? "" : ",") + std::to_string(node_index);
+        glb_add_channel(glb, samplers, channels, sampler_count, node_index, "translation", translations, 3, seconds_per_frame);
+        glb_add_channel(glb, samplers, channels, sampler_count, node_index, "rotation", rotations, 4, seconds_per_frame);
+        glb_add_channel(glb, samplers, channels, sampler_count, node_index, "scale", scales, 3, seconds_per_frame);
+
+        if (used_meshes.size() == 1 && std::find(frame_meshes.begin(), frame_meshes.end(), -1) == frame_meshes.end()) {
+            // the common case is an instance that always shows the same model
+            nodes.push_back(node + ",\"mesh\":" + std::to_string(used_meshes[0]) + "}");
+            continue;
+        }
+        // otherwise, it gets a child node for each model, where the scale of each is animated to hide it on frames it isn't used.
+        std::string children;
+        nodes.push_back(std::string());
+        for (size_t i = 0; i < used_meshes.size(); i++) {
+            const uint32_t child_index = (uint32_t)nodes.size();
+            std::vector<float> visibility(frame_count * 3);
+            for (uint32_t frame = 0; frame < frame_count; frame++)
+                visibility[frame * 3 + 0] = visibility[frame * 3 + 1] = visibility[frame * 3 + 2] = frame_meshes[frame] == used_meshes[i] ? 1.0f : 0.0f;
+            nodes.push_back("{\"name\":" + gltf_string((name + "_mesh_" + std::to_string(i)).c_str()) + ",\"mesh\":" + std::to_string(used_meshes[i]) +
+                ",\"scale\":[" + gltf_float(visibility[0]) + "," + gltf_float(visibility[0]) + "," + gltf_float(visibility[0]) + "]}");
+            glb_add_channel(glb, samplers, channels, sampler_count, child_index, "scale", visibility, 3, seconds_per_frame);
+            children += std::string(children.empty() ? "" : ",") + std::to_string(child_index);
+        }
+        nodes[node_index] = node + ",\"children\":[" + children + "]}";
+    }
+    ogt_mesh_models_destroy(&k_default_meshify_context, meshes);
+
+    const float k_half_sqrt2 = 0.70710678f;
+    nodes[0] = "{\"name\":\"vox_scene\",\"rotation\":[" + gltf_float(-k_half_sqrt2) + ",0,0," + gltf_float(k_half_sqrt2) + "]" +
+        ",\"scale\":[" + gltf_float(voxel_scale) + "," + gltf_float(voxel_scale) + "," + gltf_float(voxel_scale) + "]" +
+        (root_children.empty() ? std::string() : ",\"children\":[" + root_children + "]") + "}";
+
+    // assemble the json document
+    while (glb.bin.size() & 3)
+        glb.bin.push_back(0);
+    std::string json = "{\"asset\":{\"version\":\"2.0\",\"generator\":\"opengametools vox2obj\"},\"scene\":0,\"scenes\":[{\"nodes\":[0]}],\"nodes\":[";
+    for (size_t i = 0; i < nodes.size(); i++)
+        json += (i ? "," : "") + nodes[i];
+    json += "]";
+    if (gltf_mesh_count) {
+        json += ",\"meshes\":[" + gltf_meshes + "]";
+        json += ",\"materials\":[{\"name\":\"palette\",\"pbrMetallicRoughness\":{\"baseColorFactor\":[1,1,1,1],\"metallicFactor\":0,\"roughnessFactor\":1}}]";
+    }
+    if (sampler_count)
+        json += ",\"animations\":[{\"name\":\"frames\",\"samplers\":[" + samplers + "],\"channels\":[" + channels + "]}]";
+    if (glb.accessor_count)
+        json += ",\"accessors\":[" + glb.accessors + "]";
+    if (glb.buffer_view_count)
+        json += ",\"bufferViews\":[" + glb.buffer_views + "]";
+    if (!glb.bin.empty())
+        json += ",\"buffers\":[{\"byteLength\":" + std::to_string(glb.bin.size()) + "}]";
+    json += "}";
+    while (json.size() & 3)
+        json += ' ';
+
+    // write the glb container: a header, then the json chunk and the binary chunk.
+    std::string out_glb_name = out_name + ".glb";
+    FILE* fout = open_file(out_glb_name.c_str(), "wb");
+    if (!fout) {
+        printf("could not open file '%s' for write - aborting!", out_glb_name.c_str());
+        return false;
+    }
+    printf("writing file %s\n", out_glb_name.c_str());
+    const uint32_t json_length = (uint32_t)json.size();
+    const uint32_t bin_length  = (uint32_t)glb.bin.size();
+    const uint32_t header[5] = {
+        0x46546C67,                                                         // magic "glTF"
+        2,                                                                  // version
+        12 + 8 + json_length + (bin_length ? 8 + bin_length : 0),          // total length
+        json_length, 0x4E4F534A                                             // json chunk length and type "JSON"
+    };
+    const uint32_t bin_header[2] = { bin_length, 0x004E4942 };             // binary chunk length and type "BIN"
+    bool ok = fwrite(header, sizeof(header), 1, fout) == 1 && fwrite(json.data(), 1, json_length, fout) == json_length;
+    if (ok && bin_length)
+        ok = fwrite(bin_header, sizeof(bin_header), 1, fout) == 1 && fwrite(glb.bin.data(), 1, bin_length, fout) == bin_length;
+    if (fclose(fout) != 0)
+        ok = false;
+    if (!ok)
+        printf("ERROR: failed to write all of %s\n", out_glb_name.c_str());
+    return ok;
+}
+
 void print_help()
 {
     printf(
@@ -452,7 +1019,11 @@ void print_help()
         " --output_name <name>    : (default: disabled): name of output files\n"
         " --scale <value>         : (default: 1.0): scaling factor to apply to output voxels\n"
         " --frames <first> <last> : which frame range to extract. If not specified, will extract all keyframes within the .vox file.\n"
-        " --output_vox            : (default: disabled): if specified will output .vox files for each frame instead of .obj"
+        " --output_vox            : (default: disabled): if specified will output .vox files for each frame instead of .obj\n"
+        " --output_glb            : (default: disabled): if specified will output a single binary glTF .glb file instead of .obj, where\n"
+        "                           each model is stored once, instances are nodes and the frames are an animation of the nodes\n"
+        " --fps <value>           : (default: 24): frames per second of the animation in the .glb file\n"
+        " --threads <count>       : (default: number of cores): how many threads to mesh models on\n"
         "\n"
         "example:\n"
         "  vox2animobj --mesh_algorithm polygon --output_name test --frames 0 119 --scale scene.vox\n"
@@ -481,9 +1052,12 @@ int main(int argc, char** argv) {
     const char* output_name       = nullptr;
     bool        all_frames_in_one = false;
     bool        output_as_vox     = false;
+    bool        output_as_glb     = false;
+    float       fps               = 24.0f;
     uint32_t    frame_min         = UINT32_MAX; // auto!
     uint32_t    frame_max         = UINT32_MAX; // auto!
     float       scale             = 1.0f;
+    uint32_t    thread_count      = std::max(std::thread::hardware_concurrency(), 1u);
 
     // parse arguments and override default parameter values
     for (int i = 1; i < argc; ) {
@@ -512,6 +1086,18 @@ int main(int argc, char** argv) {
             output_as_vox = true;
             i++;
         }
+        else if (strcmp(argv[i], "--output_glb") == 0) {
+            output_as_glb = true;
+            i++;
+        }
+        else if (strcmp(argv[i], "--fps") == 0) {
+            fps = (float)atof(argv[i+1]);
+            i += 2;
+        }
+        else if (strcmp(argv[i], "--threads") == 0) {
+            thread_count = (uint32_t)std::max(atoi(argv[i+1]), 1);
+            i += 2;
+        }
         else if (strncmp(argv[i], "--", 2) == 0) {
             printf("ERROR: unrecognized parameter '%s'\n", argv[i]);
             return 1;
@@ -562,7 +1148,16 @@ int main(int argc, char** argv) {
             print_help();
             return 2;
         }
-        ret = export_scene_anim_as_obj(scene, output_prefix, output_file_per_frame, scale, frame_min, frame_max, mesh_algorithm);
+        if (output_as_glb) {
+            if (!(fps > 0.0f)) {
+                printf("ERROR: invalid frames per second specified: %f", fps);
+                return 2;
+            }
+            ret = export_scene_anim_as_glb(scene, output_prefix, scale, frame_min, frame_max, mesh_algorithm, thread_count, fps);
+        }
+        else {
+            ret = export_scene_anim_as_obj(scene, output_prefix, output_file_per_frame, scale, frame_min, frame_max, mesh_algorithm, thread_count);
+        }
     }
     ogt_vox_destroy_scene(scene);
 
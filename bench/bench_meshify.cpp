@@ -0,0 +1,419 @@
+/*
+    bench_meshify - MIT license - Justin Paver, October 2026
+
+    A program that times the meshing functions of ogt_voxel_meshify.h over the models of MagicaVoxel .vox
+    files and over synthetic models, and reports throughput, output sizes and peak memory as JSON so that
+    results can be compared across changes to track regressions.
+
+    Please see the MIT license information at the end of this file, and please consider
+    sharing any improvements you make.
+*/
+
+#define OGT_VOX_IMPLEMENTATION
+#include "../src/ogt_vox.h"
+
+#define OGT_VOXEL_MESHIFY_IMPLEMENTATION
+#include "../src/ogt_voxel_meshify.h"
+
+#if defined(_MSC_VER)
+    #include <io.h>
+#endif
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <chrono>
+#include <string>
+#include <vector>
+
+FILE * open_file(const char *filename, const char *mode)
+{
+#if defined(_MSC_VER) && _MSC_VER >= 1400
+    FILE * fp;
+    if (0 != fopen_s(&fp, filename, mode))
+        fp = 0;
+#else
+    FILE * fp = fopen(filename, mode);
+#endif
+    return fp;
+}
+
+// a helper function to load a magica voxel scene given a filename.
+const ogt_vox_scene* load_vox_scene(const char* filename)
+{
+    FILE* fp = open_file(filename, "rb");
+    if (!fp)
+        return NULL;
+    fseek(fp, 0, SEEK_END);
+    uint32_t buffer_size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    std::vector<uint8_t> buffer(buffer_size);
+    size_t read_size = fread(buffer.data(), 1, buffer_size, fp);
+    fclose(fp);
+    return read_size == buffer_size ? ogt_vox_read_scene(buffer.data(), buffer_size) : NULL;
+}
+
+// tracks how much memory the meshify library has allocated through the context, and the peak of that since it was last reset.
+struct memory_tracker {
+    size_t current_bytes;
+    size_t peak_bytes;
+};
+
+// each allocation is prefixed with its size, padded to keep the user memory 16 byte aligned.
+static const size_t k_alloc_header_size = 16;
+
+void* tracked_alloc(size_t size, void* user_data) {
+    memory_tracker* tracker = (memory_tracker*)user_data;
+    uint8_t* mem = (uint8_t*)malloc(size + k_alloc_header_size);
+    if (!mem)
+        return NULL;
+    *(size_t*)mem = size;
+    tracker->current_bytes += size;
+    if (tracker->current_bytes > tracker->peak_bytes)
+        tracker->peak_bytes = tracker->current_bytes;
+    return mem + k_alloc_header_size;
+}
+
+void tracked_free(void* ptr, void* user_data) {
+    if (!ptr)
+        return;
+    memory_tracker* tracker = (memory_tracker*)user_data;
+    uint8_t* mem = (uint8_t*)ptr - k_alloc_header_size;
+    tracker->current_bytes -= *(size_t*)mem;
+    free(mem);
+}
+
+// a model to benchmark, with its own copy of voxels and palette.
+struct bench_model {
+    std::string          name;
+    std::string          source;        // "vox" or "synthetic"
+    uint32_t             size_x, size_y, size_z;
+    std::vector<uint8_t> voxels;
+    ogt_mesh_rgba        palette[256];
+};
+
+// a palette where every color index maps to a distinct, fully opaque color.
+void make_synthetic_palette(ogt_mesh_rgba* palette) {
+    for (uint32_t i = 0; i < 256; i++) {
+        palette[i].r = (uint8_t)(i * 37);
+        palette[i].g = (uint8_t)(i * 91);
+        palette[i].b = (uint8_t)(i * 173);
+        palette[i].a = i ? 255 : 0;
+    }
+}
+
+// a small deterministic hash, so synthetic models are identical on every run and platform.
+uint32_t hash_u32(uint32_t x) {
+    x ^= x >> 16;
+    x *= 0x7feb352d;
+    x ^= x >> 15;
+    x *= 0x846ca68b;
+    x ^= x >> 16;
+    return x;
+}
+
+// the kinds of synthetic models we benchmark.
+enum synthetic_kind {
+    synthetic_noise,            // half of the voxels are solid at random with random colors.
+    synthetic_terrain,          // a rolling height field with grass, dirt and stone bands.
+    synthetic_checkerboard,     // every other voxel is solid, so no faces are ever hidden or merged. The worst case for every algorithm.
+    synthetic_solid,            // every voxel is solid with the same color. The best case for every algorithm.
+    synthetic_kind_count
+};
+
+static const char* k_synthetic_names[synthetic_kind_count] = { "noise", "terrain", "checkerboard", "solid" };
+
+void make_synthetic_model(bench_model& model, synthetic_kind kind, uint32_t size) {
+    model.name   = std::string(k_synthetic_names[kind]) + "_" + std::to_string(size);
+    model.source = "synthetic";
+    model.size_x = model.size_y = model.size_z = size;
+    model.voxels.assign((size_t)size * size * size, 0);
+    make_synthetic_palette(model.palette);
+    for (uint32_t z = 0; z < size; z++) {
+        for (uint32_t y = 0; y < size; y++) {
+            for (uint32_t x = 0; x < size; x++) {
+                size_t index = x + (y * (size_t)size) + (z * (size_t)size * size);
+                uint8_t color_index = 0;
+                switch (kind) {
+                    case synthetic_noise: {
+                        uint32_t h = hash_u32((uint32_t)index * 2654435761u);
+                        color_index = (h & 1) ? (uint8_t)(1 + ((h >> 8) % 255)) : 0;
+                        break;
+                    }
+                    case synthetic_terrain: {
+                        float fx = (float)x / (float)size, fy = (float)y / (float)size;
+                        float height = (float)size * (0.5f + 0.25f * sinf(fx * 6.2831853f * 2.0f) * cosf(fy * 6.2831853f * 1.5f) + 0.1f * sinf((fx + fy) * 6.2831853f * 5.0f));
+                        float depth = height - (float)z;
+                        color_index = (depth <= 0.0f) ? 0 : (depth <= 1.0f) ? 1 : (depth <= 4.0f) ? 2 : 3;
+                        break;
+                    }
+                    case synthetic_checkerboard:
+                        color_index = ((x + y + z) & 1) ? 1 : 0;
+                        break;
+                    case synthetic_solid:
+                        color_index = 1;
+                        break;
+                    default:
+                        break;
+                }
+                model.voxels[index] = color_index;
+            }
+        }
+    }
+}
+
+// adds every model of the .vox file, returning false if it could not be loaded.
+bool add_vox_models(std::vector<bench_model>& models, const char* filename) {
+    const ogt_vox_scene* scene = load_vox_scene(filename);
+    if (!scene)
+        return false;
+    std::string base_name = filename;
+    size_t slash = base_name.find_last_of("/\\");
+    if (slash != std::string::npos)
+        base_name = base_name.substr(slash + 1);
+    for (uint32_t i = 0; i < scene->num_models; i++) {
+        const ogt_vox_model* vox_model = scene->models[i];
+        if (!vox_model)
+            continue;
+        bench_model model;
+        model.name   = base_name + "#" + std::to_string(i);
+        model.source = "vox";
+        model.size_x = vox_model->size_x;
+        model.size_y = vox_model->size_y;
+        model.size_z = vox_model->size_z;
+        model.voxels.assign(vox_model->voxel_data, vox_model->voxel_data + ((size_t)model.size_x * model.size_y * model.size_z));
+        memcpy(model.palette, scene->palette.color, sizeof(model.palette));
+        models.push_back(model);
+    }
+    ogt_vox_destroy_scene(scene);
+    return true;
+}
+
+// the operations that we benchmark on each model.
+enum bench_op {
+    bench_op_simple,
+    bench_op_greedy,
+    bench_op_polygon,
+    bench_op_remove_duplicate_vertices,     // on the simple mesh
+    bench_op_smooth_normals,                // on the simple mesh after removing duplicate vertices
+    bench_op_count
+};
+
+static const char* k_bench_op_names[bench_op_count] = { "simple", "greedy", "polygon", "remove_duplicate_vertices", "smooth_normals" };
+
+// the result of timing one operation on one model.
+struct bench_result {
+    double   seconds;           // the fastest of all iterations
+    uint32_t triangles;
+    uint32_t vertices;
+    size_t   peak_bytes;        // the most memory allocated by the operation at any one time, not counting its input.
+    bool     failed;
+};
+
+ogt_mesh* meshify(const ogt_voxel_meshify_context* ctx, const bench_model& model, bench_op op) {
+    const uint8_t* voxels = model.voxels.data();
+    switch (op) {
+        case bench_op_greedy:  return ogt_mesh_from_paletted_voxels_greedy(ctx, voxels, model.size_x, model.size_y, model.size_z, model.palette);
+        case bench_op_polygon: return ogt_mesh_from_paletted_voxels_polygon(ctx, voxels, model.size_x, model.size_y, model.size_z, model.palette);
+        default:               return ogt_mesh_from_paletted_voxels_simple(ctx, voxels, model.size_x, model.size_y, model.size_z, model.palette);
+    }
+}
+
+bench_result run_op(ogt_voxel_meshify_context* ctx, memory_tracker* tracker, const bench_model& model, bench_op op, uint32_t iterations) {
+    bench_result result;
+    memset(&result, 0, sizeof(result));
+    result.seconds = 1e30;
+    for (uint32_t iteration = 0; iteration < iterations; iteration++) {
+        // the post-processing operations modify a mesh in place, so they get a fresh input mesh that isn't timed.
+        ogt_mesh* mesh = NULL;
+        if (op == bench_op_remove_duplicate_vertices || op == bench_op_smooth_normals) {
+            mesh = meshify(ctx, model, bench_op_simple);
+            if (!mesh) {
+                result.failed = true;
+                return result;
+            }
+            if (op == bench_op_smooth_normals)
+                ogt_mesh_remove_duplicate_vertices(ctx, mesh);
+        }
+        const size_t base_bytes = tracker->current_bytes;
+        tracker->peak_bytes = base_bytes;
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        switch (op) {
+            case bench_op_remove_duplicate_vertices: ogt_mesh_remove_duplicate_vertices(ctx, mesh); break;
+            case bench_op_smooth_normals:            ogt_mesh_smooth_normals(ctx, mesh);            break;
+            default:                                 mesh = meshify(ctx, model, op);                break;
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        if (!mesh) {
+            result.failed = true;
+            return result;
+        }
+        if (seconds < result.seconds)
+            result.seconds = seconds;
+        if (tracker->peak_bytes - base_bytes > result.peak_bytes)
+            result.peak_bytes = tracker->peak_bytes - base_bytes;
+        result.triangles = mesh->index_count / 3;
+        result.vertices  = mesh->vertex_count;
+        ogt_mesh_destroy(ctx, mesh);
+    }
+    return result;
+}
+
+void print_help()
+{
+    printf(
+        "bench_meshify by Justin Paver - source code available here: http://github.com/jpaver/opengametools \n"
+        "\n"
+        "This tool times the meshing functions of ogt_voxel_meshify.h over the models of .vox files and over synthetic\n"
+        "models, and writes the results as JSON.\n"
+        "\n"
+        " usage: bench_meshify [optional args] [input_file.vox ...]\n"
+        "\n"
+        " [optional args] can be one or multiple of:\n"
+        " --quick               : (default: disabled) one iteration with synthetic models of size 32 only, eg. for smoke testing\n"
+        " --iterations <count>  : (default: 5) number of times each operation is timed. The fastest time is reported.\n"
+        " --max_size <size>     : (default: 256) the largest synthetic model size. Sizes double from 32 up to this.\n"
+        " --max_faces <count>   : (default: 4000000) models with more simple faces than this are skipped to bound memory use.\n"
+        " --output <file.json>  : (default: stdout) where to write the JSON results\n"
+        "\n"
+        "example:\n"
+        "  bench_meshify --iterations 10 --output results.json demo/vox/*.vox\n"
+    );
+}
+
+int main(int argc, char** argv) {
+    bool        quick       = false;
+    uint32_t    iterations  = 5;
+    uint32_t    max_size    = 256;
+    uint32_t    max_faces   = 4000000;
+    const char* output_name = NULL;
+    std::vector<const char*> input_files;
+
+    for (int i = 1; i < argc; i++) {
+        bool has_value = (i + 1) < argc;
+        if (strcmp(argv[i], "--quick") == 0) {
+            quick = true;
+        }
+        else if (strcmp(argv[i], "--iterations") == 0 && has_value) {
+            iterations = (uint32_t)atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--max_size") == 0 && has_value) {
+            max_size = (uint32_t)atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--max_faces") == 0 && has_value) {
+            max_faces = (uint32_t)atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--output") == 0 && has_value) {
+            output_name = argv[++i];
+        }
+        else if (strcmp(argv[i], "--help") == 0) {
+            print_help();
+            return 0;
+        }
+        else if (argv[i][0] == '-') {
+            printf("ERROR: unknown or incomplete argument: %s\n\n", argv[i]);
+            print_help();
+            return 1;
+        }
+        else {
+            input_files.push_back(argv[i]);
+        }
+    }
+    if (quick) {
+        iterations = 1;
+        max_size   = 32;
+    }
+    if (iterations < 1)
+        iterations = 1;
+
+    std::vector<bench_model> models;
+    for (size_t i = 0; i < input_files.size(); i++) {
+        if (!add_vox_models(models, input_files[i])) {
+            fprintf(stderr, "ERROR: could not load %s\n", input_files[i]);
+            return 2;
+        }
+    }
+    for (uint32_t size = 32; size <= max_size; size *= 2) {
+        for (uint32_t kind = 0; kind < synthetic_kind_count; kind++) {
+            models.push_back(bench_model());
+            make_synthetic_model(models.back(), (synthetic_kind)kind, size);
+        }
+    }
+
+    FILE* fout = output_name ? open_file(output_name, "wb") : stdout;
+    if (!fout) {
+        fprintf(stderr, "ERROR: could not open %s for writing\n", output_name);
+        return 3;
+    }
+
+    memory_tracker tracker;
+    memset(&tracker, 0, sizeof(tracker));
+    ogt_voxel_meshify_context ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.alloc_func           = tracked_alloc;
+    ctx.free_func            = tracked_free;
+    ctx.alloc_free_user_data = &tracker;
+
+    fprintf(fout, "{\n  \"benchmark\": \"bench_meshify\",\n  \"quick\": %s,\n  \"iterations\": %u,\n  \"results\": [", quick ? "true" : "false", iterations);
+    uint32_t failure_count = 0;
+    bool is_first_result = true;
+    for (size_t m = 0; m < models.size(); m++) {
+        const bench_model& model = models[m];
+        const uint64_t voxel_count = (uint64_t)model.size_x * model.size_y * model.size_z;
+        uint32_t solid_count = 0;
+        for (size_t i = 0; i < model.voxels.size(); i++)
+            solid_count += model.voxels[i] ? 1 : 0;
+        uint32_t face_count = ogt_face_count_from_paletted_voxels_simple(model.voxels.data(), model.size_x, model.size_y, model.size_z);
+        fprintf(stderr, "  - %s (%u x %u x %u)\n", model.name.c_str(), model.size_x, model.size_y, model.size_z);
+
+        for (uint32_t op = 0; op < bench_op_count; op++) {
+            fprintf(fout, "%s\n    { \"model\": \"%s\", \"source\": \"%s\", \"size\": [%u, %u, %u], \"voxels\": %llu, \"solid_voxels\": %u, \"op\": \"%s\", ",
+                is_first_result ? "" : ",", model.name.c_str(), model.source.c_str(), model.size_x, model.size_y, model.size_z,
+                (unsigned long long)voxel_count, solid_count, k_bench_op_names[op]);
+            is_first_result = false;
+            if (face_count > max_faces) {
+                fprintf(fout, "\"skipped\": \"more than %u faces\" }", max_faces);
+                continue;
+            }
+            bench_result result = run_op(&ctx, &tracker, model, (bench_op)op, iterations);
+            if (result.failed) {
+                fprintf(fout, "\"failed\": true }");
+                failure_count++;
+                continue;
+            }
+            // guard against timer resolution for tiny models.
+            double seconds = result.seconds > 1e-9 ? result.seconds : 1e-9;
+            fprintf(fout, "\"seconds\": %.9f, \"voxels_per_second\": %.1f, \"triangles_per_second\": %.1f, \"triangles\": %u, \"vertices\": %u, \"peak_bytes\": %llu }",
+                result.seconds, (double)voxel_count / seconds, (double)result.triangles / seconds, result.triangles, result.vertices, (unsigned long long)result.peak_bytes);
+        }
+    }
+    fprintf(fout, "\n  ],\n  \"failures\": %u\n}\n", failure_count);
+    if (fout != stdout)
+        fclose(fout);
+
+    if (tracker.current_bytes) {
+        fprintf(stderr, "ERROR: %llu bytes were not freed\n", (unsigned long long)tracker.current_bytes);
+        return 4;
+    }
+    return failure_count ? 4 : 0;
+}
+
+/* -------------------------------------------------------------------------------------------------------------------------------------------------
+
+    MIT License
+
+    Copyright (c) 2026 Justin Paver
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+    IN THE SOFTWARE.
+
+------------------------------------------------------------------------------------------------------------------------------------------------- */
@@ -0,0 +1,378 @@
+/*
+    bench_vox - MIT license - Justin Paver, October 2026
+
+    A program that times the reader, writer, merger and transform samplers of ogt_vox.h over MagicaVoxel
+    .vox files and over the synthetic stress scenes from vox_stress_scenes.h, and reports throughput in
+    MB/s and objects/s as JSON so that results can be compared across changes to track regressions.
+
+    Please see the MIT license information at the end of this file, and please consider
+    sharing any improvements you make.
+*/
+
+#define OGT_VOX_IMPLEMENTATION
+#include "../src/ogt_vox.h"
+
+#include "vox_stress_scenes.h"
+
+#if defined(_MSC_VER)
+    #include <io.h>
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+
+FILE * open_file(const char *filename, const char *mode)
+{
+#if defined(_MSC_VER) && _MSC_VER >= 1400
+    FILE * fp;
+    if (0 != fopen_s(&fp, filename, mode))
+        fp = 0;
+#else
+    FILE * fp = fopen(filename, mode);
+#endif
+    return fp;
+}
+
+// a .vox file to benchmark, held in memory so that file io is never timed.
+struct bench_input {
+    std::string          name;
+    std::string          source;        // "vox" or "synthetic"
+    std::vector<uint8_t> buffer;
+};
+
+bool load_file(bench_input& input, const char* filename) {
+    FILE* fp = open_file(filename, "rb");
+    if (!fp)
+        return false;
+    fseek(fp, 0, SEEK_END);
+    uint32_t buffer_size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    input.buffer.resize(buffer_size);
+    size_t read_size = fread(input.buffer.data(), 1, buffer_size, fp);
+    fclose(fp);
+    input.name = filename;
+    size_t slash = input.name.find_last_of("/\\");
+    if (slash != std::string::npos)
+        input.name = input.name.substr(slash + 1);
+    input.source = "vox";
+    return read_size == buffer_size;
+}
+
+// the number of objects in a scene that a reader, writer or merger has to process: models, instances, groups, layers and keyframes.
+uint64_t count_scene_objects(const ogt_vox_scene* scene) {
+    uint64_t count = (uint64_t)scene->num_models + scene->num_instances + scene->num_groups + scene->num_layers;
+    for (uint32_t i = 0; i < scene->num_instances; i++)
+        count += scene->instances[i].transform_anim.num_keyframes + scene->instances[i].model_anim.num_keyframes;
+    for (uint32_t i = 0; i < scene->num_groups; i++)
+        count += scene->groups[i].transform_anim.num_keyframes;
+    return count;
+}
+
+// the last frame that any keyframe in the scene refers to.
+uint32_t last_keyframe_index(const ogt_vox_scene* scene) {
+    uint32_t last = 0;
+    for (uint32_t i = 0; i < scene->num_instances; i++) {
+        const ogt_vox_instance* instance = &scene->instances[i];
+        if (instance->transform_anim.num_keyframes && instance->transform_anim.keyframes[instance->transform_anim.num_keyframes - 1].frame_index > last)
+            last = instance->transform_anim.keyframes[instance->transform_anim.num_keyframes - 1].frame_index;
+        if (instance->model_anim.num_keyframes && instance->model_anim.keyframes[instance->model_anim.num_keyframes - 1].frame_index > last)
+            last = instance->model_anim.keyframes[instance->model_anim.num_keyframes - 1].frame_index;
+    }
+    for (uint32_t i = 0; i < scene->num_groups; i++) {
+        const ogt_vox_group* group = &scene->groups[i];
+        if (group->transform_anim.num_keyframes && group->transform_anim.keyframes[group->transform_anim.num_keyframes - 1].frame_index > last)
+            last = group->transform_anim.keyframes[group->transform_anim.num_keyframes - 1].frame_index;
+    }
+    return last;
+}
+
+// the operations that we benchmark on each input.
+enum bench_op {
+    bench_op_read,          // ogt_vox_read_scene_with_flags, once for every combination of read flags
+    bench_op_write,         // ogt_vox_write_scene on the scene read with all flags
+    bench_op_merge,         // ogt_vox_merge_scenes on two copies of the scene read with groups and keyframes
+    bench_op_sample,        // every ogt_vox_sample_* function for every instance and group on every frame
+    bench_op_count
+};
+
+static const char* k_bench_op_names[bench_op_count] = { "read", "write", "merge", "sample" };
+
+static const uint32_t k_read_flags_count = 16;      // every combination of the 4 k_read_scene_flags_* bits
+static const uint32_t k_all_read_flags   = k_read_scene_flags_groups | k_read_scene_flags_keyframes | k_read_scene_flags_keep_empty_models_instances | k_read_scene_flags_keep_duplicate_models;
+
+std::string read_flags_name(uint32_t read_flags) {
+    static const char* k_flag_names[4] = { "groups", "keyframes", "keep_empty_models_instances", "keep_duplicate_models" };
+    std::string name;
+    for (uint32_t i = 0; i < 4; i++) {
+        if (read_flags & (1u << i))
+            name += (name.empty() ? "" : "|") + std::string(k_flag_names[i]);
+    }
+    return name.empty() ? "none" : name;
+}
+
+// the result of timing one operation on one input.
+struct bench_result {
+    double   seconds;           // the fastest of all iterations
+    uint64_t bytes;             // bytes read, written or merged by one iteration, or 0 if throughput in bytes doesn't apply
+    uint64_t objects;           // objects processed by one iteration
+    bool     failed;
+};
+
+// keeps the sampled values alive so the compiler can't drop the sampling loops.
+static volatile float g_sample_sink = 0.0f;
+
+bench_result run_op(const bench_input& input, bench_op op, uint32_t read_flags, uint32_t iterations, uint32_t max_sample_frames) {
+    bench_result result;
+    memset(&result, 0, sizeof(result));
+    result.seconds = 1e30;
+
+    const uint8_t* buffer      = input.buffer.data();
+    const uint32_t buffer_size = (uint32_t)input.buffer.size();
+
+    // everything except reading operates on a scene that is loaded up front and isn't timed.
+    const ogt_vox_scene* scene = NULL;
+    if (op != bench_op_read) {
+        scene = ogt_vox_read_scene_with_flags(buffer, buffer_size, op == bench_op_write ? k_all_read_flags : (k_read_scene_flags_groups | k_read_scene_flags_keyframes));
+        if (!scene) {
+            result.failed = true;
+            return result;
+        }
+    }
+    const uint32_t frame_count = scene ? (last_keyframe_index(scene) + 1 < max_sample_frames ? last_keyframe_index(scene) + 1 : max_sample_frames) : 0;
+
+    for (uint32_t iteration = 0; iteration < iterations; iteration++) {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        switch (op) {
+            case bench_op_read: {
+                const ogt_vox_scene* read_scene = ogt_vox_read_scene_with_flags(buffer, buffer_size, read_flags);
+                double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                if (!read_scene) {
+                    result.failed = true;
+                    return result;
+                }
+                result.seconds = seconds < result.seconds ? seconds : result.seconds;
+                result.bytes   = buffer_size;
+                result.objects = count_scene_objects(read_scene);
+                ogt_vox_destroy_scene(read_scene);
+                break;
+            }
+            case bench_op_write: {
+                uint32_t written_size = 0;
+                uint8_t* written = ogt_vox_write_scene(scene, &written_size);
+                double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                if (!written) {
+                    result.failed = true;
+                    break;
+                }
+                result.seconds = seconds < result.seconds ? seconds : result.seconds;
+                result.bytes   = written_size;
+                result.objects = count_scene_objects(scene);
+                ogt_vox_free(written);
+                break;
+            }
+            case bench_op_merge: {
+                const ogt_vox_scene* scenes[2] = { scene, scene };
+                ogt_vox_scene* merged = ogt_vox_merge_scenes(scenes, 2, NULL, 0);
+                double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                if (!merged) {
+                    result.failed = true;
+                    break;
+                }
+                result.seconds = seconds < result.seconds ? seconds : result.seconds;
+                result.bytes   = 2 * (uint64_t)buffer_size;
+                result.objects = count_scene_objects(merged);
+                ogt_vox_destroy_scene(merged);
+                break;
+            }
+            case bench_op_sample: {
+                float sink = 0.0f;
+                for (uint32_t frame = 0; frame < frame_count; frame++) {
+                    for (uint32_t i = 0; i < scene->num_instances; i++) {
+                        const ogt_vox_instance* instance = &scene->instances[i];
+                        sink += (float)ogt_vox_sample_instance_model(instance, frame);
+                        sink += ogt_vox_sample_instance_transform_local(instance, frame).m30;
+                        sink += ogt_vox_sample_instance_transform_global(instance, frame, scene).m31;
+                    }
+                    for (uint32_t i = 0; i < scene->num_groups; i++) {
+                        const ogt_vox_group* group = &scene->groups[i];
+                        sink += ogt_vox_sample_group_transform_local(group, frame).m30;
+                        sink += ogt_vox_sample_group_transform_global(group, frame, scene).m31;
+                    }
+                }
+                double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                g_sample_sink = g_sample_sink + sink;
+                result.seconds = seconds < result.seconds ? seconds : result.seconds;
+                result.objects = (uint64_t)frame_count * (3 * (uint64_t)scene->num_instances + 2 * (uint64_t)scene->num_groups);
+                break;
+            }
+            default:
+                break;
+        }
+        if (result.failed)
+            break;
+    }
+    if (scene)
+        ogt_vox_destroy_scene(scene);
+    return result;
+}
+
+void print_help()
+{
+    printf(
+        "bench_vox by Justin Paver - source code available here: http://github.com/jpaver/opengametools \n"
+        "\n"
+        "This tool times the reader, writer, merger and transform samplers of ogt_vox.h over .vox files and over\n"
+        "synthetic stress scenes, and writes the results as JSON.\n"
+        "\n"
+        " usage: bench_vox [optional args] [input_file.vox ...]\n"
+        "\n"
+        " [optional args] can be one or multiple of:\n"
+        " --quick               : (default: disabled) one iteration with stress scenes at 1/16 scale, eg. for smoke testing\n"
+        " --iterations <count>  : (default: 5) number of times each operation is timed. The fastest time is reported.\n"
+        " --scale <divisor>     : (default: 1) divides the size of the stress scenes. See voxstress --help.\n"
+        " --frames <count>      : (default: 1024) the most animation frames to sample for each input\n"
+        " --no_synthetic        : (default: disabled) only benchmark the input files\n"
+        " --output <file.json>  : (default: stdout) where to write the JSON results\n"
+        "\n"
+        "example:\n"
+        "  bench_vox --iterations 10 --output results.json demo/vox/*.vox\n"
+    );
+}
+
+int main(int argc, char** argv) {
+    bool        quick         = false;
+    bool        synthetic     = true;
+    uint32_t    iterations    = 5;
+    uint32_t    scale         = 1;
+    uint32_t    sample_frames = 1024;
+    const char* output_name   = NULL;
+    std::vector<const char*> input_files;
+
+    for (int i = 1; i < argc; i++) {
+        bool has_value = (i + 1) < argc;
+        if (strcmp(argv[i], "--quick") == 0) {
+            quick = true;
+        }
+        else if (strcmp(argv[i], "--iterations") == 0 && has_value) {
+            iterations = (uint32_t)atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--scale") == 0 && has_value) {
+            scale = (uint32_t)atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--frames") == 0 && has_value) {
+            sample_frames = (uint32_t)atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--no_synthetic") == 0) {
+            synthetic = false;
+        }
+        else if (strcmp(argv[i], "--output") == 0 && has_value) {
+            output_name = argv[++i];
+        }
+        else if (strcmp(argv[i], "--help") == 0) {
+            print_help();
+            return 0;
+        }
+        else if (argv[i][0] == '-') {
+            printf("ERROR: unknown or incomplete argument: %s\n\n", argv[i]);
+            print_help();
+            return 1;
+        }
+        else {
+            input_files.push_back(argv[i]);
+        }
+    }
+    if (quick) {
+        iterations = 1;
+        scale      = 16;
+    }
+    if (iterations < 1)
+        iterations = 1;
+    if (scale < 1 || scale > 64) {
+        printf("ERROR: --scale must be between 1 and 64\n");
+        return 1;
+    }
+
+    std::vector<bench_input> inputs;
+    for (size_t i = 0; i < input_files.size(); i++) {
+        inputs.push_back(bench_input());
+        if (!load_file(inputs.back(), input_files[i])) {
+            fprintf(stderr, "ERROR: could not load %s\n", input_files[i]);
+            return 2;
+        }
+    }
+    for (uint32_t c = 0; synthetic && c < stress_case_count; c++) {
+        uint32_t buffer_size = 0;
+        uint8_t* buffer = write_stress_scene((stress_case)c, scale, &buffer_size);
+        if (!buffer) {
+            fprintf(stderr, "ERROR: could not generate stress case %s\n", k_stress_case_names[c]);
+            return 2;
+        }
+        inputs.push_back(bench_input());
+        inputs.back().name   = k_stress_case_names[c];
+        inputs.back().source = "synthetic";
+        inputs.back().buffer.assign(buffer, buffer + buffer_size);
+        ogt_vox_free(buffer);
+    }
+
+    FILE* fout = output_name ? open_file(output_name, "wb") : stdout;
+    if (!fout) {
+        fprintf(stderr, "ERROR: could not open %s for writing\n", output_name);
+        return 3;
+    }
+
+    fprintf(fout, "{\n  \"benchmark\": \"bench_vox\",\n  \"quick\": %s,\n  \"iterations\": %u,\n  \"scale\": %u,\n  \"results\": [", quick ? "true" : "false", iterations, scale);
+    uint32_t failure_count = 0;
+    bool is_first_result = true;
+    for (size_t n = 0; n < inputs.size(); n++) {
+        const bench_input& input = inputs[n];
+        fprintf(stderr, "  - %s (%llu bytes)\n", input.name.c_str(), (unsigned long long)input.buffer.size());
+
+        for (uint32_t op = 0; op < bench_op_count; op++) {
+            // only reading is timed under each combination of flags.
+            const uint32_t flags_count = op == bench_op_read ? k_read_flags_count : 1;
+            for (uint32_t read_flags = 0; read_flags < flags_count; read_flags++) {
+                fprintf(fout, "%s\n    { \"input\": \"%s\", \"source\": \"%s\", \"file_bytes\": %llu, \"op\": \"%s\", ",
+                    is_first_result ? "" : ",", input.name.c_str(), input.source.c_str(), (unsigned long long)input.buffer.size(), k_bench_op_names[op]);
+                if (op == bench_op_read)
+                    fprintf(fout, "\"read_flags\": %u, \"read_flags_names\": \"%s\", ", read_flags, read_flags_name(read_flags).c_str());
+                is_first_result = false;
+
+                bench_result result = run_op(input, (bench_op)op, read_flags, iterations, sample_frames);
+                if (result.failed) {
+                    fprintf(fout, "\"failed\": true }");
+                    failure_count++;
+                    continue;
+                }
+                // guard against timer resolution for tiny inputs.
+                double seconds = result.seconds > 1e-9 ? result.seconds : 1e-9;
+                fprintf(fout, "\"seconds\": %.9f, ", result.seconds);
+                if (result.bytes)
+                    fprintf(fout, "\"bytes\": %llu, \"mb_per_second\": %.3f, ", (unsigned long long)result.bytes, (double)result.bytes / (seconds * 1000000.0));
+                fprintf(fout, "\"objects\": %llu, \"objects_per_second\": %.1f }", (unsigned long long)result.objects, (double)result.objects / seconds);
+            }
+        }
+    }
+    fprintf(fout, "\n  ],\n  \"failures\": %u\n}\n", failure_count);
+    if (fout != stdout)
+        fclose(fout);
+    return failure_count ? 4 : 0;
+}
+
+/* -------------------------------------------------------------------------------------------------------------------------------------------------
+
+    MIT License
+
+    Copyright (c) 2026 Justin Paver
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+    IN THE SOFTWARE.
+
+------------------------------------------------------------------------------------------------------------------------------------------------- */
@@ -0,0 +1,292 @@
+/*
+    vox_stress_scenes.h - MIT license - Justin Paver, October 2026
+
+    Builds synthetic MagicaVoxel scenes that stress particular parts of ogt_vox.h, and serializes them
+    with ogt_vox_write_scene. Shared by the voxstress generator and the bench_vox benchmark so that both
+    produce byte-identical files for the same case and scale.
+
+    Each case scales with a single parameter so that a quick variant can be used for smoke testing:
+    - many_models   : thousands of small distinct models with one instance each, some of which are empty.
+    - duplicates    : thousands of models that are copies of a few unique models, to stress de-duplication.
+    - deep_groups   : a single chain of nested groups with an instance at every level.
+    - keyframes     : many instances and groups with long transform and model keyframe tracks.
+    - dense_256     : a single model whose voxels are all solid.
+    - sparse_256    : a single model where roughly 1 in 64 voxels is solid.
+
+    Include ogt_vox.h before this file. Please see the MIT license information at the end of this file.
+*/
+#ifndef VOX_STRESS_SCENES_H__
+#define VOX_STRESS_SCENES_H__
+
+#include <math.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+enum stress_case {
+    stress_case_many_models,
+    stress_case_duplicates,
+    stress_case_deep_groups,
+    stress_case_keyframes,
+    stress_case_dense_256,
+    stress_case_sparse_256,
+    stress_case_count
+};
+
+static const char* k_stress_case_names[stress_case_count] = { "many_models", "duplicates", "deep_groups", "keyframes", "dense_256", "sparse_256" };
+
+// a small deterministic hash, so generated scenes are identical on every run and platform.
+inline uint32_t stress_hash_u32(uint32_t x) {
+    x ^= x >> 16;
+    x *= 0x7feb352d;
+    x ^= x >> 15;
+    x *= 0x846ca68b;
+    x ^= x >> 16;
+    return x;
+}
+
+// owns all of the memory that an ogt_vox_scene built in-memory points to.
+struct stress_scene {
+    std::vector<std::vector<uint8_t> >                    voxels;
+    std::vector<ogt_vox_model>                            models;
+    std::vector<const ogt_vox_model*>                     model_ptrs;
+    std::vector<ogt_vox_instance>                         instances;
+    std::vector<ogt_vox_group>                            groups;
+    std::vector<ogt_vox_layer>                            layers;
+    std::vector<std::string>                              names;
+    std::vector<std::vector<ogt_vox_keyframe_transform> > transform_keyframes;
+    std::vector<std::vector<ogt_vox_keyframe_model> >     model_keyframes;
+    ogt_vox_scene                                         scene;
+};
+
+inline ogt_vox_transform stress_translation(float x, float y, float z) {
+    ogt_vox_transform transform;
+    memset(&transform, 0, sizeof(transform));
+    transform.m00 = transform.m11 = transform.m22 = transform.m33 = 1.0f;
+    transform.m30 = x;
+    transform.m31 = y;
+    transform.m32 = z;
+    return transform;
+}
+
+// adds a model of the given size and returns a pointer to its voxels, which are all empty.
+inline uint8_t* stress_add_model(stress_scene& s, uint32_t size_x, uint32_t size_y, uint32_t size_z) {
+    s.voxels.push_back(std::vector<uint8_t>((size_t)size_x * size_y * size_z, 0));
+    ogt_vox_model model;
+    memset(&model, 0, sizeof(model));
+    model.size_x = size_x;
+    model.size_y = size_y;
+    model.size_z = size_z;
+    s.models.push_back(model);
+    return s.voxels.back().data();
+}
+
+// fills a model with a deterministic pattern where roughly 1 in (1 << sparsity_shift) voxels is solid.
+inline void stress_fill_model(uint8_t* voxels, size_t voxel_count, uint32_t seed, uint32_t sparsity_shift) {
+    const uint32_t sparsity_mask = (1u << sparsity_shift) - 1;
+    for (size_t i = 0; i < voxel_count; i++) {
+        uint32_t h = stress_hash_u32((uint32_t)i * 2654435761u + seed);
+        voxels[i] = ((h >> 24) & sparsity_mask) == 0 ? (uint8_t)(1 + (h % 255)) : 0;
+    }
+}
+
+inline ogt_vox_instance stress_make_instance(uint32_t model_index, uint32_t group_index, uint32_t layer_index, const ogt_vox_transform& transform) {
+    ogt_vox_instance instance;
+    memset(&instance, 0, sizeof(instance));
+    instance.transform   = transform;
+    instance.model_index = model_index;
+    instance.group_index = group_index;
+    instance.layer_index = layer_index;
+    return instance;
+}
+
+inline ogt_vox_group stress_make_group(uint32_t parent_group_index, uint32_t layer_index, const ogt_vox_transform& transform) {
+    ogt_vox_group group;
+    memset(&group, 0, sizeof(group));
+    group.transform          = transform;
+    group.parent_group_index = parent_group_index;
+    group.layer_index        = layer_index;
+    return group;
+}
+
+// builds a keyframe track for a transform that moves in a circle of the given radius around its start.
+inline void stress_make_transform_track(std::vector<ogt_vox_keyframe_transform>& track, uint32_t keyframe_count, uint32_t frame_step, const ogt_vox_transform& start, float radius) {
+    track.resize(keyframe_count);
+    for (uint32_t i = 0; i < keyframe_count; i++) {
+        float angle = (float)i * (6.2831853f / (float)keyframe_count);
+        track[i].frame_index = i * frame_step;
+        track[i].transform   = start;
+        track[i].transform.m30 += (float)(int32_t)(radius * cosf(angle));
+        track[i].transform.m31 += (float)(int32_t)(radius * sinf(angle));
+    }
+}
+
+// builds the scene for a case. scale is 1 for the full size stress case, larger values shrink it for quick runs.
+inline void build_stress_scene(stress_scene& s, stress_case c, uint32_t scale) {
+    s = stress_scene();
+    ogt_vox_layer layer;
+    memset(&layer, 0, sizeof(layer));
+    layer.color.r = layer.color.g = layer.color.b = layer.color.a = 255;
+    s.layers.push_back(layer);
+    layer.hidden = true;
+    s.layers.push_back(layer);
+
+    // the root group that every other group and instance is ultimately parented to.
+    s.groups.push_back(stress_make_group(k_invalid_group_index, 0, stress_translation(0.0f, 0.0f, 0.0f)));
+
+    switch (c) {
+        case stress_case_many_models: {
+            // every 16th model is empty so that k_read_scene_flags_keep_empty_models_instances has something to keep.
+            const uint32_t model_count = 4096 / scale;
+            for (uint32_t i = 0; i < model_count; i++) {
+                uint8_t* voxels = stress_add_model(s, 8, 8, 8);
+                if ((i % 16) != 15)
+                    stress_fill_model(voxels, 8 * 8 * 8, i, 1);
+                s.instances.push_back(stress_make_instance(i, 0, 0, stress_translation((float)((i % 64) * 10), (float)((i / 64) * 10), 0.0f)));
+            }
+            break;
+        }
+        case stress_case_duplicates: {
+            // writers emit a model per instance, so files commonly contain many copies of the same few models.
+            const uint32_t unique_count = 16;
+            const uint32_t model_count  = 4096 / scale;
+            for (uint32_t i = 0; i < model_count; i++) {
+                uint8_t* voxels = stress_add_model(s, 16, 16, 16);
+                stress_fill_model(voxels, 16 * 16 * 16, i % unique_count, 1);
+                s.instances.push_back(stress_make_instance(i, 0, 0, stress_translation((float)((i % 64) * 20), (float)((i / 64) * 20), 0.0f)));
+            }
+            break;
+        }
+        case stress_case_deep_groups: {
+            // a chain of nested groups, each offset from its parent, with an instance at every level.
+            // some groups are hidden or on the hidden layer so that readers can't trivially skip the visibility checks.
+            const uint32_t depth = 512 / scale;
+            uint8_t* voxels = stress_add_model(s, 4, 4, 4);
+            stress_fill_model(voxels, 4 * 4 * 4, 0, 0);
+            for (uint32_t i = 0; i < depth; i++) {
+                uint32_t group_index = (uint32_t)s.groups.size();
+                s.groups.push_back(stress_make_group(group_index - 1, (i % 7) == 6 ? 1 : 0, stress_translation(5.0f, 0.0f, 1.0f)));
+                s.groups.back().hidden = (i % 11) == 10;
+                s.instances.push_back(stress_make_instance(0, group_index, 0, stress_translation(0.0f, 5.0f, 0.0f)));
+            }
+            break;
+        }
+        case stress_case_keyframes: {
+            // instances in groups where instances and groups both have long transform tracks and instances cycle through models.
+            const uint32_t instance_count = 256 / scale;
+            const uint32_t keyframe_count = 1024 / scale;
+            const uint32_t model_count    = 4;
+            for (uint32_t i = 0; i < model_count; i++) {
+                uint8_t* voxels = stress_add_model(s, 8, 8, 8);
+                stress_fill_model(voxels, 8 * 8 * 8, 1000 + i, 1);
+            }
+            const uint32_t group_count = 16;
+            s.transform_keyframes.resize(group_count + instance_count);
+            s.model_keyframes.resize(instance_count);
+            for (uint32_t i = 0; i < group_count; i++) {
+                ogt_vox_transform start = stress_translation((float)(i * 100), 0.0f, 0.0f);
+                s.groups.push_back(stress_make_group(0, 0, start));
+                stress_make_transform_track(s.transform_keyframes[i], keyframe_count, 2, start, 20.0f);
+            }
+            for (uint32_t i = 0; i < instance_count; i++) {
+                ogt_vox_transform start = stress_translation(0.0f, (float)((i / group_count) * 10), 0.0f);
+                s.instances.push_back(stress_make_instance(i % model_count, 1 + (i % group_count), 0, start));
+                stress_make_transform_track(s.transform_keyframes[group_count + i], keyframe_count, 1, start, 4.0f);
+                std::vector<ogt_vox_keyframe_model>& track = s.model_keyframes[i];
+                track.resize(keyframe_count / 4);
+                for (uint32_t k = 0; k < track.size(); k++) {
+                    track[k].frame_index = k * 4;
+                    track[k].model_index = (i + k) % model_count;
+                }
+            }
+            // the track vectors are all sized now, so it is safe to point at them.
+            for (uint32_t i = 0; i < group_count; i++) {
+                ogt_vox_group& group = s.groups[1 + i];
+                group.transform_anim.keyframes     = s.transform_keyframes[i].data();
+                group.transform_anim.num_keyframes = (uint32_t)s.transform_keyframes[i].size();
+                group.transform_anim.loop          = true;
+            }
+            for (uint32_t i = 0; i < instance_count; i++) {
+                ogt_vox_instance& instance = s.instances[i];
+                instance.transform_anim.keyframes     = s.transform_keyframes[group_count + i].data();
+                instance.transform_anim.num_keyframes = (uint32_t)s.transform_keyframes[group_count + i].size();
+                instance.transform_anim.loop          = (i & 1) != 0;
+                instance.model_anim.keyframes         = s.model_keyframes[i].data();
+                instance.model_anim.num_keyframes     = (uint32_t)s.model_keyframes[i].size();
+                instance.model_anim.loop              = true;
+            }
+            break;
+        }
+        case stress_case_dense_256:
+        case stress_case_sparse_256: {
+            const uint32_t size = 256 / scale;
+            uint8_t* voxels = stress_add_model(s, size, size, size);
+            stress_fill_model(voxels, (size_t)size * size * size, 7, c == stress_case_dense_256 ? 0 : 6);
+            s.instances.push_back(stress_make_instance(0, 0, 0, stress_translation(0.0f, 0.0f, 0.0f)));
+            break;
+        }
+        default:
+            break;
+    }
+
+    // give every instance and group a name, since the reader has to copy those into the scene too.
+    s.names.resize(s.instances.size() + s.groups.size());
+    for (size_t i = 0; i < s.instances.size(); i++) {
+        s.names[i] = "instance_" + std::to_string(i);
+        s.instances[i].name = s.names[i].c_str();
+    }
+    for (size_t i = 0; i < s.groups.size(); i++) {
+        s.names[s.instances.size() + i] = "group_" + std::to_string(i);
+        s.groups[i].name = s.names[s.instances.size() + i].c_str();
+    }
+
+    s.model_ptrs.resize(s.models.size());
+    for (size_t i = 0; i < s.models.size(); i++) {
+        s.models[i].voxel_data = s.voxels[i].data();
+        s.model_ptrs[i] = &s.models[i];
+    }
+
+    memset(&s.scene, 0, sizeof(s.scene));
+    s.scene.num_models    = (uint32_t)s.models.size();
+    s.scene.num_instances = (uint32_t)s.instances.size();
+    s.scene.num_layers    = (uint32_t)s.layers.size();
+    s.scene.num_groups    = (uint32_t)s.groups.size();
+    s.scene.models        = s.model_ptrs.data();
+    s.scene.instances     = s.instances.data();
+    s.scene.layers        = s.layers.data();
+    s.scene.groups        = s.groups.data();
+    for (uint32_t i = 0; i < 256; i++) {
+        s.scene.palette.color[i].r = (uint8_t)(i * 37);
+        s.scene.palette.color[i].g = (uint8_t)(i * 91);
+        s.scene.palette.color[i].b = (uint8_t)(i * 173);
+        s.scene.palette.color[i].a = i ? 255 : 0;
+    }
+}
+
+// builds the scene for a case and returns it serialized as a .vox file. The result must be freed with ogt_vox_free.
+inline uint8_t* write_stress_scene(stress_case c, uint32_t scale, uint32_t* buffer_size) {
+    stress_scene s;
+    build_stress_scene(s, c, scale);
+    return ogt_vox_write_scene(&s.scene, buffer_size);
+}
+
+#endif // VOX_STRESS_SCENES_H__
+
+/* -------------------------------------------------------------------------------------------------------------------------------------------------
+
+    MIT License
+
+    Copyright (c) 2026 Justin Paver
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+    IN THE SOFTWARE.
+
+------------------------------------------------------------------------------------------------------------------------------------------------- */
@@ -0,0 +1,148 @@
+/*
+    voxstress - MIT license - Justin Paver, October 2026
+
+    A program that writes synthetic MagicaVoxel .vox files that stress particular parts of ogt_vox.h:
+    thousands of models, heavily duplicated models, deep group hierarchies, long keyframe tracks and
+    256^3 dense and sparse models. These are the same scenes that bench_vox times, written out so that
+    they can be loaded into other tools or kept as a reproducible baseline.
+
+    Please see the MIT license information at the end of this file, and please consider
+    sharing any improvements you make.
+*/
+
+#define OGT_VOX_IMPLEMENTATION
+#include "../src/ogt_vox.h"
+
+#include "vox_stress_scenes.h"
+
+#if defined(_MSC_VER)
+    #include <io.h>
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+
+FILE * open_file(const char *filename, const char *mode)
+{
+#if defined(_MSC_VER) && _MSC_VER >= 1400
+    FILE * fp;
+    if (0 != fopen_s(&fp, filename, mode))
+        fp = 0;
+#else
+    FILE * fp = fopen(filename, mode);
+#endif
+    return fp;
+}
+
+void print_help()
+{
+    printf(
+        "voxstress by Justin Paver - source code available here: http://github.com/jpaver/opengametools \n"
+        "\n"
+        "This tool writes synthetic .vox files that stress the reader, writer and merger of ogt_vox.h.\n"
+        "\n"
+        " usage: voxstress [optional args] [case ...]\n"
+        "\n"
+        " [case] can be one or multiple of:\n"
+        "   many_models, duplicates, deep_groups, keyframes, dense_256, sparse_256\n"
+        " and defaults to all of them. Each case is written to <case>.vox.\n"
+        "\n"
+        " [optional args] can be one or multiple of:\n"
+        " --scale <divisor>     : (default: 1) divides the number of models, instances, groups, keyframes and the\n"
+        "                         model size of each case, eg. to write smaller files for smoke testing\n"
+        " --output_dir <dir>    : (default: current directory) the directory to write the .vox files to\n"
+        "\n"
+        "example:\n"
+        "  voxstress --output_dir stress dense_256 keyframes\n"
+    );
+}
+
+int main(int argc, char** argv) {
+    uint32_t    scale      = 1;
+    const char* output_dir = NULL;
+    bool        selected[stress_case_count] = {};
+    bool        any_selected = false;
+
+    for (int i = 1; i < argc; i++) {
+        bool has_value = (i + 1) < argc;
+        if (strcmp(argv[i], "--scale") == 0 && has_value) {
+            scale = (uint32_t)atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--output_dir") == 0 && has_value) {
+            output_dir = argv[++i];
+        }
+        else if (strcmp(argv[i], "--help") == 0) {
+            print_help();
+            return 0;
+        }
+        else if (argv[i][0] == '-') {
+            printf("ERROR: unknown or incomplete argument: %s\n\n", argv[i]);
+            print_help();
+            return 1;
+        }
+        else {
+            uint32_t c = 0;
+            while (c < stress_case_count && strcmp(argv[i], k_stress_case_names[c]) != 0)
+                c++;
+            if (c == stress_case_count) {
+                printf("ERROR: unknown case: %s\n\n", argv[i]);
+                print_help();
+                return 1;
+            }
+            selected[c]  = true;
+            any_selected = true;
+        }
+    }
+    // every case divides its counts by the scale, and the smallest case has 256 / scale instances.
+    if (scale < 1 || scale > 64) {
+        printf("ERROR: --scale must be between 1 and 64\n");
+        return 1;
+    }
+
+    for (uint32_t c = 0; c < stress_case_count; c++) {
+        if (any_selected && !selected[c])
+            continue;
+        std::string filename = output_dir ? std::string(output_dir) + "/" : std::string();
+        filename += std::string(k_stress_case_names[c]) + ".vox";
+
+        uint32_t buffer_size = 0;
+        uint8_t* buffer = write_stress_scene((stress_case)c, scale, &buffer_size);
+        if (!buffer) {
+            fprintf(stderr, "ERROR: could not write case %s\n", k_stress_case_names[c]);
+            return 2;
+        }
+        FILE* fp = open_file(filename.c_str(), "wb");
+        if (!fp) {
+            ogt_vox_free(buffer);
+            fprintf(stderr, "ERROR: could not open %s for writing\n", filename.c_str());
+            return 3;
+        }
+        size_t written = fwrite(buffer, 1, buffer_size, fp);
+        fclose(fp);
+        ogt_vox_free(buffer);
+        if (written != buffer_size) {
+            fprintf(stderr, "ERROR: could not write all of %s\n", filename.c_str());
+            return 3;
+        }
+        printf("wrote %s (%u bytes)\n", filename.c_str(), buffer_size);
+    }
+    return 0;
+}
+
+/* -------------------------------------------------------------------------------------------------------------------------------------------------
+
+    MIT License
+
+    Copyright (c) 2026 Justin Paver
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+    IN THE SOFTWARE.
+
+------------------------------------------------------------------------------------------------------------------------------------------------- */
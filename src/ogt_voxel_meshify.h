@@ -66,8 +66,34 @@
         We support the following algorithms for meshing the voxel data for now:
 
         * ogt_mesh_from_paletted_voxels_simple:  creates 2 triangles for every visible voxel face.
+        * ogt_mesh_from_paletted_voxels_simple_shared: same faces as the simple meshifier, but shares vertices between faces of the same color.
         * ogt_mesh_from_paletted_voxels_greedy:  creates 2 triangles for every rectangular region of voxel faces with the same color
         * ogt_mesh_from_paletted_voxels_polygon: determines the polygon contour of every connected voxel face with the same color and then triangulates that.
+
+        Per-vertex ambient occlusion is opt-in at compile time, so that ogt_mesh_vertex stays 32 bytes when it isn't used. 
+        #define OGT_VOXEL_MESHIFY_VERTEX_AO before every include of this header to add the ao field to ogt_mesh_vertex. 
+        If it is defined and ambient_occlusion is set in the context, the simple, simple_shared and greedy meshers compute the ao of each vertex from 
+        the 4 voxels around its corner in front of its face: 3 minus the number of them that are solid, or 0 if two of them are 
+        solid and diagonal to each other. Quads are triangulated along the diagonal that interpolates ao without artifacts, and the 
+        greedy meshifier only merges faces whose ao would interpolate identically over the merged quad.
+
+        To mesh many models at once (eg. every model in an ogt_vox_scene), ogt_mesh_from_paletted_voxel_models and ogt_mesh_scene_models
+        mesh them all with one of these algorithms into a single combined vertex and index buffer, with the range that belongs to each model.
+
+        For depth pre-passes, shadow maps and collision, where colors don't matter, ogt_mesh_occluder_from_voxels meshes all solid voxels
+        as if they were the same color with one of these algorithms, producing far fewer triangles with position-only vertices.
+
+        ogt_mesh_atlas_from_paletted_voxels also greedily meshes all solid voxels as if they were the same color, and bakes the 
+        colors of each quad into a palette index texture atlas instead, with texture coordinates per vertex.
+
+        For physics, ogt_boxes_from_paletted_voxels greedily merges solid voxels into a small set of axis aligned boxes instead.
+
+        For distant geometry, ogt_mesh_voxel_lods_create builds a pyramid of voxel grids that are each downsampled 2x2x2 from the 
+        previous level, and ogt_mesh_voxel_lods_meshify meshes every level of it at once.
+
+        For levels built from many touching models (eg. a modular wall kit), ogt_mesh_chunks_from_scene flattens all visible instances
+        of a scene into a sparse grid of chunks and meshes chunk by chunk, so faces hidden between instances are removed and each chunk
+        is a single batch.
 */
 #ifndef OGT_VOXEL_MESHIFY_H__
 #define OGT_VOXEL_MESHIFY_H__
@@ -115,6 +141,29 @@ struct ogt_mesh_vertex
     ogt_mesh_vec3  normal;
     ogt_mesh_rgba  color;
     uint32_t palette_index;
+#ifdef OGT_VOXEL_MESHIFY_VERTEX_AO
+    uint8_t  ao;            // ambient occlusion of the vertex from 0 (fully occluded) to 3 (not occluded). Always 3 unless ctx->ambient_occlusion is set.
+    uint8_t  reserved[3];   // always 0
+#endif
+};
+
+// the six directions that voxel faces can point in.
+enum ogt_mesh_direction
+{
+    ogt_mesh_direction_pos_x = 0,
+    ogt_mesh_direction_neg_x = 1,
+    ogt_mesh_direction_pos_y = 2,
+    ogt_mesh_direction_neg_y = 3,
+    ogt_mesh_direction_pos_z = 4,
+    ogt_mesh_direction_neg_z = 5,
+    ogt_mesh_direction_count = 6
+};
+
+// a range of indices within a mesh.
+struct ogt_mesh_index_range
+{
+    uint32_t index_offset;          // first index of the range
+    uint32_t index_count;           // number of indices in the range
 };
 
 // a mesh that contains an indexed triangle list of vertices
@@ -124,8 +173,180 @@ struct ogt_mesh
     uint32_t         index_count;	// number of indices
     ogt_mesh_vertex* vertices;		// array of vertices
     uint32_t*        indices;		// array of indices
+    ogt_mesh_index_range direction_ranges[ogt_mesh_direction_count];  // indices of the triangles facing each direction. All empty unless made by ogt_mesh_from_paletted_voxels_*
+};
+
+// a small cluster of triangles of a mesh that all face the same direction, with bounds for culling. 
+struct ogt_mesh_meshlet
+{
+    uint32_t           vertex_offset;     // first entry of the meshlet within ogt_mesh_meshlets::vertices
+    uint32_t           vertex_count;      // number of vertices used by the meshlet
+    uint32_t           triangle_offset;   // first entry of the meshlet within ogt_mesh_meshlets::triangles. There are 3 entries per triangle.
+    uint32_t           triangle_count;    // number of triangles in the meshlet
+    ogt_mesh_direction direction;         // the direction that the triangles of the meshlet face
+    ogt_mesh_vec3      center;            // center of the bounding sphere
+    float              radius;            // radius of the bounding sphere
+    ogt_mesh_vec3      aabb_min;          // minimum corner of the bounding box
+    ogt_mesh_vec3      aabb_max;          // maximum corner of the bounding box
+    ogt_mesh_vec3      cone_apex;         // the meshlet faces away from any camera where dot(normalize(cone_apex - camera_position), cone_axis) >= cone_cutoff
+    ogt_mesh_vec3      cone_axis;         
+    float              cone_cutoff;       // 0 when all triangles have the same normal, which is always true for voxel meshes. 1 if the meshlet can never be cone culled. 
+};
+
+// a mesh partitioned into meshlets, which index into the vertices of the mesh that they were built from.
+struct ogt_mesh_meshlets
+{
+    uint32_t          meshlet_count;      // number of meshlets
+    uint32_t          vertex_count;       // number of entries in vertices
+    uint32_t          triangle_count;     // number of triangles across all meshlets. triangles has 3x this many entries.
+    ogt_mesh_meshlet* meshlets;           // array of meshlets
+    uint32_t*         vertices;           // the mesh vertex indices used by each meshlet.
+    uint8_t*          triangles;          // 3 indices per triangle of each meshlet, which are relative to the first of its vertices.
+};
+
+// the meshing algorithms that can be chosen when meshing many models at once. Each matches the ogt_mesh_from_paletted_voxels_* function of the same name.
+enum ogt_mesh_algorithm
+{
+    ogt_mesh_algorithm_simple,
+    ogt_mesh_algorithm_simple_shared,
+    ogt_mesh_algorithm_greedy,
+    ogt_mesh_algorithm_polygon
+};
+
+// options for ogt_mesh_from_paletted_voxel_models, which are applied to the mesh of each model before it is combined with the others.
+static const uint32_t k_ogt_mesh_option_remove_duplicate_vertices = 1 << 0;   // as per ogt_mesh_remove_duplicate_vertices
+static const uint32_t k_ogt_mesh_option_smooth_normals            = 1 << 1;   // as per ogt_mesh_smooth_normals, after removing duplicates if that is also requested.
+
+// a voxel grid to be meshed by ogt_mesh_from_paletted_voxel_models. 
+struct ogt_mesh_voxel_model
+{
+    const uint8_t* voxels;          // grid of palette indices in x -> y -> z order. 
+    uint32_t       size_x;          // number of voxels in the x dimension
+    uint32_t       size_y;          // number of voxels in the y dimension
+    uint32_t       size_z;          // number of voxels in the z dimension
+};
+
+// the range of vertices and indices within a combined mesh that belong to one model.
+struct ogt_mesh_model_range
+{
+    uint32_t vertex_offset;         // first vertex of the model within the combined mesh
+    uint32_t vertex_count;          // number of vertices of the model
+    uint32_t index_offset;          // first index of the model within the combined mesh
+    uint32_t index_count;           // number of indices of the model
+    ogt_mesh_index_range direction_ranges[ogt_mesh_direction_count];   // the indices of the model's triangles that face each direction
+};
+
+// the meshes of many models combined into a single vertex and index buffer. Indices refer to vertices of the combined mesh (ie.
+// they already include the vertex_offset of their model) so each model can be drawn from the same buffers with just its index range.
+struct ogt_mesh_models
+{
+    ogt_mesh              mesh;             // the combined vertices and indices of all models
+    uint32_t              model_count;      // number of models
+    ogt_mesh_model_range* model_ranges;     // the range of the combined mesh that belongs to each model. size is model_count.
+};
+
+// a mesh with only vertex positions, that covers the surface of all solid voxels regardless of their color. Useful for depth 
+// pre-passes, shadow maps and collision. Vertices are shared by all triangles that touch the same position.
+struct ogt_mesh_occluder
+{
+    uint32_t             vertex_count;      // number of vertices
+    uint32_t             index_count;       // number of indices
+    ogt_mesh_vec3*       positions;         // array of vertex positions
+    uint32_t*            indices;           // array of indices
+    ogt_mesh_index_range direction_ranges[ogt_mesh_direction_count];  // indices of the triangles facing each direction
+};
+
+// a vertex of an ogt_mesh_atlas.
+struct ogt_mesh_atlas_vertex
+{
+    ogt_mesh_vec3 pos;
+    ogt_mesh_vec3 normal;
+    float         u, v;                 // texture coordinates within the atlas, in [0,1]
+};
+
+// a mesh of quads that cover many voxels of different colors, where the palette index of each voxel face is stored in a texture atlas.
+// Each texel of the atlas maps to exactly one voxel face, so the atlas should be sampled with nearest filtering, eg. to look up the 
+// palette in a shader.
+struct ogt_mesh_atlas
+{
+    uint32_t               vertex_count;    // number of vertices
+    uint32_t               index_count;     // number of indices
+    ogt_mesh_atlas_vertex* vertices;        // array of vertices
+    uint32_t*              indices;         // array of indices
+    ogt_mesh_index_range   direction_ranges[ogt_mesh_direction_count];  // indices of the triangles facing each direction
+    uint32_t               atlas_width;     // width of the atlas in texels
+    uint32_t               atlas_height;    // height of the atlas in texels
+    uint8_t*               atlas;           // palette index of each texel in rows of atlas_width texels. Texels that aren't covered by a quad are 0.
+};
+
+// an axis aligned box of voxels. The box covers voxel coordinates [min_x, max_x) etc. which are also its mesh space bounds, 
+// as a voxel at (x,y,z) covers [x, x+1) in mesh space.
+struct ogt_mesh_box
+{
+    uint32_t min_x, min_y, min_z;       // the min corner of the box
+    uint32_t max_x, max_y, max_z;       // the max corner of the box
+    uint8_t  palette_index;             // palette index of the voxel at the min corner of the box, or 0 if it is filled interior space. 
+                                        // When boxes were coarsened, this is the first solid voxel within the coarse cell at the min corner.
+};
+
+// a set of axis aligned boxes that cover the solid voxels of a grid.
+struct ogt_mesh_boxes
+{
+    uint32_t      box_count;            // number of boxes
+    ogt_mesh_box* boxes;                // array of boxes
+    uint32_t      scale;                // 1 when the boxes cover exactly the solid voxels. Otherwise the boxes were made from cells of scale^3 voxels 
+                                        // to fit within max_box_count, so they cover all solid voxels and some empty space around them too.
+};
+
+// options for ogt_boxes_from_paletted_voxels.
+static const uint32_t k_ogt_boxes_option_fill_interior    = 1 << 0;   // empty space that is fully enclosed by solid voxels is treated as solid, which allows bigger boxes.
+static const uint32_t k_ogt_boxes_option_split_by_palette = 1 << 1;   // boxes only contain voxels of a single palette index, eg. for per-material physics properties.
+
+// how voxels are downsampled when building levels of detail. Each voxel of a level is made from 2x2x2 voxels of the previous level.
+enum ogt_mesh_lod_filter
+{
+    ogt_mesh_lod_filter_majority,       // solid if at least half of the 2x2x2 voxels are solid. Small and thin details disappear in lower levels.
+    ogt_mesh_lod_filter_conservative    // solid if any of the 2x2x2 voxels are solid, which preserves the silhouette and thin details, but grows the shape.
+};
+
+// options for ogt_mesh_voxel_lods_create.
+static const uint32_t k_ogt_mesh_lod_option_preserve_surface = 1 << 0;  // the color of a voxel is chosen only from the 2x2x2 voxels that were on the surface when there are any, so interior colors never show.
+
+// a pyramid of levels of detail of a voxel grid.
+struct ogt_mesh_voxel_lods
+{
+    uint32_t              lod_count;    // number of levels, including the full resolution grid
+    ogt_mesh_voxel_model* lods;         // the grid of each level, starting with a copy of the full resolution grid. Each level is half the size of the previous one on each axis, rounded up.
+};
+
+// an instance of a model placed in a voxel world with an axis aligned rotation or mirroring. Voxel v of the model is at world voxel 
+// position w, where w[i] = offset[i] + v[axes[i]] for each world axis i, or offset[i] - v[axes[i]] if negate[i] is set.
+struct ogt_mesh_voxel_instance
+{
+    uint32_t model_index;               // index of the model of this instance
+    uint8_t  axes[3];                   // the model axis (0=x, 1=y, 2=z) along each world axis. Must be a permutation of 0,1,2.
+    bool     negate[3];                 // whether the model axis runs backward along each world axis.
+    int32_t  offset[3];                 // world voxel position of model voxel (0,0,0).
+};
+
+// a cube of chunk_size voxels of the world.
+struct ogt_mesh_chunk
+{
+    int32_t min_x, min_y, min_z;        // world voxel position of the first voxel of the chunk. Always a multiple of chunk_size.
+};
+
+// the meshes of the chunks of a voxel world.
+struct ogt_mesh_chunks
+{
+    uint32_t         chunk_size;        // number of voxels along each axis of a chunk
+    uint32_t         chunk_count;       // number of chunks, which only includes chunks with at least one triangle
+    ogt_mesh_chunk*  chunks;            // array of chunks. size is chunk_count.
+    ogt_mesh_models* meshes;            // the meshes of all chunks combined, where model_ranges[i] is the range of chunks[i]. Positions are in world voxel units.
 };
 
+// meshes a chunked voxel world with all layers of a scene in ogt_mesh_chunks_from_scene.
+static const uint32_t k_ogt_mesh_all_layers = UINT32_MAX;
+
 // allocate memory function interface. pass in size, and get a pointer to memory with at least that size available.
 typedef void* (*ogt_voxel_meshify_alloc_func)(size_t size, void* user_data);
 
@@ -135,14 +356,40 @@ typedef void  (*ogt_voxel_meshify_free_func)(void* ptr, void* user_data);
 // stream function can receive a batch of triangles for each voxel processed by ogt_stream_from_paletted_voxels_simple. (i,j,k) 
 typedef void (*ogt_voxel_simple_stream_func)(uint32_t x, uint32_t y, uint32_t z, const ogt_mesh_vertex* vertices, uint32_t vertex_count, const uint32_t* indices, uint32_t index_count, void* user_data);
 
+// batch stream function receives the triangles for many voxels at once from ogt_stream_from_paletted_voxels_simple_batched. 
+// Indices are relative to the first vertex of the entire stream, not the first vertex of the batch.
+typedef void (*ogt_voxel_simple_batch_stream_func)(const ogt_mesh_vertex* vertices, uint32_t vertex_count, const uint32_t* indices, uint32_t index_count, void* user_data);
+
+// a scratch memory arena that can be reused across api calls to avoid allocating temporary memory on each call. See ogt_voxel_meshify_scratch_create.
+struct ogt_voxel_meshify_scratch;
+
+// job function interface. Invoked once for each job_index in [0, job_count) by a parallel for function.
+typedef void  (*ogt_voxel_meshify_job_func)(uint32_t job_index, void* job_data);
+
+// parallel for function interface. It must invoke job_func(job_index, job_data) for every job_index in [0, job_count), 
+// in any order and on any thread, and only return once all jobs have completed.
+typedef void  (*ogt_voxel_meshify_parallel_for_func)(ogt_voxel_meshify_job_func job_func, void* job_data, uint32_t job_count, void* user_data);
+
 // a context that allows you to override various internal operations of the below api functions.
 struct ogt_voxel_meshify_context
 {
     ogt_voxel_meshify_alloc_func                alloc_func;                 // override allocation function
     ogt_voxel_meshify_free_func                 free_func;                  // override free function
     void*                                       alloc_free_user_data;       // alloc/free user-data (passed to alloc_func / free_func )
+    ogt_voxel_meshify_parallel_for_func         parallel_for_func;          // optional: runs independent jobs on your own threads. Jobs run serially if NULL. 
+    void*                                       parallel_for_user_data;     // parallel for user-data (passed to parallel_for_func)
+    ogt_voxel_meshify_scratch*                  scratch;                    // optional: all temporary memory is taken from this arena instead of alloc_func. It is not thread-safe, so don't share it across threads.
+    bool                                        ambient_occlusion;          // optional: the simple, simple_shared and greedy meshers compute the ao of each vertex, and greedy only merges faces with the same ao. Ignored unless OGT_VOXEL_MESHIFY_VERTEX_AO is defined.
 };
 
+// creates a scratch memory arena with initial_size bytes available. Set it as the scratch member of a context, and all temporary 
+// memory used by api functions is taken from it. The arena grows to the peak memory needed by any call, so after a few calls, 
+// api functions only need to allocate memory for the meshes they return.
+ogt_voxel_meshify_scratch* ogt_voxel_meshify_scratch_create(const ogt_voxel_meshify_context* ctx, size_t initial_size);
+
+// destroys a scratch memory arena returned by ogt_voxel_meshify_scratch_create.
+void      ogt_voxel_meshify_scratch_destroy(const ogt_voxel_meshify_context* ctx, ogt_voxel_meshify_scratch* scratch);
+
 // returns the number of quad faces that would be generated by tessellating the specified voxel field using the simple algorithm. Useful for preallocating memory.
 // number of vertices needed would 4x this value, and number of indices needed would be 6x this value.
 uint32_t ogt_face_count_from_paletted_voxels_simple(const uint8_t* voxels, uint32_t size_x, uint32_t size_y, uint32_t size_z);
@@ -150,8 +397,13 @@ uint32_t ogt_face_count_from_paletted_voxels_simple(const uint8_t* voxels, uint3
 // The simple meshifier returns the most naieve mesh possible, which will be tessellated at voxel granularity. 
 ogt_mesh* ogt_mesh_from_paletted_voxels_simple(const ogt_voxel_meshify_context* ctx, const uint8_t* voxels, uint32_t size_x, uint32_t size_y, uint32_t size_z, const ogt_mesh_rgba* palette);
 
+// The simple shared meshifier generates the same faces as the simple meshifier, but vertices at face corners with the same normal and color
+// are shared as they are generated. The result is the same as calling ogt_mesh_remove_duplicate_vertices on the simple mesh, without the extra pass. 
+ogt_mesh* ogt_mesh_from_paletted_voxels_simple_shared(const ogt_voxel_meshify_context* ctx, const uint8_t* voxels, uint32_t size_x, uint32_t size_y, uint32_t size_z, const ogt_mesh_rgba* palette);
+
 // The greedy meshifier will use a greedy box-expansion pass to replace the polygons of adjacent voxels of the same color with a larger polygon that covers the box.
 // It will generally produce t-junctions which can make rasterization not water-tight based on your camera/project/distances.
+// If ctx->ambient_occlusion is set, faces are only merged where their ao matches, so there will be more triangles.
 ogt_mesh* ogt_mesh_from_paletted_voxels_greedy(const ogt_voxel_meshify_context* ctx, const uint8_t* voxels, uint32_t size_x, uint32_t size_y, uint32_t size_z, const ogt_mesh_rgba* palette);
 
 // The polygon meshifier will polygonize and triangulate connected voxels that are of the same color. The boundary of the polygon
@@ -161,18 +413,132 @@ ogt_mesh* ogt_mesh_from_paletted_voxels_polygon(const ogt_voxel_meshify_context*
 
 // ogt_mesh_remove_duplicate_vertices will in-place remove identical vertices and remap indices to produce an identical mesh.
 // Use this after a call to ogt_mesh_from_paletted_voxels_* functions to remove duplicate vertices with the same attributes.
+// Vertex hashing, duplicate search and index remapping are split into jobs that run on ctx->parallel_for_func if it is set.
 void	  ogt_mesh_remove_duplicate_vertices(const ogt_voxel_meshify_context* ctx, ogt_mesh* mesh);
 
 // Removes faceted normals on the mesh and averages vertex normals based on the faces that are adjacent.
 // It is recommended only to call this on  ogt_mesh_from_paletted_voxels_simple.
+// If ctx->parallel_for_func is set, this runs as ogt_mesh_smooth_normals_with_angle with an angle of 180, which gives identical results.
 void      ogt_mesh_smooth_normals(const ogt_voxel_meshify_context* ctx, ogt_mesh* mesh);
 
+// Same as ogt_mesh_smooth_normals, except a face only contributes to a vertex normal if the face normal is within max_angle_degrees
+// of the existing normal of that vertex, so edges sharper than that angle stay hard. Passing 180 smooths across all edges.
+// Face normals and vertex normals are computed in jobs that run on ctx->parallel_for_func if it is set.
+void      ogt_mesh_smooth_normals_with_angle(const ogt_voxel_meshify_context* ctx, ogt_mesh* mesh, float max_angle_degrees);
+
+// Reorders the triangles and vertices of the mesh in-place to make it faster to render, without changing what is rendered:
+// triangles are ordered for post-transform vertex cache reuse in a cache of cache_size vertices, runs of triangles that share
+// the cache are then ordered from the outside of the mesh inward to reduce overdraw, and finally vertices are ordered by first 
+// use for vertex fetch locality. Vertices that are not used by any triangle are removed. Pass 0 for cache_size to use a default of 16.
+// Triangles are only reordered within each of the direction_ranges of the mesh, so they stay valid.
+void      ogt_mesh_optimize(const ogt_voxel_meshify_context* ctx, ogt_mesh* mesh, uint32_t cache_size);
+
+// Returns the average cache miss ratio (ACMR) of the mesh for a FIFO post-transform vertex cache of cache_size vertices: the 
+// number of vertices that would be transformed per triangle. It ranges from 3.0 in the worst case to about 0.5 for large 
+// well-ordered grids, and is useful for measuring the effect of ogt_mesh_optimize. Pass 0 for cache_size to use a default of 16.
+float     ogt_mesh_get_acmr(const ogt_voxel_meshify_context* ctx, const ogt_mesh* mesh, uint32_t cache_size);
+
+// Sorts the triangles of any mesh in-place by the direction that they face, and updates its direction_ranges. If out_palette_ranges 
+// is not NULL, the triangles of each direction are also sorted by palette index, and out_palette_ranges receives the range of each
+// direction and palette index at out_palette_ranges[direction * 256 + palette_index], which must have room for 6 * 256 ranges.
+void      ogt_mesh_sort_triangles_by_direction(const ogt_voxel_meshify_context* ctx, ogt_mesh* mesh, ogt_mesh_index_range* out_palette_ranges);
+
+// Partitions the triangles of the mesh into meshlets of at most max_vertices vertices (up to 256) and max_triangles triangles, 
+// for cluster culling or mesh shader rendering. Triangles are grouped by the direction that they face, so each meshlet only
+// contains triangles of one direction, and is otherwise filled in the order of triangles in the mesh. Works with the output
+// of any ogt_mesh_from_paletted_voxels_* function. Pass 0 for max_vertices or max_triangles to use defaults of 64 and 124.
+ogt_mesh_meshlets* ogt_mesh_build_meshlets(const ogt_voxel_meshify_context* ctx, const ogt_mesh* mesh, uint32_t max_vertices, uint32_t max_triangles);
+
+// destroys the meshlets returned by ogt_mesh_build_meshlets.
+void      ogt_mesh_meshlets_destroy(const ogt_voxel_meshify_context* ctx, ogt_mesh_meshlets* meshlets);
+
 // destroys the mesh returned by ogt_mesh_from_paletted_voxels* functions.
 void      ogt_mesh_destroy(const ogt_voxel_meshify_context* ctx, ogt_mesh* mesh );
+
+// Meshes each of the specified models with the specified algorithm, and combines the results into a single vertex and index buffer
+// in the same order as the models. options is a combination of k_ogt_mesh_option_* flags. Each model is meshed in its own job on 
+// ctx->parallel_for_func if it is set, otherwise models are meshed one after another. The result is made with very few allocations, 
+// no matter how many models there are.
+ogt_mesh_models* ogt_mesh_from_paletted_voxel_models(const ogt_voxel_meshify_context* ctx, const ogt_mesh_voxel_model* models, uint32_t model_count, const ogt_mesh_rgba* palette, ogt_mesh_algorithm algorithm, uint32_t options);
+
+#ifdef OGT_VOX_H__
+// Meshes all models in the scene with its palette as per ogt_mesh_from_paletted_voxel_models. model_ranges can be indexed with 
+// the model_index of scene instances. This is only available if ogt_vox.h is included before this file.
+ogt_mesh_models* ogt_mesh_scene_models(const ogt_voxel_meshify_context* ctx, const ogt_vox_scene* scene, ogt_mesh_algorithm algorithm, uint32_t options);
+#endif
+
+// destroys the result of ogt_mesh_from_paletted_voxel_models or ogt_mesh_scene_models.
+void      ogt_mesh_models_destroy(const ogt_voxel_meshify_context* ctx, ogt_mesh_models* models);
     
+// Meshes the surface of all solid voxels with the specified algorithm as if every solid voxel had the same color, so faces are 
+// never split by color changes, and welds vertices of all triangles by position. voxels are paletted voxels as for the other 
+// api functions, but the palette isn't needed.
+ogt_mesh_occluder* ogt_mesh_occluder_from_voxels(const ogt_voxel_meshify_context* ctx, const uint8_t* voxels, uint32_t size_x, uint32_t size_y, uint32_t size_z, ogt_mesh_algorithm algorithm);
+
+// destroys the result of ogt_mesh_occluder_from_voxels.
+void      ogt_mesh_occluder_destroy(const ogt_voxel_meshify_context* ctx, ogt_mesh_occluder* occluder);
+
+// Greedily meshes the surface of all solid voxels into maximal quads regardless of color, and bakes the palette index of each voxel 
+// face that a quad covers into a texel of a texture atlas. Quads are packed into the atlas in rows, tallest first.
+ogt_mesh_atlas* ogt_mesh_atlas_from_paletted_voxels(const ogt_voxel_meshify_context* ctx, const uint8_t* voxels, uint32_t size_x, uint32_t size_y, uint32_t size_z);
+
+// destroys the result of ogt_mesh_atlas_from_paletted_voxels.
+void      ogt_mesh_atlas_destroy(const ogt_voxel_meshify_context* ctx, ogt_mesh_atlas* atlas);
+
+// Greedily merges the solid voxels of the grid into axis aligned boxes, eg. for physics colliders. Starting at each voxel that 
+// isn't covered yet in x, then y, then z order, a box is grown as far as possible along x, then y, then z. options is a 
+// combination of k_ogt_boxes_option_* flags. If max_box_count is not 0 and more boxes than that are needed, the result is lossy:
+// boxes are made from a grid of 2x2x2 cells instead, where a cell is solid if any of its voxels are, then 4x4x4 cells and so on 
+// until they fit, so the boxes still cover every solid voxel but also some empty space. See ogt_mesh_boxes::scale.
+ogt_mesh_boxes* ogt_boxes_from_paletted_voxels(const ogt_voxel_meshify_context* ctx, const uint8_t* voxels, uint32_t size_x, uint32_t size_y, uint32_t size_z, uint32_t max_box_count, uint32_t options);
+
+// destroys the result of ogt_boxes_from_paletted_voxels.
+void      ogt_boxes_destroy(const ogt_voxel_meshify_context* ctx, ogt_mesh_boxes* boxes);
+
+// Builds levels of detail of the voxel grid by repeatedly downsampling it 2x2x2 with the specified filter until the grid is a single 
+// voxel, or there are max_lod_count levels (pass 0 for no limit). The color of each voxel is the most frequent palette index of the 
+// 2x2x2 voxels it was made from. options is a combination of k_ogt_mesh_lod_option_* flags. Each level is downsampled in parallel 
+// jobs on ctx->parallel_for_func if it is set.
+ogt_mesh_voxel_lods* ogt_mesh_voxel_lods_create(const ogt_voxel_meshify_context* ctx, const uint8_t* voxels, uint32_t size_x, uint32_t size_y, uint32_t size_z, uint32_t max_lod_count, ogt_mesh_lod_filter filter, uint32_t options);
+
+#ifdef OGT_VOX_H__
+// Builds levels of detail of the voxel grid of an ogt_vox_model as per ogt_mesh_voxel_lods_create. Only available if ogt_vox.h is included before this file.
+ogt_mesh_voxel_lods* ogt_mesh_voxel_lods_from_vox_model(const ogt_voxel_meshify_context* ctx, const ogt_vox_model* model, uint32_t max_lod_count, ogt_mesh_lod_filter filter, uint32_t options);
+#endif
+
+// Meshes every level of detail as per ogt_mesh_from_paletted_voxel_models, with model_ranges indexed by level. Vertex positions of
+// each level are scaled by 2^level so that every level lines up with the mesh of the full resolution grid.
+ogt_mesh_models* ogt_mesh_voxel_lods_meshify(const ogt_voxel_meshify_context* ctx, const ogt_mesh_voxel_lods* lods, const ogt_mesh_rgba* palette, ogt_mesh_algorithm algorithm, uint32_t options);
+
+// destroys the result of ogt_mesh_voxel_lods_create.
+void      ogt_mesh_voxel_lods_destroy(const ogt_voxel_meshify_context* ctx, ogt_mesh_voxel_lods* lods);
+
+// Flattens instances of models into a sparse voxel world of chunks that are chunk_size voxels along each axis, and meshes each chunk 
+// with the voxels of its neighbours as per ogt_mesh_from_paletted_voxel_models. Faces between touching instances are removed, 
+// even across chunk boundaries. Where instances overlap, later instances overwrite the voxels of earlier ones. Only chunks that 
+// overlap an instance are rasterized, so empty space costs nothing. Pass 0 for chunk_size to use a default of 32. The greedy and 
+// polygon meshers don't compute ao for chunks even if ctx->ambient_occlusion is set.
+ogt_mesh_chunks* ogt_mesh_chunks_from_voxel_instances(const ogt_voxel_meshify_context* ctx, const ogt_mesh_voxel_model* models, uint32_t model_count, 
+    const ogt_mesh_voxel_instance* instances, uint32_t instance_count, const ogt_mesh_rgba* palette, uint32_t chunk_size, ogt_mesh_algorithm algorithm, uint32_t options);
+
+#ifdef OGT_VOX_H__
+// Flattens the visible instances of the scene as per ogt_mesh_chunks_from_voxel_instances. Pass a layer_index to only include the 
+// instances of that layer, or k_ogt_mesh_all_layers. Instances that are hidden, or that are in a hidden layer or group are skipped.
+// Only available if ogt_vox.h is included before this file.
+ogt_mesh_chunks* ogt_mesh_chunks_from_scene(const ogt_voxel_meshify_context* ctx, const ogt_vox_scene* scene, uint32_t layer_index, uint32_t chunk_size, ogt_mesh_algorithm algorithm, uint32_t options);
+#endif
+
+// destroys the result of ogt_mesh_chunks_from_voxel_instances or ogt_mesh_chunks_from_scene.
+void      ogt_mesh_chunks_destroy(const ogt_voxel_meshify_context* ctx, ogt_mesh_chunks* chunks);
+
 // The simple stream function will stream geometry for the specified voxel field, to the specified stream function, which will be invoked on each voxel that requires geometry. 
 void     ogt_stream_from_paletted_voxels_simple(const uint8_t* voxels, uint32_t size_x, uint32_t size_y, uint32_t size_z, const ogt_mesh_rgba* palette, ogt_voxel_simple_stream_func stream_func, void* stream_func_data);
 
+// The batched stream function will accumulate geometry for up to batch_face_count faces into an internal buffer (allocated via ctx) before 
+// invoking the specified stream function with it. This is much cheaper than a callback per voxel for dense voxel fields. 
+// Pass 0 for batch_face_count to use a default batch size. Batches are at least 6 faces and at most 1M faces.
+void     ogt_stream_from_paletted_voxels_simple_batched(const ogt_voxel_meshify_context* ctx, const uint8_t* voxels, uint32_t size_x, uint32_t size_y, uint32_t size_z, const ogt_mesh_rgba* palette, uint32_t batch_face_count, ogt_voxel_simple_batch_stream_func stream_func, void* stream_func_data);
+
 
 #endif // OGT_VOXEL_MESHIFY_H__
 
@@ -188,13 +554,21 @@ void     ogt_stream_from_paletted_voxels_simple(const uint8_t* voxels, uint32_t
 #include <memory.h>
 #include <math.h>
 
-// a set of up to 65536 bits
-struct ogt_mesh_bitset_64k {
-    uint8_t bits[8192];
+// use SSE2 to build voxel occupancy masks 16 voxels at a time where it is available. #define OGT_VOXEL_MESHIFY_NO_SIMD to disable.
+#if !defined(OGT_VOXEL_MESHIFY_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+    #include <emmintrin.h>
+    #define _OGT_VOXEL_MESHIFY_SSE2
+#endif
+#if defined(_MSC_VER) || (defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__))
+    #define _OGT_VOXEL_MESHIFY_LITTLE_ENDIAN
+#endif
+
+// a set of bits, stored in memory provided by the user.
+struct ogt_mesh_bitset {
+    uint8_t* bits;
+    static size_t get_size(uint32_t max_bits) { return (max_bits+7)/8; }
     void clear(uint32_t max_bits) {
-        if (max_bits > (8192*8))
-            max_bits = (8192*8);
-        memset(bits, 0, (max_bits+7)/8);
+        memset(bits, 0, get_size(max_bits));
     }
     uint8_t is_set(uint32_t index) { return bits[index/8] & (1<<(index%8)); }
     void set(uint32_t index)	{ bits[index/8] |=  (1<<(index%8)); }
@@ -214,44 +588,150 @@ static void _voxel_meshify_free(const ogt_voxel_meshify_context* ctx, void* old_
     }
 }
 
-// column-major 4x4 matrix
-struct ogt_mesh_transform  {
-    float m00, m01, m02, m03;   // column 0 of 4x4 matrix, 1st three elements = x axis vector, last element always 0.0
-    float m10, m11, m12, m13;   // column 1 of 4x4 matrix, 1st three elements = y axis vector, last element always 0.0
-    float m20, m21, m22, m23;   // column 2 of 4x4 matrix, 1st three elements = z axis vector, last element always 0.0
-    float m30, m31, m32, m33;   // column 3 of 4x4 matrix. 1st three elements = translation vector, last element always 1.0
+// invokes job_func for each of job_count jobs, in parallel if the context provides a way to do so.
+static void _voxel_meshify_parallel_for(const ogt_voxel_meshify_context* ctx, ogt_voxel_meshify_job_func job_func, void* job_data, uint32_t job_count) {
+    if (ctx->parallel_for_func && job_count > 1) {
+        ctx->parallel_for_func(job_func, job_data, job_count, ctx->parallel_for_user_data);
+    }
+    else {
+        for (uint32_t job_index = 0; job_index < job_count; job_index++)
+            job_func(job_index, job_data);
+    }
+}
+
+// a block of scratch memory that is allocated when the main block of a scratch arena is not big enough.
+struct ogt_mesh_scratch_block {
+    ogt_mesh_scratch_block* next;   // the previously allocated overflow block.
+    size_t                  size;   // the size of the block in bytes, including this header.
+    size_t                  used;   // the number of bytes used in the block, including this header.
 };
 
-// replaces transforms the point computes: transform * (vec.x, vec.y, vec.z, 1.0)
-inline ogt_mesh_vec3 _transform_point(const ogt_mesh_transform& transform, const ogt_mesh_vec3& vec) {
-    ogt_mesh_vec3 ret;
-    ret.x = transform.m30 + (transform.m00 * vec.x) + (transform.m10 * vec.y) + (transform.m20 * vec.z);
-    ret.y = transform.m31 + (transform.m01 * vec.x) + (transform.m11 * vec.y) + (transform.m21 * vec.z);
-    ret.z = transform.m32 + (transform.m02 * vec.x) + (transform.m12 * vec.y) + (transform.m22 * vec.z);
-    return ret;
+// a linear scratch memory arena. Memory is allocated from the main block until it runs out, and from a chain of overflow 
+// blocks after that. When all scratch memory is released, overflow blocks are freed and the main block is grown to
+// the peak amount of memory that was in use, so the next call will make no allocations at all.
+struct ogt_voxel_meshify_scratch {
+    uint8_t*                data;       // the main block
+    size_t                  size;       // size of the main block
+    size_t                  used;       // bytes used in the main block
+    size_t                  in_use;     // bytes currently in use across the main block and all overflow blocks
+    size_t                  peak;       // the peak value of in_use since the main block was last resized
+    ogt_mesh_scratch_block* overflow;   // the most recently allocated overflow block.
+};
+
+// the state of a scratch arena that can be returned to via _scratch_end.
+struct ogt_mesh_scratch_mark {
+    size_t                  used;
+    size_t                  in_use;
+    ogt_mesh_scratch_block* overflow;
+    size_t                  overflow_used;
+};
+
+static const size_t k_scratch_alignment = 16;
+
+ogt_voxel_meshify_scratch* ogt_voxel_meshify_scratch_create(const ogt_voxel_meshify_context* ctx, size_t initial_size) {
+    ogt_voxel_meshify_scratch* scratch = (ogt_voxel_meshify_scratch*)_voxel_meshify_malloc(ctx, sizeof(ogt_voxel_meshify_scratch));
+    if (!scratch)
+        return NULL;
+    memset(scratch, 0, sizeof(ogt_voxel_meshify_scratch));
+    if (initial_size) {
+        scratch->data = (uint8_t*)_voxel_meshify_malloc(ctx, initial_size);
+        scratch->size = scratch->data ? initial_size : 0;
+    }
+    return scratch;
 }
 
-// replaces transforms the point computes: transform * (vec.x, vec.y, vec.z, 0.0)
-inline ogt_mesh_vec3 _transform_vector(const ogt_mesh_transform& transform, const ogt_mesh_vec3& vec) {
-    ogt_mesh_vec3 ret;
-    ret.x = (transform.m00 * vec.x) + (transform.m10 * vec.y) + (transform.m20 * vec.z);
-    ret.y = (transform.m01 * vec.x) + (transform.m11 * vec.y) + (transform.m21 * vec.z);
-    ret.z = (transform.m02 * vec.x) + (transform.m12 * vec.y) + (transform.m22 * vec.z);
-    return ret;
+void ogt_voxel_meshify_scratch_destroy(const ogt_voxel_meshify_context* ctx, ogt_voxel_meshify_scratch* scratch) {
+    if (!scratch)
+        return;
+    assert(scratch->in_use == 0);  // can't destroy a scratch arena while an api function is using it.
+    while (scratch->overflow) {
+        ogt_mesh_scratch_block* block = scratch->overflow;
+        scratch->overflow = block->next;
+        _voxel_meshify_free(ctx, block);
+    }
+    _voxel_meshify_free(ctx, scratch->data);
+    _voxel_meshify_free(ctx, scratch);
 }
 
-inline ogt_mesh_transform _make_transform(
-    float m00, float m01, float m02, float m03,
-    float m10, float m11, float m12, float m13,
-    float m20, float m21, float m22, float m23,
-    float m30, float m31, float m32, float m33)
-{
-    ogt_mesh_transform ret;
-    ret.m00 = m00;    ret.m01 = m01;	ret.m02 = m02;	ret.m03 = m03;
-    ret.m10 = m10;    ret.m11 = m11;	ret.m12 = m12;	ret.m13 = m13;
-    ret.m20 = m20;    ret.m21 = m21;	ret.m22 = m22;	ret.m23 = m23;
-    ret.m30 = m30;    ret.m31 = m31;	ret.m32 = m32;	ret.m33 = m33;
-    return ret;
+// marks the start of a scope of scratch allocations. All memory allocated via _scratch_alloc after this point is released by _scratch_end.
+static ogt_mesh_scratch_mark _scratch_begin(const ogt_voxel_meshify_context* ctx) {
+    ogt_mesh_scratch_mark mark;
+    memset(&mark, 0, sizeof(mark));
+    ogt_voxel_meshify_scratch* scratch = ctx->scratch;
+    if (scratch) {
+        mark.used          = scratch->used;
+        mark.in_use        = scratch->in_use;
+        mark.overflow      = scratch->overflow;
+        mark.overflow_used = scratch->overflow ? scratch->overflow->used : 0;
+    }
+    return mark;
+}
+
+// releases all scratch memory that was allocated since the specified mark.
+static void _scratch_end(const ogt_voxel_meshify_context* ctx, const ogt_mesh_scratch_mark& mark) {
+    ogt_voxel_meshify_scratch* scratch = ctx->scratch;
+    if (!scratch)
+        return;
+    while (scratch->overflow != mark.overflow) {
+        ogt_mesh_scratch_block* block = scratch->overflow;
+        scratch->overflow = block->next;
+        _voxel_meshify_free(ctx, block);
+    }
+    if (scratch->overflow)
+        scratch->overflow->used = mark.overflow_used;
+    scratch->used   = mark.used;
+    scratch->in_use = mark.in_use;
+
+    // when the arena is no longer in use, grow the main block to fit the peak usage.
+    if (!scratch->in_use && scratch->peak > scratch->size) {
+        assert(!scratch->overflow);
+        _voxel_meshify_free(ctx, scratch->data);
+        scratch->data = (uint8_t*)_voxel_meshify_malloc(ctx, scratch->peak);
+        scratch->size = scratch->data ? scratch->peak : 0;
+    }
+}
+
+// allocates temporary memory from the scratch arena if the context has one, or from the context allocator otherwise. 
+static void* _scratch_alloc(const ogt_voxel_meshify_context* ctx, size_t size) {
+    ogt_voxel_meshify_scratch* scratch = ctx->scratch;
+    if (!scratch)
+        return _voxel_meshify_malloc(ctx, size);
+
+    size = (size + k_scratch_alignment - 1) & ~(k_scratch_alignment - 1);
+    scratch->in_use += size;
+    if (scratch->in_use > scratch->peak)
+        scratch->peak = scratch->in_use;
+
+    // allocate from the main block, as long as we haven't already overflowed it.
+    if (!scratch->overflow && scratch->used + size <= scratch->size) {
+        void* ptr = &scratch->data[scratch->used];
+        scratch->used += size;
+        return ptr;
+    }
+    // otherwise allocate from the current overflow block or a new one.
+    ogt_mesh_scratch_block* block = scratch->overflow;
+    if (!block || block->used + size > block->size) {
+        size_t block_header_size = (sizeof(ogt_mesh_scratch_block) + k_scratch_alignment - 1) & ~(k_scratch_alignment - 1);
+        size_t block_size = size > scratch->size ? size : scratch->size;
+        block = (ogt_mesh_scratch_block*)_voxel_meshify_malloc(ctx, block_header_size + block_size);
+        if (!block) {
+            scratch->in_use -= size;
+            return NULL;
+        }
+        block->next = scratch->overflow;
+        block->size = block_header_size + block_size;
+        block->used = block_header_size;
+        scratch->overflow = block;
+    }
+    void* ptr = &((uint8_t*)block)[block->used];
+    block->used += size;
+    return ptr;
+}
+
+// frees memory returned by _scratch_alloc. Memory from the scratch arena is only released by _scratch_end.
+static void _scratch_free(const ogt_voxel_meshify_context* ctx, void* ptr) {
+    if (!ctx->scratch)
+        _voxel_meshify_free(ctx, ptr);
 }
 
 inline ogt_mesh_vec3 _make_vec3(float x, float y, float z ) {
@@ -260,8 +740,60 @@ inline ogt_mesh_vec3 _make_vec3(float x, float y, float z ) {
     return ret;
 }
 
-static inline const ogt_mesh_vec3* _make_vec3_ptr(const float* xyz_elements) {
-    return (ogt_mesh_vec3*)xyz_elements;
+// One of the six directions that faces can point in. The greedy and polygon meshers work on slices of voxels that are
+// perpendicular to the face direction, in a local space where x,y are within a slice and z goes across slices.
+struct ogt_mesh_face_direction {
+    uint32_t axis_x;        // the axis of the voxel grid (0=x, 1=y, 2=z) along local x
+    uint32_t axis_y;        // the axis of the voxel grid along local y
+    uint32_t axis_z;        // the axis of the voxel grid along local z, which faces point along.
+    bool     is_negative;   // faces point toward -axis_z. Local z runs backward through the grid, which also flips the winding.
+};
+
+// the face directions, in the order that they are meshed.
+static const ogt_mesh_face_direction k_face_directions[6] = {
+    { 2, 0, 1, false },     // +Y
+    { 2, 0, 1, true  },     // -Y
+    { 1, 2, 0, false },     // +X
+    { 1, 2, 0, true  },     // -X
+    { 0, 1, 2, false },     // +Z
+    { 0, 1, 2, true  },     // -Z
+};
+
+// One of the entries of k_face_directions as compile time constants. The greedy and polygon kernels are instantiated once for each
+// face direction, so that converting local positions to the voxel grid folds into plain register moves, and the sign of the 
+// direction is never tested inside their loops.
+template <uint32_t AXIS_X, uint32_t AXIS_Y, uint32_t AXIS_Z, bool IS_NEGATIVE>
+struct ogt_mesh_face_direction_t {
+    static const uint32_t k_axis_z      = AXIS_Z;
+    static const bool     k_is_negative = IS_NEGATIVE;
+
+    // converts a local position for the face direction into a voxel grid position. size_z is the number of slices in the direction.
+    static inline ogt_mesh_vec3 point(int32_t x, int32_t y, int32_t z, int32_t size_z) {
+        const float local_x = (float)x;
+        const float local_y = (float)y;
+        const float local_z = (float)(IS_NEGATIVE ? size_z - z : z);
+        return _make_vec3(
+            AXIS_X == 0 ? local_x : (AXIS_Y == 0 ? local_y : local_z),
+            AXIS_X == 1 ? local_x : (AXIS_Y == 1 ? local_y : local_z),
+            AXIS_X == 2 ? local_x : (AXIS_Y == 2 ? local_y : local_z));
+    }
+
+    static inline ogt_mesh_vec3 normal() {
+        const float sign = IS_NEGATIVE ? -1.0f : 1.0f;
+        return _make_vec3(AXIS_Z == 0 ? sign : 0.0f, AXIS_Z == 1 ? sign : 0.0f, AXIS_Z == 2 ? sign : 0.0f);
+    }
+};
+
+typedef ogt_mesh_face_direction_t<1, 2, 0, false> ogt_mesh_face_direction_pos_x;
+typedef ogt_mesh_face_direction_t<1, 2, 0, true>  ogt_mesh_face_direction_neg_x;
+typedef ogt_mesh_face_direction_t<2, 0, 1, false> ogt_mesh_face_direction_pos_y;
+typedef ogt_mesh_face_direction_t<2, 0, 1, true>  ogt_mesh_face_direction_neg_y;
+typedef ogt_mesh_face_direction_t<0, 1, 2, false> ogt_mesh_face_direction_pos_z;
+typedef ogt_mesh_face_direction_t<0, 1, 2, true>  ogt_mesh_face_direction_neg_z;
+
+// returns the ogt_mesh_direction that faces of the face direction point in.
+static inline uint32_t _face_direction_mesh_direction(const ogt_mesh_face_direction& direction) {
+    return (direction.axis_z * 2) + (direction.is_negative ? 1 : 0);
 }
 
 static inline float _dot3(const ogt_mesh_vec3& a, const ogt_mesh_vec3& b) {
@@ -307,6 +839,12 @@ static inline ogt_mesh_vertex _mesh_make_vertex(const ogt_mesh_vec3& pos, const
     ret.normal = normal;
     ret.color  = color;
     ret.palette_index = palette_index;
+#ifdef OGT_VOXEL_MESHIFY_VERTEX_AO
+    ret.ao       = 3;
+    ret.reserved[0] = 0;
+    ret.reserved[1] = 0;
+    ret.reserved[2] = 0;
+#endif
     return ret;
 }
 
@@ -314,38 +852,225 @@ static inline ogt_mesh_vertex _mesh_make_vertex(float pos_x, float pos_y, float
     return _mesh_make_vertex(_make_vec3(pos_x, pos_y, pos_z), _make_vec3(normal_x, normal_y, normal_z), color, palette_index);
 }
 
-// counts the number of voxel sized faces that are needed for this voxel grid.
-static uint32_t _count_voxel_sized_faces( const uint8_t* voxels, uint32_t size_x, uint32_t size_y, uint32_t size_z ) {
-    const int32_t k_stride_x = 1;
-    const int32_t k_stride_y = size_x;
-    const int32_t k_stride_z = size_x * size_y;
-    const int32_t k_max_x = size_x - 1;
-    const int32_t k_max_y = size_y - 1;
-    const int32_t k_max_z = size_z - 1;
-
-    uint32_t face_count  = 0;
-        
-    const uint8_t* current_voxel = voxels;
-    for (int32_t k = 0; k < (int32_t)size_z; k++)
+// returns the ambient occlusion at the corner pos of a face that points along +axis, or -axis if is_negative. It only depends 
+// on the 4 voxels around the corner in the layer in front of the face, at least one of which is the empty voxel in front of 
+// the face itself, so every face that touches the corner in the same direction agrees on it. Voxels outside the grid are empty.
+static uint8_t _voxel_corner_ao(const ogt_mesh_voxel_model& grid, uint32_t axis, bool is_negative, const ogt_mesh_vec3& pos) {
+    const int32_t sizes[3]   = { (int32_t)grid.size_x, (int32_t)grid.size_y, (int32_t)grid.size_z };
+    const int32_t strides[3] = { 1, (int32_t)grid.size_x, (int32_t)(grid.size_x * grid.size_y) };
+    const int32_t corner[3]  = { (int32_t)pos.x, (int32_t)pos.y, (int32_t)pos.z };
+    const uint32_t axis_u = (axis + 1) % 3;
+    const uint32_t axis_v = (axis + 2) % 3;
+    const int32_t layer = is_negative ? corner[axis] - 1 : corner[axis];
+    if (layer < 0 || layer >= sizes[axis])
+        return 3;
+
+    // solid[b * 2 + a] is whether the voxel at (corner_u - 1 + a, corner_v - 1 + b) in the layer is solid.
+    bool solid[4];
+    for (int32_t b = 0; b < 2; b++) {
+        for (int32_t a = 0; a < 2; a++) {
+            int32_t u = corner[axis_u] - 1 + a;
+            int32_t v = corner[axis_v] - 1 + b;
+            solid[b * 2 + a] = u >= 0 && u < sizes[axis_u] && v >= 0 && v < sizes[axis_v] && 
+                grid.voxels[(layer * strides[axis]) + (u * strides[axis_u]) + (v * strides[axis_v])] != 0;
+        }
+    }
+    if ((solid[0] && solid[3]) || (solid[1] && solid[2]))
+        return 0;
+    return (uint8_t)(3 - (solid[0] + solid[1] + solid[2] + solid[3]));
+}
+
+// returns the grid that meshers compute vertex ao from, or NULL if ao is disabled in the context or not compiled in.
+static inline const ogt_mesh_voxel_model* _get_ao_grid(const ogt_voxel_meshify_context* ctx, const ogt_mesh_voxel_model& grid) {
+#ifdef OGT_VOXEL_MESHIFY_VERTEX_AO
+    return ctx->ambient_occlusion ? &grid : NULL;
+#else
+    (void)ctx; (void)grid;
+    return NULL;
+#endif
+}
+
+// computes the ao of a vertex of an axis aligned face from its position and normal.
+static inline void _set_vertex_ao(const ogt_mesh_voxel_model& grid, ogt_mesh_vertex& vertex) {
+#ifdef OGT_VOXEL_MESHIFY_VERTEX_AO
+    const ogt_mesh_vec3& n = vertex.normal;
+    const uint32_t axis = (n.x != 0.0f) ? 0 : ((n.y != 0.0f) ? 1 : 2);
+    vertex.ao = _voxel_corner_ao(grid, axis, (n.x + n.y + n.z) < 0.0f, vertex.pos);
+#else
+    (void)grid; (void)vertex;
+#endif
+}
+
+// a quad is triangulated as indices [A,B,C,C,D,A] along the diagonal A-C. If the ao along the other diagonal is higher, the 
+// quad is triangulated as [B,C,D,D,A,B] instead, so that occluded corners only darken one triangle and ao interpolates 
+// symmetrically. Vertex indices are relative to vertices[-base_vertex_index].
+static inline void _orient_quad_for_ao(uint32_t* quad_indices, const ogt_mesh_vertex* vertices, uint32_t base_vertex_index) {
+#ifdef OGT_VOXEL_MESHIFY_VERTEX_AO
+    const uint32_t a = quad_indices[0], b = quad_indices[1], c = quad_indices[2], d = quad_indices[4];
+    if (vertices[a - base_vertex_index].ao + vertices[c - base_vertex_index].ao < vertices[b - base_vertex_index].ao + vertices[d - base_vertex_index].ao) {
+        quad_indices[0] = b; quad_indices[1] = c; quad_indices[2] = d;
+        quad_indices[3] = d; quad_indices[4] = a; quad_indices[5] = b;
+    }
+#else
+    (void)quad_indices; (void)vertices; (void)base_vertex_index;
+#endif
+}
+
+// returns the number of bits that are set in the specified value.
+static inline uint32_t _popcount64(uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+    return (uint32_t)__builtin_popcountll(value);
+#else
+    value = value - ((value >> 1) & 0x5555555555555555ull);
+    value = (value & 0x3333333333333333ull) + ((value >> 2) & 0x3333333333333333ull);
+    value = (value + (value >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+    return (uint32_t)((value * 0x0101010101010101ull) >> 56);
+#endif
+}
+
+// returns the index of the lowest bit that is set in the specified value. value must be non-zero.
+static inline uint32_t _bit_scan_forward64(uint64_t value) {
+    assert(value != 0);
+#if defined(__GNUC__) || defined(__clang__)
+    return (uint32_t)__builtin_ctzll(value);
+#else
+    uint32_t index = 0;
+    while (!(value & 0xFFFF)) { value >>= 16; index += 16; }
+    while (!(value & 1))      { value >>= 1;  index += 1;  }
+    return index;
+#endif
+}
+
+// builds the occupancy mask for a run of up to 64 voxels. Bit n of the result is set if voxels[n] is solid.
+// This is the cheap pre-pass used by face counting and by the meshers to skip empty space a row at a time.
+static inline uint64_t _voxel_occupancy_mask64(const uint8_t* voxels, uint32_t count) {
+    assert(count <= 64);
+    uint64_t mask = 0;
+    uint32_t i = 0;
+#if defined(_OGT_VOXEL_MESHIFY_SSE2)
+    // compare 16 voxels at a time against zero and gather the results into 16 bits of the mask.
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= count; i += 16) {
+        __m128i  voxels16   = _mm_loadu_si128((const __m128i*)&voxels[i]);
+        uint32_t empty_bits = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(voxels16, zero));
+        mask |= (uint64_t)(~empty_bits & 0xFFFF) << i;
+    }
+#endif
+#if defined(_OGT_VOXEL_MESHIFY_LITTLE_ENDIAN)
+    // test 8 voxels at a time for being non-zero within a 64-bit word, then gather the top bit of each byte into 8 bits of the mask.
+    for (; i + 8 <= count; i += 8) {
+        uint64_t voxels8;
+        memcpy(&voxels8, &voxels[i], sizeof(voxels8));
+        uint64_t solid_bytes = (((voxels8 & 0x7F7F7F7F7F7F7F7Full) + 0x7F7F7F7F7F7F7F7Full) | voxels8) & 0x8080808080808080ull;
+        mask |= (((solid_bytes >> 7) * 0x0102040810204080ull) >> 56) << i;
+    }
+#endif
+    for (; i < count; i++)
+        mask |= (uint64_t)(voxels[i] != 0) << i;
+    return mask;
+}
+
+// the visible faces for a run of up to 64 voxels along x starting at voxel (i,j,k). bit n of each mask refers to voxel (i+n,j,k)
+struct ogt_mesh_face_masks {
+    uint64_t neg_x, pos_x;
+    uint64_t neg_y, pos_y;
+    uint64_t neg_z, pos_z;
+};
+
+// computes which faces are visible for a run of up to 64 voxels by comparing the run against its shifted self and the
+// adjacent runs in the neighboring rows and slices. Neighbors outside of the voxel grid are treated as empty.
+static inline ogt_mesh_face_masks _get_voxel_face_masks(const uint8_t* voxels, uint32_t size_x, uint32_t size_y, uint32_t size_z, uint32_t i, uint32_t j, uint32_t k, uint32_t count) {
+    const uint32_t k_stride_y = size_x;
+    const uint32_t k_stride_z = size_x * size_y;
+    const uint8_t* run = &voxels[i + (j * k_stride_y) + (k * k_stride_z)];
+
+    uint64_t solid  = _voxel_occupancy_mask64(run, count);
+    uint64_t prev_x = (solid << 1) | (uint64_t)((i > 0)                && (run[-1] != 0));
+    uint64_t next_x = (solid >> 1) | ((uint64_t)((i + count < size_x) && (run[count] != 0)) << (count - 1));
+    uint64_t prev_y = (j > 0)          ? _voxel_occupancy_mask64(run - k_stride_y, count) : 0;
+    uint64_t next_y = (j + 1 < size_y) ? _voxel_occupancy_mask64(run + k_stride_y, count) : 0;
+    uint64_t prev_z = (k > 0)          ? _voxel_occupancy_mask64(run - k_stride_z, count) : 0;
+    uint64_t next_z = (k + 1 < size_z) ? _voxel_occupancy_mask64(run + k_stride_z, count) : 0;
+
+    ogt_mesh_face_masks ret;
+    ret.neg_x = solid & ~prev_x;
+    ret.pos_x = solid & ~next_x;
+    ret.neg_y = solid & ~prev_y;
+    ret.pos_y = solid & ~next_y;
+    ret.neg_z = solid & ~prev_z;
+    ret.pos_z = solid & ~next_z;
+    return ret;
+}
+
+// counts the number of voxel sized faces that are needed for this voxel grid in each ogt_mesh_direction, and returns the total.
+// There is a face between two adjacent voxels when exactly one of them is solid, so we count faces a row of 64 voxels
+// at a time via popcount(row & ~neighbor_row) and popcount(neighbor_row & ~row) against the previous row and previous slice, 
+// and against row << 1 within the row itself. Faces on the boundary of the grid are just a popcount of the boundary rows.
+static uint32_t _count_voxel_sized_faces_per_direction( const uint8_t* voxels, uint32_t size_x, uint32_t size_y, uint32_t size_z, uint32_t* direction_face_counts ) {
+    const uint32_t k_stride_y = size_x;
+    const uint32_t k_stride_z = size_x * size_y;
+
+    uint32_t pos_x = 0, neg_x = 0, pos_y = 0, neg_y = 0, pos_z = 0, neg_z = 0;
+    for (uint32_t k = 0; k < size_z; k++)
     {
-        for (int32_t j = 0; j < (int32_t)size_y; j++)
+        for (uint32_t j = 0; j < size_y; j++)
         {
-            for (int32_t i = 0; i < (int32_t)size_x; i++, current_voxel++)
+            const uint8_t* row = &voxels[(j * k_stride_y) + (k * k_stride_z)];
+            uint64_t last_solid = 0;  // whether the voxel preceding the current run of 64 voxels is solid.
+            for (uint32_t i = 0; i < size_x; i += 64)
             {
-                if (current_voxel[0] != 0) // voxel is not empty.
-                {
-                    // check each of the -X,+X,-Y,+Y,-Z,+Z directions to see if a face is needed in that direction.
-                    face_count += ((i == 0)       || (current_voxel[-k_stride_x] == 0 )) ? 1 : 0; // if on min x boundary of voxel grid, or neighbor to -1 on x is empty
-                    face_count += ((i == k_max_x) || (current_voxel[ k_stride_x] == 0 )) ? 1 : 0; // if on max x boundary of voxel grid, or neighbor to +1 on x is empty
-                    face_count += ((j == 0)       || (current_voxel[-k_stride_y] == 0 )) ? 1 : 0; // if on min y boundary of voxel grid, or neighbor to -1 on y is empty
-                    face_count += ((j == k_max_y) || (current_voxel[ k_stride_y] == 0 )) ? 1 : 0; // if on max y boundary of voxel grid, or neighbor to +1 on y is empty
-                    face_count += ((k == 0)       || (current_voxel[-k_stride_z] == 0 )) ? 1 : 0; // if on min z boundary of voxel grid, or neighbor to -1 on z is empty
-                    face_count += ((k == k_max_z) || (current_voxel[ k_stride_z] == 0 )) ? 1 : 0; // if on max z boundary of voxel grid, or neighbor to +1 on z is empty
-                }
+                uint32_t count = (size_x - i) < 64 ? (size_x - i) : 64;
+                uint64_t solid = _voxel_occupancy_mask64(&row[i], count);
+                uint64_t run_mask = (count < 64) ? (((uint64_t)1 << count) - 1) : ~(uint64_t)0;
+
+                // -X/+X faces are the transitions between solid and empty along the row. A +X face is counted at the 
+                // voxel after the one it belongs to.
+                uint64_t previous_solid = (solid << 1) | last_solid;
+                neg_x += _popcount64(solid & ~previous_solid);
+                pos_x += _popcount64(~solid & previous_solid & run_mask);
+                last_solid = (solid >> (count - 1)) & 1;
+
+                // -Y/+Y faces against the previous row, or the grid boundary.
+                uint64_t below = (j > 0) ? _voxel_occupancy_mask64(&row[i] - k_stride_y, count) : 0;
+                neg_y += _popcount64(solid & ~below);
+                pos_y += _popcount64(below & ~solid);
+                pos_y += (j == size_y - 1) ? _popcount64(solid) : 0;
+
+                // -Z/+Z faces against the previous slice, or the grid boundary.
+                uint64_t behind = (k > 0) ? _voxel_occupancy_mask64(&row[i] - k_stride_z, count) : 0;
+                neg_z += _popcount64(solid & ~behind);
+                pos_z += _popcount64(behind & ~solid);
+                pos_z += (k == size_z - 1) ? _popcount64(solid) : 0;
             }
+            // +X face on the max x boundary of the grid.
+            pos_x += (uint32_t)last_solid;
         }
     }
-    return face_count;
+    direction_face_counts[ogt_mesh_direction_pos_x] = pos_x;
+    direction_face_counts[ogt_mesh_direction_neg_x] = neg_x;
+    direction_face_counts[ogt_mesh_direction_pos_y] = pos_y;
+    direction_face_counts[ogt_mesh_direction_neg_y] = neg_y;
+    direction_face_counts[ogt_mesh_direction_pos_z] = pos_z;
+    direction_face_counts[ogt_mesh_direction_neg_z] = neg_z;
+    return pos_x + neg_x + pos_y + neg_y + pos_z + neg_z;
+}
+
+// counts the number of voxel sized faces that are needed for this voxel grid.
+static uint32_t _count_voxel_sized_faces( const uint8_t* voxels, uint32_t size_x, uint32_t size_y, uint32_t size_z ) {
+    uint32_t direction_face_counts[ogt_mesh_direction_count];
+    return _count_voxel_sized_faces_per_direction(voxels, size_x, size_y, size_z, direction_face_counts);
+}
+
+// lays out the direction ranges of a mesh with the specified number of voxel sized faces in each direction, in direction order, 
+// and points each of the index cursors at the start of its direction's range.
+static void _init_direction_ranges(ogt_mesh* mesh, const uint32_t* direction_face_counts, uint32_t** direction_index_cursors) {
+    uint32_t index_offset = 0;
+    for (uint32_t d = 0; d < ogt_mesh_direction_count; d++) {
+        mesh->direction_ranges[d].index_offset = index_offset;
+        mesh->direction_ranges[d].index_count  = direction_face_counts[d] * 6;
+        direction_index_cursors[d] = &mesh->indices[index_offset];
+        index_offset += direction_face_counts[d] * 6;
+    }
 }
 
 
@@ -367,31 +1092,6 @@ static uint32_t murmur_hash2_size4(uint32_t h, const uint32_t* data, uint32_t da
     return h;
 }
 
-// quadratic probing in the hash table.
-static uint32_t* hash_table_find_vertex(uint32_t* table, uint32_t table_index_mask, const uint8_t* vertex_data, uint32_t vertex_size, uint32_t vertex_index) {
-    uint32_t* this_vertex  = (uint32_t*)&vertex_data[vertex_index*vertex_size];
-    uint32_t  bucket_index = murmur_hash2_size4(0, this_vertex, vertex_size) & table_index_mask;
-
-    for (uint32_t probe_count = 0; probe_count <= table_index_mask; probe_count++) {
-        uint32_t* existing_index = &table[bucket_index];
-        // if there is an uninitialized value at this bucket, the vertex is definitely not already in the hash table.
-        if (*existing_index == UINT32_MAX)
-            return existing_index;
-        // this item is potentially in the table, we compare to see if the existing vertex matches the one we're trying to find.
-        uint32_t* existing_vertex = (uint32_t*)&vertex_data[*existing_index*vertex_size];
-        if (memcmp(this_vertex, existing_vertex, vertex_size) == 0) {
-            assert(*existing_index < vertex_index);
-            return existing_index;
-        }
-        // use quadratic probing to find the next bucket in the case of a collision.
-        bucket_index = (bucket_index + probe_count + 1) & table_index_mask;
-    }
-    // hash table is full. We should technically never get here because we always allocate more buckets in the table than vertices we search for.
-    assert(false); 
-    return NULL;
-}
-
-
 // quadratic probing in the hash table 
 static uint32_t* hash_table_find_vertex_position(uint32_t* table, uint32_t table_index_mask, const ogt_mesh_vertex* vertex_data, uint32_t vertex_index) {
     const ogt_mesh_vertex* this_vertex = &vertex_data[vertex_index];
@@ -416,78 +1116,325 @@ static uint32_t* hash_table_find_vertex_position(uint32_t* table, uint32_t table
     return NULL;
 }
 
+// an entry in a vertex hash table. 
+struct ogt_mesh_weld_entry {
+    uint32_t hash;          // hash of the vertex, so most mismatches can be rejected without looking at the vertex.
+    uint32_t index;         // index of the vertex. In a hash table this is the index of the first vertex with this value within 
+                            // partition_vertices instead, or UINT32_MAX if the entry is empty.
+};
+
+// state shared by all of the jobs of ogt_mesh_remove_duplicate_vertices and ogt_mesh_smooth_normals_with_angle
+struct ogt_mesh_weld_job_data {
+    const ogt_mesh_vertex*  vertices;
+    uint32_t                vertex_count;
+    uint32_t*               indices;
+    uint32_t                index_count;
+    uint32_t*               hashes;                 // hash of each vertex
+    ogt_mesh_weld_entry*    partition_vertices;     // vertex hash/index grouped by partition, in ascending vertex order within each partition
+    ogt_mesh_vec3*          partition_positions;    // optional: if set, only positions are compared, and this holds the position of each entry in partition_vertices.
+    uint32_t*               partition_offsets;      // offset of each partition within partition_vertices, and within tables (x2)
+    ogt_mesh_weld_entry*    tables;                 // a hash table for each partition
+    uint32_t*               remap;                  // index of the first identical vertex for each vertex
+};
+
+// vertices are partitioned by hash so each partition can find its duplicates independently of all others.
+static const uint32_t k_weld_partition_count = 64;
+// how many vertices or indices are processed by a single hash or remap job.
+static const uint32_t k_weld_job_size = 16384;
+
+// hashes word_count 32-bit words.
+static inline uint32_t _hash_words(const uint32_t* words, uint32_t word_count) {
+    uint64_t h = 0;
+    for (uint32_t i = 0; i < word_count; i++)
+        h = (h ^ words[i]) * 0x9E3779B97F4A7C15ull;
+    return (uint32_t)(h ^ (h >> 32));
+}
+
+// hashes the full contents of a vertex.
+static inline uint32_t _hash_vertex(const ogt_mesh_vertex* vertex) {
+    uint32_t words[sizeof(ogt_mesh_vertex) / 4];
+    memcpy(words, vertex, sizeof(words));
+    return _hash_words(words, sizeof(ogt_mesh_vertex) / 4);
+}
+
+// hashes the position of a vertex.
+static inline uint32_t _hash_vertex_position(const ogt_mesh_vertex* vertex) {
+    uint32_t words[sizeof(ogt_mesh_vec3) / 4];
+    memcpy(words, &vertex->pos, sizeof(words));
+    return _hash_words(words, sizeof(ogt_mesh_vec3) / 4);
+}
+
+static void _weld_hash_job(uint32_t job_index, void* job_data) {
+    ogt_mesh_weld_job_data* data = (ogt_mesh_weld_job_data*)job_data;
+    uint32_t begin = job_index * k_weld_job_size;
+    uint32_t end   = (data->vertex_count - begin) < k_weld_job_size ? data->vertex_count : begin + k_weld_job_size;
+    if (data->partition_positions) {
+        for (uint32_t i = begin; i < end; i++)
+            data->hashes[i] = _hash_vertex_position(&data->vertices[i]);
+    }
+    else {
+        for (uint32_t i = begin; i < end; i++)
+            data->hashes[i] = _hash_vertex(&data->vertices[i]);
+    }
+}
+
+// whether the vertices at the specified entries of partition_vertices are identical.
+static inline bool _weld_is_same_vertex(const ogt_mesh_weld_job_data* data, uint32_t entry_a, uint32_t entry_b) {
+    if (data->partition_positions)
+        return memcmp(&data->partition_positions[entry_a], &data->partition_positions[entry_b], sizeof(ogt_mesh_vec3)) == 0;
+    return memcmp(&data->vertices[data->partition_vertices[entry_a].index], &data->vertices[data->partition_vertices[entry_b].index], sizeof(ogt_mesh_vertex)) == 0;
+}
+
+// finds the first occurrence of each vertex within a single partition using linear probing in a table with 2x as many entries as vertices.
+static void _weld_partition_job(uint32_t job_index, void* job_data) {
+    ogt_mesh_weld_job_data* data = (ogt_mesh_weld_job_data*)job_data;
+    uint32_t begin = data->partition_offsets[job_index];
+    uint32_t end   = data->partition_offsets[job_index + 1];
+    if (begin == end)
+        return;
+    ogt_mesh_weld_entry* table = &data->tables[begin * 2];
+    uint32_t table_size = (end - begin) * 2;
+    memset(table, -1, table_size * sizeof(ogt_mesh_weld_entry));
+
+    for (uint32_t i = begin; i < end; i++) {
+        uint32_t vertex_index = data->partition_vertices[i].index;
+        uint32_t hash = data->partition_vertices[i].hash;
+        uint32_t bucket_index = (uint32_t)(((uint64_t)hash * table_size) >> 32);
+        for (;;) {
+            ogt_mesh_weld_entry* entry = &table[bucket_index];
+            // if there is an empty entry here, the vertex is definitely not already in the hash table.
+            if (entry->index == UINT32_MAX) {
+                entry->hash  = hash;
+                entry->index = i;
+                data->remap[vertex_index] = vertex_index;
+                break;
+            }
+            // only compare vertex contents if the hash matches.
+            if (entry->hash == hash && _weld_is_same_vertex(data, entry->index, i)) {
+                assert(entry->index < i);
+                data->remap[vertex_index] = data->partition_vertices[entry->index].index;
+                break;
+            }
+            if (++bucket_index == table_size)
+                bucket_index = 0;
+        }
+    }
+}
+
+static void _weld_remap_indices_job(uint32_t job_index, void* job_data) {
+    ogt_mesh_weld_job_data* data = (ogt_mesh_weld_job_data*)job_data;
+    uint32_t begin = job_index * k_weld_job_size;
+    uint32_t end   = (data->index_count - begin) < k_weld_job_size ? data->index_count : begin + k_weld_job_size;
+    for (uint32_t i = begin; i < end; i++)
+        data->indices[i] = data->remap[data->indices[i]];
+}
+
+// finds the first vertex that is identical to each vertex, and writes its index to data.remap. 
+static void _weld_find_first_occurrences(const ogt_voxel_meshify_context* ctx, ogt_mesh_weld_job_data& data) {
+    uint32_t vertex_count = data.vertex_count;
+
+    // hash all vertices.
+    _voxel_meshify_parallel_for(ctx, _weld_hash_job, &data, (vertex_count + k_weld_job_size - 1) / k_weld_job_size);
+
+    // group vertex indices by partition, preserving their order within each partition. Identical vertices have identical 
+    // hashes so they always end up in the same partition. When only comparing positions, the positions are copied alongside 
+    // so each partition can be processed without touching the vertices at all.
+    uint32_t partition_cursors[k_weld_partition_count];
+    memset(partition_cursors, 0, sizeof(partition_cursors));
+    for (uint32_t i = 0; i < vertex_count; i++)
+        partition_cursors[data.hashes[i] % k_weld_partition_count]++;
+    uint32_t partition_offset = 0;
+    for (uint32_t p = 0; p < k_weld_partition_count; p++) {
+        uint32_t partition_size = partition_cursors[p];
+        data.partition_offsets[p] = partition_offset;
+        partition_cursors[p] = partition_offset;
+        partition_offset += partition_size;
+    }
+    data.partition_offsets[k_weld_partition_count] = partition_offset;
+    for (uint32_t i = 0; i < vertex_count; i++) {
+        uint32_t entry_index = partition_cursors[data.hashes[i] % k_weld_partition_count]++;
+        ogt_mesh_weld_entry* entry = &data.partition_vertices[entry_index];
+        entry->hash  = data.hashes[i];
+        entry->index = i;
+        if (data.partition_positions)
+            data.partition_positions[entry_index] = data.vertices[i].pos;
+    }
+
+    // find the first occurrence of each vertex.
+    _voxel_meshify_parallel_for(ctx, _weld_partition_job, &data, k_weld_partition_count);
+}
+
+// the number of bytes of scratch memory needed by _weld_setup_job_data
+static size_t _weld_get_scratch_size(uint32_t vertex_count, bool positions_only) {
+    return (sizeof(ogt_mesh_weld_entry) * vertex_count * 3) + (sizeof(uint32_t) * vertex_count * 2) + (sizeof(uint32_t) * (k_weld_partition_count + 1)) + 
+           (positions_only ? sizeof(ogt_mesh_vec3) * vertex_count : 0);
+}
+
+// sets up job data for _weld_find_first_occurrences to use the specified scratch memory.
+static void _weld_setup_job_data(ogt_mesh_weld_job_data& data, void* scratch, ogt_mesh* mesh, bool positions_only) {
+    uint32_t vertex_count    = mesh->vertex_count;
+    data.vertices            = mesh->vertices;
+    data.vertex_count        = vertex_count;
+    data.indices             = mesh->indices;
+    data.index_count         = mesh->index_count;
+    data.tables              = (ogt_mesh_weld_entry*)scratch;
+    data.partition_vertices  = &data.tables[vertex_count * 2];
+    data.hashes              = (uint32_t*)&data.partition_vertices[vertex_count];
+    data.remap               = &data.hashes[vertex_count];
+    data.partition_offsets   = &data.remap[vertex_count];
+    data.partition_positions = positions_only ? (ogt_mesh_vec3*)&data.partition_offsets[k_weld_partition_count + 1] : NULL;
+}
+
 // removes duplicate vertices in-place from the specified mesh.
 void ogt_mesh_remove_duplicate_vertices(const ogt_voxel_meshify_context* ctx, ogt_mesh* mesh) {
     
-    uint32_t* indices      = mesh->indices;
-    uint32_t  index_count  = mesh->index_count;
-    uint8_t*  vertices     = (uint8_t*)mesh->vertices;
-    uint32_t  vertex_count = mesh->vertex_count;
-    uint32_t  vertex_size  = sizeof(ogt_mesh_vertex);
-    assert(indices && index_count && vertices && vertex_count && vertex_size);
-    
-    // allocate a hash table that is sized at the next power of 2 above the vertex count
-    uint32_t hash_table_size = 1;
-    while (hash_table_size < vertex_count)
-        hash_table_size *= 2;
-    uint32_t hash_table_mask = hash_table_size - 1;
-    uint32_t* hash_table = (uint32_t*)_voxel_meshify_malloc(ctx, sizeof(uint32_t) * hash_table_size);
-    memset(hash_table, -1, hash_table_size * sizeof(uint32_t));
-
-    // generate an remap table for vertex indices
-    uint32_t* remap_indices = (uint32_t*)_voxel_meshify_malloc(ctx, sizeof(uint32_t) * vertex_count);
-    memset(remap_indices, -1, vertex_count * sizeof(uint32_t));
+    uint32_t         vertex_count = mesh->vertex_count;
+    ogt_mesh_vertex* vertices     = mesh->vertices;
+    if (!vertex_count)
+        return;
+
+    // everything we need fits in a single allocation. 
+    ogt_mesh_scratch_mark scratch_mark = _scratch_begin(ctx);
+    void* weld_scratch = _scratch_alloc(ctx, _weld_get_scratch_size(vertex_count, false));
+    if (!weld_scratch) {
+        _scratch_end(ctx, scratch_mark);
+        return;
+    }
+
+    ogt_mesh_weld_job_data data;
+    _weld_setup_job_data(data, weld_scratch, mesh, false);
+    _weld_find_first_occurrences(ctx, data);
+
+    // assign unique indices in order of first occurrence and compact the vertices. The first occurrence of a vertex 
+    // always comes before all of its duplicates, so its remap entry will already hold its unique index.
     uint32_t num_unique_vertices = 0;
-    for (uint32_t vertex_index = 0; vertex_index < vertex_count; vertex_index++) {
-        uint32_t* hash_table_entry = hash_table_find_vertex(hash_table, hash_table_mask, vertices, vertex_size, vertex_index);
-        if (*hash_table_entry == UINT32_MAX) {
-            // vertex is not already in the hash table. allocate a unique index for it.
-            *hash_table_entry = vertex_index;;
-            remap_indices[vertex_index] = num_unique_vertices++;
+    for (uint32_t i = 0; i < vertex_count; i++) {
+        uint32_t first_index = data.remap[i];
+        if (first_index == i) {
+            assert(num_unique_vertices <= i);
+            vertices[num_unique_vertices] = vertices[i];
+            data.remap[i] = num_unique_vertices++;
         }
         else {
-            // vertex is already in the hash table. Point this to the index that is already existing!
-            assert(remap_indices[*hash_table_entry] != UINT32_MAX);
-            remap_indices[vertex_index] = remap_indices[*hash_table_entry];
+            data.remap[i] = data.remap[first_index];
         }
     }
 
-    // compact all vertices using the remap_indices map.
-    for (uint32_t i = 0; i < vertex_count; i++) {
-        uint32_t dst_index = remap_indices[i];
-        uint32_t src_index = i;
-        assert(dst_index <= src_index);
-        memcpy(&vertices[dst_index*vertex_size], &vertices[src_index*vertex_size], vertex_size);
-    }
     // remap all indices now
-    for (uint32_t i = 0; i < index_count; i++) {
-        indices[i] = remap_indices[indices[i]];
-    }
+    _voxel_meshify_parallel_for(ctx, _weld_remap_indices_job, &data, (mesh->index_count + k_weld_job_size - 1) / k_weld_job_size);
 
-    _voxel_meshify_free(ctx, hash_table);
-    _voxel_meshify_free(ctx, remap_indices);
+    _scratch_free(ctx, weld_scratch);
+    _scratch_end(ctx, scratch_mark);
 
     assert(num_unique_vertices <= mesh->vertex_count);
     mesh->vertex_count = num_unique_vertices;
 }
 
-// resets normals for the mesh so they are based on triangle connectivity, while preserving triangle colors.
-void ogt_mesh_smooth_normals(const ogt_voxel_meshify_context* ctx, ogt_mesh* mesh) {
-    // generate an remap table for vertex indices based on the vertex positions.
-    uint32_t* remap_indices = (uint32_t*)_voxel_meshify_malloc(ctx, sizeof(uint32_t) * mesh->vertex_count);
-    memset(remap_indices, -1, mesh->vertex_count * sizeof(uint32_t));
-    {
-        // allocate a hash table that is sized at the next power of 2 above the vertex count
-        uint32_t hash_table_size = 1;
-        while (hash_table_size < mesh->vertex_count)
-            hash_table_size *= 2;
-        uint32_t hash_table_mask = hash_table_size - 1;
-        uint32_t* hash_table = (uint32_t*)_voxel_meshify_malloc(ctx, sizeof(uint32_t) * hash_table_size);
-        memset(hash_table, -1, hash_table_size * sizeof(uint32_t));
+// state shared by all of the jobs of ogt_mesh_smooth_normals_with_angle
+struct ogt_mesh_smooth_job_data {
+    ogt_mesh_vertex*        vertices;
+    uint32_t                vertex_count;
+    const uint32_t*         indices;
+    uint32_t                triangle_count;
+    uint32_t                position_count;         // number of unique vertex positions
+    const uint32_t*         position_ids;           // the unique position of each vertex, numbered in order of first occurrence
+    const uint32_t*         position_offsets;       // offset of the triangles adjacent to each position within position_triangles
+    const uint32_t*         position_triangles;     // triangles adjacent to each position, grouped by position and in ascending order
+    ogt_mesh_vec3*          face_normals;           // area weighted normal of each triangle
+    ogt_mesh_vec3*          position_normals;       // the accumulated normal at each position, when there is no angle threshold.
+    float                   min_cos_angle;          // cosine of the angle threshold
+    bool                    use_angle;              // whether there is an angle threshold.
+};
 
-        // create a unique mapping for each vertex based purely on its position
-        uint32_t num_unique_vertices = 0;
-        for (uint32_t vertex_index = 0; vertex_index < mesh->vertex_count; vertex_index++) {
+// how many triangles, positions or vertices are processed by a single smoothing job.
+static const uint32_t k_smooth_job_size = 16384;
+
+static void _smooth_face_normals_job(uint32_t job_index, void* job_data) {
+    ogt_mesh_smooth_job_data* data = (ogt_mesh_smooth_job_data*)job_data;
+    uint32_t begin = job_index * k_smooth_job_size;
+    uint32_t end   = (data->triangle_count - begin) < k_smooth_job_size ? data->triangle_count : begin + k_smooth_job_size;
+    for (uint32_t t = begin; t < end; t++) {
+        const ogt_mesh_vec3& p0 = data->vertices[data->indices[t * 3 + 0]].pos;
+        const ogt_mesh_vec3& p1 = data->vertices[data->indices[t * 3 + 1]].pos;
+        const ogt_mesh_vec3& p2 = data->vertices[data->indices[t * 3 + 2]].pos;
+        data->face_normals[t] = _cross3(_sub3(p1, p0), _sub3(p2, p0));
+    }
+}
+
+// without an angle threshold, every vertex at a position gets the same normal so it is accumulated once per position.
+static void _smooth_position_normals_job(uint32_t job_index, void* job_data) {
+    ogt_mesh_smooth_job_data* data = (ogt_mesh_smooth_job_data*)job_data;
+    uint32_t begin = job_index * k_smooth_job_size;
+    uint32_t end   = (data->position_count - begin) < k_smooth_job_size ? data->position_count : begin + k_smooth_job_size;
+    for (uint32_t position_id = begin; position_id < end; position_id++) {
+        ogt_mesh_vec3 accumulated_normal = _make_vec3(0.0f, 0.0f, 0.0f);
+        for (uint32_t i = data->position_offsets[position_id]; i < data->position_offsets[position_id + 1]; i++)
+            accumulated_normal = _add3(accumulated_normal, data->face_normals[data->position_triangles[i]]);
+        data->position_normals[position_id] = accumulated_normal;
+    }
+}
+
+// sets the normal of each vertex to the normalized sum of the face normals at its position, or only those within the 
+// angle threshold of its existing normal. Vertices keep their existing normal if the sum is zero.
+static void _smooth_vertex_normals_job(uint32_t job_index, void* job_data) {
+    ogt_mesh_smooth_job_data* data = (ogt_mesh_smooth_job_data*)job_data;
+    uint32_t begin = job_index * k_smooth_job_size;
+    uint32_t end   = (data->vertex_count - begin) < k_smooth_job_size ? data->vertex_count : begin + k_smooth_job_size;
+    for (uint32_t vertex_index = begin; vertex_index < end; vertex_index++) {
+        uint32_t position_id = data->position_ids[vertex_index];
+        ogt_mesh_vec3 accumulated_normal;
+        if (data->use_angle) {
+            const ogt_mesh_vec3& vertex_normal = data->vertices[vertex_index].normal;
+            float min_dot = data->min_cos_angle * sqrtf(_dot3(vertex_normal, vertex_normal));
+            accumulated_normal = _make_vec3(0.0f, 0.0f, 0.0f);
+            for (uint32_t i = data->position_offsets[position_id]; i < data->position_offsets[position_id + 1]; i++) {
+                const ogt_mesh_vec3& face_normal = data->face_normals[data->position_triangles[i]];
+                if (_dot3(face_normal, vertex_normal) >= min_dot * sqrtf(_dot3(face_normal, face_normal)))
+                    accumulated_normal = _add3(accumulated_normal, face_normal);
+            }
+        }
+        else {
+            accumulated_normal = data->position_normals[position_id];
+        }
+        if (_dot3(accumulated_normal, accumulated_normal) > 0.001f)
+            data->vertices[vertex_index].normal = _normalize3(accumulated_normal);
+    }
+}
+
+// resets normals for the mesh so they are based on triangle connectivity, while preserving triangle colors.
+void ogt_mesh_smooth_normals(const ogt_voxel_meshify_context* ctx, ogt_mesh* mesh) {
+    // scattering face normals directly into positions is faster on a single thread, but it can't be split into jobs.
+    if (ctx->parallel_for_func) {
+        ogt_mesh_smooth_normals_with_angle(ctx, mesh, 180.0f);
+        return;
+    }
+    if (!mesh->vertex_count || !mesh->index_count)
+        return;
+    ogt_mesh_scratch_mark scratch_mark = _scratch_begin(ctx);
+    // generate an remap table for vertex indices based on the vertex positions.
+    uint32_t* remap_indices = (uint32_t*)_scratch_alloc(ctx, sizeof(uint32_t) * mesh->vertex_count);
+    if (!remap_indices) {
+        _scratch_end(ctx, scratch_mark);
+        return;
+    }
+    memset(remap_indices, -1, mesh->vertex_count * sizeof(uint32_t));
+    {
+        // allocate a hash table that is sized at the next power of 2 above the vertex count
+        uint32_t hash_table_size = 1;
+        while (hash_table_size < mesh->vertex_count)
+            hash_table_size *= 2;
+        uint32_t hash_table_mask = hash_table_size - 1;
+        uint32_t* hash_table = (uint32_t*)_scratch_alloc(ctx, sizeof(uint32_t) * hash_table_size);
+        if (!hash_table) {
+            _scratch_free(ctx, remap_indices);
+            _scratch_end(ctx, scratch_mark);
+            return;
+        }
+        memset(hash_table, -1, hash_table_size * sizeof(uint32_t));
+
+        // create a unique mapping for each vertex based purely on its position
+        uint32_t num_unique_vertices = 0;
+        for (uint32_t vertex_index = 0; vertex_index < mesh->vertex_count; vertex_index++) {
             uint32_t* hash_table_entry = hash_table_find_vertex_position(hash_table, hash_table_mask, mesh->vertices, vertex_index);
             if (*hash_table_entry == UINT32_MAX) {
                 // vertex is not already in the hash table. allocate a unique index for it.
@@ -501,11 +1448,16 @@ void ogt_mesh_smooth_normals(const ogt_voxel_meshify_context* ctx, ogt_mesh* mes
             }
         }
         // now that we have remap_indices, we no longer need the hash table. 
-        _voxel_meshify_free(ctx, hash_table);
+        _scratch_free(ctx, hash_table);
     }
 
     // for each triangle face, add the normal of the face to the unique normal for the vertex
-    ogt_mesh_vec3* remap_normals = (ogt_mesh_vec3*)_voxel_meshify_malloc(ctx, sizeof(ogt_mesh_vec3) * mesh->vertex_count);
+    ogt_mesh_vec3* remap_normals = (ogt_mesh_vec3*)_scratch_alloc(ctx, sizeof(ogt_mesh_vec3) * mesh->vertex_count);
+    if (!remap_normals) {
+        _scratch_free(ctx, remap_indices);
+        _scratch_end(ctx, scratch_mark);
+        return;
+    }
     memset(remap_normals, 0, sizeof(ogt_mesh_vec3) * mesh->vertex_count);
 
     for (uint32_t i = 0; i < mesh->index_count; i += 3) {
@@ -532,19 +1484,884 @@ void ogt_mesh_smooth_normals(const ogt_voxel_meshify_context* ctx, ogt_mesh* mes
             mesh->vertices[vertex_index].normal = _normalize3(accumulated_normal);
     }
 
-    _voxel_meshify_free(ctx, remap_normals);
-    _voxel_meshify_free(ctx, remap_indices);
+    _scratch_free(ctx, remap_normals);
+    _scratch_free(ctx, remap_indices);
+    _scratch_end(ctx, scratch_mark);
+}
+
+// Rather than scattering face normals into vertices, triangles are grouped by the positions of their corners with a counting 
+// sort, then normals are gathered from the triangles in each group. This lets everything but the sort run as independent jobs.
+void ogt_mesh_smooth_normals_with_angle(const ogt_voxel_meshify_context* ctx, ogt_mesh* mesh, float max_angle_degrees) {
+    uint32_t vertex_count   = mesh->vertex_count;
+    uint32_t triangle_count = mesh->index_count / 3;
+    if (!vertex_count || !triangle_count)
+        return;
+
+    ogt_mesh_scratch_mark scratch_mark = _scratch_begin(ctx);
+    void*          weld_scratch       = _scratch_alloc(ctx, _weld_get_scratch_size(vertex_count, true));
+    uint32_t*      position_offsets   = (uint32_t*)_scratch_alloc(ctx, sizeof(uint32_t) * (vertex_count + 1));
+    uint32_t*      position_triangles = (uint32_t*)_scratch_alloc(ctx, sizeof(uint32_t) * triangle_count * 3);
+    ogt_mesh_vec3* face_normals       = (ogt_mesh_vec3*)_scratch_alloc(ctx, sizeof(ogt_mesh_vec3) * triangle_count);
+    bool use_angle = max_angle_degrees < 180.0f;
+    ogt_mesh_vec3* position_normals   = use_angle ? NULL : (ogt_mesh_vec3*)_scratch_alloc(ctx, sizeof(ogt_mesh_vec3) * vertex_count);
+
+    if (weld_scratch && position_offsets && position_triangles && face_normals && (use_angle || position_normals)) {
+        // find the first vertex with the same position as each vertex, then number the unique positions in order of first 
+        // occurrence, which keeps positions of nearby vertices nearby.
+        ogt_mesh_weld_job_data weld_data;
+        _weld_setup_job_data(weld_data, weld_scratch, mesh, true);
+        _weld_find_first_occurrences(ctx, weld_data);
+        uint32_t* position_ids = weld_data.remap;
+        uint32_t position_count = 0;
+        for (uint32_t i = 0; i < vertex_count; i++)
+            position_ids[i] = (position_ids[i] == i) ? position_count++ : position_ids[position_ids[i]];
+
+        ogt_mesh_smooth_job_data data;
+        data.vertices           = mesh->vertices;
+        data.vertex_count       = vertex_count;
+        data.indices            = mesh->indices;
+        data.triangle_count     = triangle_count;
+        data.position_count     = position_count;
+        data.position_ids       = position_ids;
+        data.position_offsets   = position_offsets;
+        data.position_triangles = position_triangles;
+        data.face_normals       = face_normals;
+        data.position_normals   = position_normals;
+        data.min_cos_angle      = cosf(max_angle_degrees * (3.14159265f / 180.0f));
+        data.use_angle          = use_angle;
+
+        _voxel_meshify_parallel_for(ctx, _smooth_face_normals_job, &data, (triangle_count + k_smooth_job_size - 1) / k_smooth_job_size);
+
+        // group the triangles by the positions of their corners. The scatter uses position_offsets as cursors, which moves 
+        // each offset to the start of the next group, so they are shifted back afterward.
+        memset(position_offsets, 0, sizeof(uint32_t) * (position_count + 1));
+        for (uint32_t i = 0; i < triangle_count * 3; i++)
+            position_offsets[position_ids[mesh->indices[i]] + 1]++;
+        for (uint32_t i = 0; i < position_count; i++)
+            position_offsets[i + 1] += position_offsets[i];
+        for (uint32_t i = 0; i < triangle_count * 3; i++)
+            position_triangles[position_offsets[position_ids[mesh->indices[i]]]++] = i / 3;
+        memmove(&position_offsets[1], &position_offsets[0], sizeof(uint32_t) * position_count);
+        position_offsets[0] = 0;
+
+        if (!use_angle)
+            _voxel_meshify_parallel_for(ctx, _smooth_position_normals_job, &data, (position_count + k_smooth_job_size - 1) / k_smooth_job_size);
+        _voxel_meshify_parallel_for(ctx, _smooth_vertex_normals_job, &data, (vertex_count + k_smooth_job_size - 1) / k_smooth_job_size);
+    }
+
+    _scratch_free(ctx, position_normals);
+    _scratch_free(ctx, face_normals);
+    _scratch_free(ctx, position_triangles);
+    _scratch_free(ctx, position_offsets);
+    _scratch_free(ctx, weld_scratch);
+    _scratch_end(ctx, scratch_mark);
+}
+
+// returns whether the direction ranges of the mesh cover all of its indices.
+static bool _has_direction_ranges(const ogt_mesh* mesh) {
+    uint32_t index_count = 0;
+    for (uint32_t d = 0; d < ogt_mesh_direction_count; d++)
+        index_count += mesh->direction_ranges[d].index_count;
+    return index_count && index_count == mesh->index_count;
+}
+
+// the size of the simulated post-transform vertex cache when the caller passes 0.
+static const uint32_t k_default_vertex_cache_size = 16;
+
+// a run of triangles in the output of _tipsify_triangles that starts with a cold vertex cache, so runs can be drawn in any 
+// order for almost no cost in cache reuse.
+struct ogt_mesh_triangle_cluster {
+    uint32_t first_triangle;
+    uint32_t triangle_count;
+    float    sort_key;          // how far the cluster faces out from the center of the mesh.
+};
+
+static int _compare_triangle_clusters(const void* lhs, const void* rhs) {
+    const ogt_mesh_triangle_cluster* a = (const ogt_mesh_triangle_cluster*)lhs;
+    const ogt_mesh_triangle_cluster* b = (const ogt_mesh_triangle_cluster*)rhs;
+    if (a->sort_key != b->sort_key) return a->sort_key > b->sort_key ? -1 : 1;
+    return a->first_triangle < b->first_triangle ? -1 : (a->first_triangle > b->first_triangle ? 1 : 0);
+}
+
+// Reorders triangles for vertex cache reuse with Tipsify (Sander, Nehab & Barczak, "Fast Triangle Reordering for Vertex Locality 
+// and Reduced Overdraw", 2007). Triangles are emitted as fans around one vertex at a time. The next vertex to fan around is the 
+// vertex from the last fan that has been in the cache longest, but will still be in the cache once its remaining triangles are 
+// emitted. When there is none, we go back to recently used vertices on a dead-end stack, and then to the next vertex in index order.
+// vertex_triangles lists the triangles that use each vertex, starting at vertex_triangle_offsets[vertex]. live_counts starts as the
+// number of triangles that use each vertex, cache_times and emitted must be zeroed, and dead_ends needs room for all indices.
+static void _tipsify_triangles(const uint32_t* indices, uint32_t triangle_count, uint32_t vertex_count, uint32_t cache_size,
+    const uint32_t* vertex_triangle_offsets, const uint32_t* vertex_triangles, uint32_t* live_counts, uint32_t* cache_times, 
+    uint8_t* emitted, uint32_t* dead_ends, uint32_t* out_indices)
+{
+    uint32_t time           = cache_size + 1;
+    uint32_t dead_end_count = 0;
+    uint32_t cursor         = 0;
+    uint32_t out_count      = 0;
+    uint32_t fan_vertex     = 0;
+    while (fan_vertex != UINT32_MAX) {
+        // emit the remaining triangles around the fan vertex. The vertices of these triangles are pushed on the dead-end 
+        // stack, and are also the candidates for the next fan vertex.
+        uint32_t first_candidate = dead_end_count;
+        for (uint32_t i = vertex_triangle_offsets[fan_vertex]; i < vertex_triangle_offsets[fan_vertex + 1]; i++) {
+            uint32_t triangle = vertex_triangles[i];
+            if (emitted[triangle])
+                continue;
+            emitted[triangle] = 1;
+            for (uint32_t c = 0; c < 3; c++) {
+                uint32_t vertex = indices[triangle * 3 + c];
+                out_indices[out_count++] = vertex;
+                dead_ends[dead_end_count++] = vertex;
+                live_counts[vertex]--;
+                if (time - cache_times[vertex] > cache_size)
+                    cache_times[vertex] = time++;
+            }
+        }
+
+        uint32_t next_vertex = UINT32_MAX;
+        uint32_t best_priority = 0;
+        for (uint32_t i = first_candidate; i < dead_end_count; i++) {
+            uint32_t vertex = dead_ends[i];
+            if (!live_counts[vertex])
+                continue;
+            uint32_t age = time - cache_times[vertex];
+            uint32_t priority = (age + 2 * live_counts[vertex] <= cache_size) ? age + 1 : 1;
+            if (priority > best_priority) {
+                best_priority = priority;
+                next_vertex   = vertex;
+            }
+        }
+        while (next_vertex == UINT32_MAX && dead_end_count) {
+            uint32_t vertex = dead_ends[--dead_end_count];
+            if (live_counts[vertex])
+                next_vertex = vertex;
+        }
+        for (; next_vertex == UINT32_MAX && cursor < vertex_count; cursor++) {
+            if (live_counts[cursor])
+                next_vertex = cursor;
+        }
+        fan_vertex = next_vertex;
+    }
+    (void)triangle_count;
+    assert(out_count == triangle_count * 3);
+}
+
+// splits the triangles into clusters that start where all 3 vertices of a triangle miss a FIFO cache of cache_size vertices, and 
+// computes how much each cluster faces away from the center of the mesh. Returns the number of clusters.
+static uint32_t _find_triangle_clusters(const ogt_mesh_vertex* vertices, const uint32_t* indices, uint32_t triangle_count, uint32_t cache_size,
+    uint32_t* cache_times, ogt_mesh_triangle_cluster* clusters, ogt_mesh_vec3* cluster_centroids, ogt_mesh_vec3* cluster_normals) 
+{
+    // accumulate the area weighted centroids and the normals of each cluster, and the area of each cluster in its sort key.
+    uint32_t cluster_count = 0;
+    uint32_t time = cache_size + 1;
+    ogt_mesh_vec3 mesh_centroid = _make_vec3(0.0f, 0.0f, 0.0f);
+    float mesh_area = 0.0f;
+    for (uint32_t t = 0; t < triangle_count; t++) {
+        uint32_t miss_count = 0;
+        for (uint32_t c = 0; c < 3; c++) {
+            uint32_t vertex = indices[t * 3 + c];
+            if (time - cache_times[vertex] > cache_size) {
+                cache_times[vertex] = time++;
+                miss_count++;
+            }
+        }
+        if (miss_count == 3 || !cluster_count) {
+            clusters[cluster_count].first_triangle = t;
+            clusters[cluster_count].triangle_count = 0;
+            clusters[cluster_count].sort_key       = 0.0f;
+            cluster_centroids[cluster_count] = _make_vec3(0.0f, 0.0f, 0.0f);
+            cluster_normals[cluster_count]   = _make_vec3(0.0f, 0.0f, 0.0f);
+            cluster_count++;
+        }
+        const ogt_mesh_vec3& p0 = vertices[indices[t * 3 + 0]].pos;
+        const ogt_mesh_vec3& p1 = vertices[indices[t * 3 + 1]].pos;
+        const ogt_mesh_vec3& p2 = vertices[indices[t * 3 + 2]].pos;
+        ogt_mesh_vec3 normal = _cross3(_sub3(p1, p0), _sub3(p2, p0));
+        float area = sqrtf(_dot3(normal, normal));
+        float weight = area * (1.0f / 3.0f);
+        ogt_mesh_vec3 centroid = _add3(_add3(p0, p1), p2);
+        centroid = _make_vec3(centroid.x * weight, centroid.y * weight, centroid.z * weight);
+
+        ogt_mesh_triangle_cluster& cluster = clusters[cluster_count - 1];
+        cluster.triangle_count++;
+        cluster.sort_key += area;
+        cluster_centroids[cluster_count - 1] = _add3(cluster_centroids[cluster_count - 1], centroid);
+        cluster_normals[cluster_count - 1]   = _add3(cluster_normals[cluster_count - 1], normal);
+        mesh_centroid = _add3(mesh_centroid, centroid);
+        mesh_area += area;
+    }
+    if (mesh_area > 0.0f)
+        mesh_centroid = _make_vec3(mesh_centroid.x / mesh_area, mesh_centroid.y / mesh_area, mesh_centroid.z / mesh_area);
+
+    // clusters that face away from the center of the mesh are more likely to be in front of other clusters, so drawing them 
+    // first lets early-z reject more of the clusters behind them.
+    for (uint32_t i = 0; i < cluster_count; i++) {
+        float cluster_area  = clusters[i].sort_key;
+        float normal_length = sqrtf(_dot3(cluster_normals[i], cluster_normals[i]));
+        clusters[i].sort_key = 0.0f;
+        if (cluster_area > 0.0f && normal_length > 0.0f) {
+            ogt_mesh_vec3 centroid = _make_vec3(cluster_centroids[i].x / cluster_area, cluster_centroids[i].y / cluster_area, cluster_centroids[i].z / cluster_area);
+            clusters[i].sort_key = _dot3(_sub3(centroid, mesh_centroid), cluster_normals[i]) / normal_length;
+        }
+    }
+    return cluster_count;
+}
+
+void ogt_mesh_optimize(const ogt_voxel_meshify_context* ctx, ogt_mesh* mesh, uint32_t cache_size) {
+    uint32_t vertex_count   = mesh->vertex_count;
+    uint32_t triangle_count = mesh->index_count / 3;
+    if (!vertex_count || !triangle_count)
+        return;
+    if (!cache_size)
+        cache_size = k_default_vertex_cache_size;
+
+    ogt_mesh_scratch_mark scratch_mark = _scratch_begin(ctx);
+    uint32_t*                  vertex_triangle_offsets = (uint32_t*)_scratch_alloc(ctx, sizeof(uint32_t) * (vertex_count + 1));
+    uint32_t*                  vertex_triangles        = (uint32_t*)_scratch_alloc(ctx, sizeof(uint32_t) * triangle_count * 3);
+    uint32_t*                  live_counts             = (uint32_t*)_scratch_alloc(ctx, sizeof(uint32_t) * vertex_count);
+    uint32_t*                  cache_times             = (uint32_t*)_scratch_alloc(ctx, sizeof(uint32_t) * vertex_count);
+    uint8_t*                   emitted                 = (uint8_t*)_scratch_alloc(ctx, triangle_count);
+    uint32_t*                  dead_ends               = (uint32_t*)_scratch_alloc(ctx, sizeof(uint32_t) * triangle_count * 3);
+    uint32_t*                  tipsify_indices         = (uint32_t*)_scratch_alloc(ctx, sizeof(uint32_t) * triangle_count * 3);
+    ogt_mesh_triangle_cluster* clusters                = (ogt_mesh_triangle_cluster*)_scratch_alloc(ctx, sizeof(ogt_mesh_triangle_cluster) * triangle_count);
+    ogt_mesh_vec3*             cluster_centroids       = (ogt_mesh_vec3*)_scratch_alloc(ctx, sizeof(ogt_mesh_vec3) * triangle_count);
+    ogt_mesh_vec3*             cluster_normals         = (ogt_mesh_vec3*)_scratch_alloc(ctx, sizeof(ogt_mesh_vec3) * triangle_count);
+    ogt_mesh_vertex*           old_vertices            = (ogt_mesh_vertex*)_scratch_alloc(ctx, sizeof(ogt_mesh_vertex) * vertex_count);
+
+    if (vertex_triangle_offsets && vertex_triangles && live_counts && cache_times && emitted && dead_ends && tipsify_indices && 
+        clusters && cluster_centroids && cluster_normals && old_vertices) 
+    {
+        // triangles are reordered separately within each direction range, or across the whole mesh if it doesn't have them.
+        ogt_mesh_index_range whole_range = { 0, triangle_count * 3 };
+        bool has_direction_ranges = _has_direction_ranges(mesh);
+        const ogt_mesh_index_range* ranges = has_direction_ranges ? mesh->direction_ranges : &whole_range;
+        uint32_t range_count = has_direction_ranges ? ogt_mesh_direction_count : 1;
+        for (uint32_t r = 0; r < range_count; r++) {
+            uint32_t* indices = &mesh->indices[ranges[r].index_offset];
+            uint32_t range_triangle_count = ranges[r].index_count / 3;
+            if (!range_triangle_count)
+                continue;
+
+            // list the triangles that use each vertex.
+            memset(live_counts, 0, sizeof(uint32_t) * vertex_count);
+            for (uint32_t i = 0; i < range_triangle_count * 3; i++)
+                live_counts[indices[i]]++;
+            vertex_triangle_offsets[0] = 0;
+            for (uint32_t i = 0; i < vertex_count; i++)
+                vertex_triangle_offsets[i + 1] = vertex_triangle_offsets[i] + live_counts[i];
+            memcpy(cache_times, vertex_triangle_offsets, sizeof(uint32_t) * vertex_count);
+            for (uint32_t i = 0; i < range_triangle_count * 3; i++)
+                vertex_triangles[cache_times[indices[i]]++] = i / 3;
+
+            memset(cache_times, 0, sizeof(uint32_t) * vertex_count);
+            memset(emitted, 0, range_triangle_count);
+            _tipsify_triangles(indices, range_triangle_count, vertex_count, cache_size, vertex_triangle_offsets, vertex_triangles, live_counts, cache_times, 
+                emitted, dead_ends, tipsify_indices);
+
+            // order clusters of the tipsified triangles from the outside in, and write them back.
+            memset(cache_times, 0, sizeof(uint32_t) * vertex_count);
+            uint32_t cluster_count = _find_triangle_clusters(mesh->vertices, tipsify_indices, range_triangle_count, cache_size, cache_times, clusters, cluster_centroids, cluster_normals);
+            qsort(clusters, cluster_count, sizeof(ogt_mesh_triangle_cluster), _compare_triangle_clusters);
+            for (uint32_t i = 0; i < cluster_count; i++) {
+                memcpy(indices, &tipsify_indices[clusters[i].first_triangle * 3], sizeof(uint32_t) * clusters[i].triangle_count * 3);
+                indices += clusters[i].triangle_count * 3;
+            }
+        }
+
+        // number vertices in the order they are first used.
+        uint32_t* vertex_remap = live_counts;
+        memset(vertex_remap, 0xFF, sizeof(uint32_t) * vertex_count);
+        memcpy(old_vertices, mesh->vertices, sizeof(ogt_mesh_vertex) * vertex_count);
+        uint32_t new_vertex_count = 0;
+        for (uint32_t i = 0; i < triangle_count * 3; i++) {
+            uint32_t vertex = mesh->indices[i];
+            if (vertex_remap[vertex] == UINT32_MAX) {
+                mesh->vertices[new_vertex_count] = old_vertices[vertex];
+                vertex_remap[vertex] = new_vertex_count++;
+            }
+            mesh->indices[i] = vertex_remap[vertex];
+        }
+        mesh->vertex_count = new_vertex_count;
+    }
+
+    _scratch_free(ctx, old_vertices);
+    _scratch_free(ctx, cluster_normals);
+    _scratch_free(ctx, cluster_centroids);
+    _scratch_free(ctx, clusters);
+    _scratch_free(ctx, tipsify_indices);
+    _scratch_free(ctx, dead_ends);
+    _scratch_free(ctx, emitted);
+    _scratch_free(ctx, cache_times);
+    _scratch_free(ctx, live_counts);
+    _scratch_free(ctx, vertex_triangles);
+    _scratch_free(ctx, vertex_triangle_offsets);
+    _scratch_end(ctx, scratch_mark);
+}
+
+float ogt_mesh_get_acmr(const ogt_voxel_meshify_context* ctx, const ogt_mesh* mesh, uint32_t cache_size) {
+    uint32_t triangle_count = mesh->index_count / 3;
+    if (!mesh->vertex_count || !triangle_count)
+        return 0.0f;
+    if (!cache_size)
+        cache_size = k_default_vertex_cache_size;
+
+    ogt_mesh_scratch_mark scratch_mark = _scratch_begin(ctx);
+    uint32_t* cache_times = (uint32_t*)_scratch_alloc(ctx, sizeof(uint32_t) * mesh->vertex_count);
+    uint32_t miss_count = 0;
+    if (cache_times) {
+        // a vertex is in the cache if fewer than cache_size vertices have been added to the cache since it was.
+        memset(cache_times, 0, sizeof(uint32_t) * mesh->vertex_count);
+        uint32_t time = cache_size + 1;
+        for (uint32_t i = 0; i < triangle_count * 3; i++) {
+            uint32_t vertex = mesh->indices[i];
+            if (time - cache_times[vertex] > cache_size) {
+                cache_times[vertex] = time++;
+                miss_count++;
+            }
+        }
+    }
+    _scratch_free(ctx, cache_times);
+    _scratch_end(ctx, scratch_mark);
+    return (float)miss_count / (float)triangle_count;
+}
+
+// default limits of meshlets, which suit most mesh shader hardware.
+static const uint32_t k_default_meshlet_max_vertices  = 64;
+static const uint32_t k_default_meshlet_max_triangles = 124;
+
+// returns the direction that a triangle with the specified (unnormalized) normal faces, by the largest component of the normal.
+static ogt_mesh_direction _get_normal_direction(const ogt_mesh_vec3& normal) {
+    float abs_x = fabsf(normal.x);
+    float abs_y = fabsf(normal.y);
+    float abs_z = fabsf(normal.z);
+    if (abs_x >= abs_y && abs_x >= abs_z)
+        return normal.x >= 0.0f ? ogt_mesh_direction_pos_x : ogt_mesh_direction_neg_x;
+    if (abs_y >= abs_z)
+        return normal.y >= 0.0f ? ogt_mesh_direction_pos_y : ogt_mesh_direction_neg_y;
+    return normal.z >= 0.0f ? ogt_mesh_direction_pos_z : ogt_mesh_direction_neg_z;
+}
+
+static ogt_mesh_vec3 _get_triangle_normal(const ogt_mesh* mesh, const uint32_t* triangle_indices) {
+    const ogt_mesh_vec3& p0 = mesh->vertices[triangle_indices[0]].pos;
+    const ogt_mesh_vec3& p1 = mesh->vertices[triangle_indices[1]].pos;
+    const ogt_mesh_vec3& p2 = mesh->vertices[triangle_indices[2]].pos;
+    return _cross3(_sub3(p1, p0), _sub3(p2, p0));
+}
+
+// computes the bounding sphere, bounding box and normal cone of the meshlet. The cone is computed the same way as meshoptimizer:
+// its axis is the average of the triangle normals, and its apex is placed so that the planes of all triangles face away from 
+// any point within the cone behind it.
+static void _compute_meshlet_bounds(const ogt_mesh* mesh, const uint32_t* meshlet_vertices, const uint8_t* meshlet_triangles, ogt_mesh_meshlet& meshlet) {
+    ogt_mesh_vec3 aabb_min = mesh->vertices[meshlet_vertices[0]].pos;
+    ogt_mesh_vec3 aabb_max = aabb_min;
+    for (uint32_t i = 1; i < meshlet.vertex_count; i++) {
+        const ogt_mesh_vec3& pos = mesh->vertices[meshlet_vertices[i]].pos;
+        aabb_min = _make_vec3(pos.x < aabb_min.x ? pos.x : aabb_min.x, pos.y < aabb_min.y ? pos.y : aabb_min.y, pos.z < aabb_min.z ? pos.z : aabb_min.z);
+        aabb_max = _make_vec3(pos.x > aabb_max.x ? pos.x : aabb_max.x, pos.y > aabb_max.y ? pos.y : aabb_max.y, pos.z > aabb_max.z ? pos.z : aabb_max.z);
+    }
+    ogt_mesh_vec3 center = _make_vec3((aabb_min.x + aabb_max.x) * 0.5f, (aabb_min.y + aabb_max.y) * 0.5f, (aabb_min.z + aabb_max.z) * 0.5f);
+    float radius_squared = 0.0f;
+    for (uint32_t i = 0; i < meshlet.vertex_count; i++) {
+        ogt_mesh_vec3 offset = _sub3(mesh->vertices[meshlet_vertices[i]].pos, center);
+        float distance_squared = _dot3(offset, offset);
+        radius_squared = distance_squared > radius_squared ? distance_squared : radius_squared;
+    }
+    meshlet.aabb_min = aabb_min;
+    meshlet.aabb_max = aabb_max;
+    meshlet.center   = center;
+    meshlet.radius   = sqrtf(radius_squared);
+
+    // when all triangles have exactly the same normal, as they do in voxel meshes, it is used as the axis as-is so that the 
+    // cutoff comes out at exactly 0 rather than a rounding error away from it.
+    ogt_mesh_vec3 axis = _make_vec3(0.0f, 0.0f, 0.0f);
+    ogt_mesh_vec3 first_normal = axis;
+    bool is_same_normal = true;
+    for (uint32_t t = 0; t < meshlet.triangle_count; t++) {
+        uint32_t triangle_indices[3] = { meshlet_vertices[meshlet_triangles[t * 3 + 0]], meshlet_vertices[meshlet_triangles[t * 3 + 1]], meshlet_vertices[meshlet_triangles[t * 3 + 2]] };
+        ogt_mesh_vec3 normal = _get_triangle_normal(mesh, triangle_indices);
+        if (_dot3(normal, normal) > 0.0f) {
+            normal = _normalize3(normal);
+            first_normal = (t == 0) ? normal : first_normal;
+            is_same_normal &= (normal.x == first_normal.x && normal.y == first_normal.y && normal.z == first_normal.z);
+            axis = _add3(axis, normal);
+        }
+        else {
+            is_same_normal = false;
+        }
+    }
+    meshlet.cone_apex   = center;
+    meshlet.cone_axis   = is_same_normal ? first_normal : (_dot3(axis, axis) > 0.0f ? _normalize3(axis) : axis);
+    meshlet.cone_cutoff = 1.0f;
+    float min_cos = 1.0f;
+    for (uint32_t t = 0; t < meshlet.triangle_count; t++) {
+        uint32_t triangle_indices[3] = { meshlet_vertices[meshlet_triangles[t * 3 + 0]], meshlet_vertices[meshlet_triangles[t * 3 + 1]], meshlet_vertices[meshlet_triangles[t * 3 + 2]] };
+        ogt_mesh_vec3 normal = _get_triangle_normal(mesh, triangle_indices);
+        float cos_angle = (_dot3(normal, normal) > 0.0f) ? _dot3(_normalize3(normal), meshlet.cone_axis) : -1.0f;
+        min_cos = cos_angle < min_cos ? cos_angle : min_cos;
+    }
+    // if the normals are too spread out, the cone would be too wide to ever cull anything.
+    if (min_cos <= 0.1f)
+        return;
+    float max_t = 0.0f;
+    for (uint32_t t = 0; t < meshlet.triangle_count; t++) {
+        uint32_t triangle_indices[3] = { meshlet_vertices[meshlet_triangles[t * 3 + 0]], meshlet_vertices[meshlet_triangles[t * 3 + 1]], meshlet_vertices[meshlet_triangles[t * 3 + 2]] };
+        ogt_mesh_vec3 normal = _normalize3(_get_triangle_normal(mesh, triangle_indices));
+        // the distance along the axis from the center to the plane of the triangle.
+        float triangle_t = _dot3(_sub3(center, mesh->vertices[triangle_indices[0]].pos), normal) / _dot3(meshlet.cone_axis, normal);
+        max_t = triangle_t > max_t ? triangle_t : max_t;
+    }
+    meshlet.cone_apex   = _sub3(center, _make_vec3(meshlet.cone_axis.x * max_t, meshlet.cone_axis.y * max_t, meshlet.cone_axis.z * max_t));
+    meshlet.cone_cutoff = (min_cos >= 1.0f) ? 0.0f : sqrtf(1.0f - min_cos * min_cos);
+}
+
+ogt_mesh_meshlets* ogt_mesh_build_meshlets(const ogt_voxel_meshify_context* ctx, const ogt_mesh* mesh, uint32_t max_vertices, uint32_t max_triangles) {
+    uint32_t vertex_count   = mesh->vertex_count;
+    uint32_t triangle_count = mesh->index_count / 3;
+    max_vertices  = max_vertices  ? (max_vertices < 3 ? 3 : (max_vertices > 256 ? 256 : max_vertices)) : k_default_meshlet_max_vertices;
+    max_triangles = max_triangles ? max_triangles : k_default_meshlet_max_triangles;
+
+    // there can be at most one meshlet per triangle, and 3 meshlet vertices per triangle.
+    ogt_mesh_scratch_mark scratch_mark = _scratch_begin(ctx);
+    uint8_t*          triangle_directions = (uint8_t*)_scratch_alloc(ctx, triangle_count);
+    uint32_t*         sorted_triangles    = (uint32_t*)_scratch_alloc(ctx, sizeof(uint32_t) * triangle_count);
+    uint32_t*         vertex_meshlets     = (uint32_t*)_scratch_alloc(ctx, sizeof(uint32_t) * vertex_count);
+    uint8_t*          vertex_local_index  = (uint8_t*)_scratch_alloc(ctx, vertex_count);
+    ogt_mesh_meshlet* meshlets            = (ogt_mesh_meshlet*)_scratch_alloc(ctx, sizeof(ogt_mesh_meshlet) * triangle_count);
+    uint32_t*         meshlet_vertices    = (uint32_t*)_scratch_alloc(ctx, sizeof(uint32_t) * triangle_count * 3);
+    uint8_t*          meshlet_triangles   = (uint8_t*)_scratch_alloc(ctx, triangle_count * 3);
+
+    ogt_mesh_meshlets* result = NULL;
+    if (!triangle_count || (triangle_directions && sorted_triangles && vertex_meshlets && vertex_local_index && meshlets && meshlet_vertices && meshlet_triangles)) {
+        // group triangles by direction with a counting sort, which keeps them in mesh order within each direction.
+        uint32_t direction_offsets[ogt_mesh_direction_count + 1] = { 0 };
+        for (uint32_t t = 0; t < triangle_count; t++) {
+            triangle_directions[t] = (uint8_t)_get_normal_direction(_get_triangle_normal(mesh, &mesh->indices[t * 3]));
+            direction_offsets[triangle_directions[t] + 1]++;
+        }
+        for (uint32_t d = 0; d < ogt_mesh_direction_count; d++)
+            direction_offsets[d + 1] += direction_offsets[d];
+        for (uint32_t t = 0; t < triangle_count; t++)
+            sorted_triangles[direction_offsets[triangle_directions[t]]++] = t;
+
+        // fill meshlets one triangle at a time, starting a new one when the next triangle won't fit or faces another direction.
+        // vertex_meshlets records the last meshlet each vertex was added to, so we know whether it is already in the current one.
+        if (vertex_count)
+            memset(vertex_meshlets, 0xFF, sizeof(uint32_t) * vertex_count);
+        uint32_t meshlet_count          = 0;
+        uint32_t meshlet_vertex_count   = 0;
+        uint32_t meshlet_triangle_count = 0;
+        for (uint32_t i = 0; i < triangle_count; i++) {
+            uint32_t t = sorted_triangles[i];
+            const uint32_t* triangle_indices = &mesh->indices[t * 3];
+            ogt_mesh_meshlet* meshlet = meshlet_count ? &meshlets[meshlet_count - 1] : NULL;
+            uint32_t new_vertex_count = 0;
+            for (uint32_t c = 0; c < 3; c++) {
+                bool is_repeat = (c > 0 && triangle_indices[c] == triangle_indices[0]) || (c > 1 && triangle_indices[c] == triangle_indices[1]);
+                new_vertex_count += (!is_repeat && vertex_meshlets[triangle_indices[c]] != meshlet_count - 1) ? 1 : 0;
+            }
+            if (!meshlet || meshlet->direction != (ogt_mesh_direction)triangle_directions[t] || 
+                meshlet->vertex_count + new_vertex_count > max_vertices || meshlet->triangle_count + 1 > max_triangles) 
+            {
+                meshlet = &meshlets[meshlet_count++];
+                memset(meshlet, 0, sizeof(ogt_mesh_meshlet));
+                meshlet->vertex_offset   = meshlet_vertex_count;
+                meshlet->triangle_offset = meshlet_triangle_count * 3;
+                meshlet->direction       = (ogt_mesh_direction)triangle_directions[t];
+            }
+            for (uint32_t c = 0; c < 3; c++) {
+                uint32_t vertex = triangle_indices[c];
+                if (vertex_meshlets[vertex] != meshlet_count - 1) {
+                    vertex_meshlets[vertex]    = meshlet_count - 1;
+                    vertex_local_index[vertex] = (uint8_t)meshlet->vertex_count++;
+                    meshlet_vertices[meshlet_vertex_count++] = vertex;
+                }
+                meshlet_triangles[meshlet_triangle_count * 3 + c] = vertex_local_index[vertex];
+            }
+            meshlet->triangle_count++;
+            meshlet_triangle_count++;
+        }
+
+        size_t result_size = sizeof(ogt_mesh_meshlets) + (sizeof(ogt_mesh_meshlet) * meshlet_count) + (sizeof(uint32_t) * meshlet_vertex_count) + (meshlet_triangle_count * 3);
+        result = (ogt_mesh_meshlets*)_voxel_meshify_malloc(ctx, result_size);
+        if (result) {
+            result->meshlet_count  = meshlet_count;
+            result->vertex_count   = meshlet_vertex_count;
+            result->triangle_count = meshlet_triangle_count;
+            result->meshlets       = (ogt_mesh_meshlet*)&result[1];
+            result->vertices       = (uint32_t*)&result->meshlets[meshlet_count];
+            result->triangles      = (uint8_t*)&result->vertices[meshlet_vertex_count];
+            if (meshlet_count) {
+                memcpy(result->meshlets,  meshlets,          sizeof(ogt_mesh_meshlet) * meshlet_count);
+                memcpy(result->vertices,  meshlet_vertices,  sizeof(uint32_t) * meshlet_vertex_count);
+                memcpy(result->triangles, meshlet_triangles, meshlet_triangle_count * 3);
+            }
+            for (uint32_t i = 0; i < meshlet_count; i++)
+                _compute_meshlet_bounds(mesh, &result->vertices[result->meshlets[i].vertex_offset], &result->triangles[result->meshlets[i].triangle_offset], result->meshlets[i]);
+        }
+    }
+
+    _scratch_free(ctx, meshlet_triangles);
+    _scratch_free(ctx, meshlet_vertices);
+    _scratch_free(ctx, meshlets);
+    _scratch_free(ctx, vertex_local_index);
+    _scratch_free(ctx, vertex_meshlets);
+    _scratch_free(ctx, sorted_triangles);
+    _scratch_free(ctx, triangle_directions);
+    _scratch_end(ctx, scratch_mark);
+    return result;
+}
+
+void ogt_mesh_meshlets_destroy(const ogt_voxel_meshify_context* ctx, ogt_mesh_meshlets* meshlets) {
+    _voxel_meshify_free(ctx, meshlets);
+}
+
+// stable sorts triangles by the direction of their geometric normal, and optionally by the palette index of their first vertex 
+// within each direction, with a counting sort. Returns false if temporary memory could not be allocated.
+static bool _sort_triangles_by_direction(const ogt_voxel_meshify_context* ctx, ogt_mesh* mesh, ogt_mesh_index_range* palette_ranges) {
+    memset(mesh->direction_ranges, 0, sizeof(mesh->direction_ranges));
+    uint32_t triangle_count = mesh->index_count / 3;
+    if (!triangle_count)
+        return true;
+
+    const uint32_t key_count = palette_ranges ? ogt_mesh_direction_count * 256 : ogt_mesh_direction_count;
+    ogt_mesh_scratch_mark scratch_mark = _scratch_begin(ctx);
+    uint16_t* triangle_keys = (uint16_t*)_scratch_alloc(ctx, sizeof(uint16_t) * triangle_count);
+    uint32_t* key_offsets   = (uint32_t*)_scratch_alloc(ctx, sizeof(uint32_t) * (key_count + 1));
+    uint32_t* old_indices   = (uint32_t*)_scratch_alloc(ctx, sizeof(uint32_t) * triangle_count * 3);
+    bool is_sorted = triangle_keys && key_offsets && old_indices;
+    if (is_sorted) {
+        memset(key_offsets, 0, sizeof(uint32_t) * (key_count + 1));
+        for (uint32_t t = 0; t < triangle_count; t++) {
+            const uint32_t* triangle_indices = &mesh->indices[t * 3];
+            uint32_t key = (uint32_t)_get_normal_direction(_get_triangle_normal(mesh, triangle_indices));
+            if (palette_ranges)
+                key = (key * 256) + (mesh->vertices[triangle_indices[0]].palette_index & 255);
+            triangle_keys[t] = (uint16_t)key;
+            key_offsets[key + 1] += 3;
+        }
+        for (uint32_t k = 0; k < key_count; k++)
+            key_offsets[k + 1] += key_offsets[k];
+        for (uint32_t d = 0; d < ogt_mesh_direction_count; d++) {
+            uint32_t first_key = palette_ranges ? d * 256 : d;
+            uint32_t last_key  = palette_ranges ? first_key + 256 : first_key + 1;
+            mesh->direction_ranges[d].index_offset = key_offsets[first_key];
+            mesh->direction_ranges[d].index_count  = key_offsets[last_key] - key_offsets[first_key];
+        }
+        if (palette_ranges) {
+            for (uint32_t k = 0; k < key_count; k++) {
+                palette_ranges[k].index_offset = key_offsets[k];
+                palette_ranges[k].index_count  = key_offsets[k + 1] - key_offsets[k];
+            }
+        }
+        memcpy(old_indices, mesh->indices, sizeof(uint32_t) * triangle_count * 3);
+        for (uint32_t t = 0; t < triangle_count; t++) {
+            uint32_t* dst = &mesh->indices[key_offsets[triangle_keys[t]]];
+            key_offsets[triangle_keys[t]] += 3;
+            dst[0] = old_indices[t * 3 + 0];
+            dst[1] = old_indices[t * 3 + 1];
+            dst[2] = old_indices[t * 3 + 2];
+        }
+    }
+    _scratch_free(ctx, old_indices);
+    _scratch_free(ctx, key_offsets);
+    _scratch_free(ctx, triangle_keys);
+    _scratch_end(ctx, scratch_mark);
+    return is_sorted;
+}
+
+void ogt_mesh_sort_triangles_by_direction(const ogt_voxel_meshify_context* ctx, ogt_mesh* mesh, ogt_mesh_index_range* out_palette_ranges) {
+    _sort_triangles_by_direction(ctx, mesh, out_palette_ranges);
+}
+
+// which faces of a voxel are visible, as used by the simple meshifier.
+static const uint32_t k_voxel_face_neg_x = 1 << 0;
+static const uint32_t k_voxel_face_pos_x = 1 << 1;
+static const uint32_t k_voxel_face_neg_y = 1 << 2;
+static const uint32_t k_voxel_face_pos_y = 1 << 3;
+static const uint32_t k_voxel_face_neg_z = 1 << 4;
+static const uint32_t k_voxel_face_pos_z = 1 << 5;
+
+// gets the set of k_voxel_face_* flags for the voxel at the specified bit within the face masks.
+static inline uint32_t _get_voxel_face_flags(const ogt_mesh_face_masks& face_masks, uint32_t bit) {
+    return (((uint32_t)(face_masks.neg_x >> bit) & 1) << 0) |
+           (((uint32_t)(face_masks.pos_x >> bit) & 1) << 1) |
+           (((uint32_t)(face_masks.neg_y >> bit) & 1) << 2) |
+           (((uint32_t)(face_masks.pos_y >> bit) & 1) << 3) |
+           (((uint32_t)(face_masks.neg_z >> bit) & 1) << 4) |
+           (((uint32_t)(face_masks.pos_z >> bit) & 1) << 5);
+}
+
+// writes the quads for each visible face of voxel (i,j,k) to the specified vertex/index memory. 
+// Indices are offset by base_vertex_index. Returns the number of faces that were written.
+static uint32_t _simple_meshify_voxel(ogt_mesh_vertex* current_vertex, uint32_t* current_index, uint32_t base_vertex_index,
+    uint32_t i, uint32_t j, uint32_t k, uint32_t face_flags, const ogt_mesh_rgba& color, uint8_t color_index)
+{
+    // determine the min/max coords of the voxel for each dimension.
+    const float min_x = (float)i;
+    const float max_x = min_x + 1.0f;
+    const float min_y = (float)j;
+    const float max_y = min_y + 1.0f;
+    const float min_z = (float)k;
+    const float max_z = min_z + 1.0f;
+
+    uint32_t total_vertex_count = base_vertex_index;
+    uint32_t face_count = 0;
+
+    // -X direction face
+    if (face_flags & k_voxel_face_neg_x)
+    {
+        current_vertex[0] = _mesh_make_vertex( min_x, min_y, min_z, -1.0f, 0.0f, 0.0f, color, color_index );
+        current_vertex[1] = _mesh_make_vertex( min_x, max_y, min_z, -1.0f, 0.0f, 0.0f, color, color_index );
+        current_vertex[2] = _mesh_make_vertex( min_x, max_y, max_z, -1.0f, 0.0f, 0.0f, color, color_index );
+        current_vertex[3] = _mesh_make_vertex( min_x, min_y, max_z, -1.0f, 0.0f, 0.0f, color, color_index );
+        current_index[0] = total_vertex_count + 2;
+        current_index[1] = total_vertex_count + 1;
+        current_index[2] = total_vertex_count + 0;
+        current_index[3] = total_vertex_count + 0;
+        current_index[4] = total_vertex_count + 3;
+        current_index[5] = total_vertex_count + 2;
+        total_vertex_count += 4;
+        current_vertex += 4;
+        current_index += 6;
+        face_count++;
+    }
+    
+    // +X direction face
+    if (face_flags & k_voxel_face_pos_x)
+    {
+        current_vertex[0] = _mesh_make_vertex( max_x, min_y, min_z, 1.0f, 0.0f, 0.0f, color, color_index );
+        current_vertex[1] = _mesh_make_vertex( max_x, max_y, min_z, 1.0f, 0.0f, 0.0f, color, color_index );
+        current_vertex[2] = _mesh_make_vertex( max_x, max_y, max_z, 1.0f, 0.0f, 0.0f, color, color_index );
+        current_vertex[3] = _mesh_make_vertex( max_x, min_y, max_z, 1.0f, 0.0f, 0.0f, color, color_index );
+        current_index[0] = total_vertex_count + 0;
+        current_index[1] = total_vertex_count + 1;
+        current_index[2] = total_vertex_count + 2;
+        current_index[3] = total_vertex_count + 2;
+        current_index[4] = total_vertex_count + 3;
+        current_index[5] = total_vertex_count + 0;
+        total_vertex_count += 4;
+        current_vertex += 4;
+        current_index += 6;
+        face_count++;
+    }
+    
+    // -Y direction face
+    if (face_flags & k_voxel_face_neg_y)
+    {
+        current_vertex[0] = _mesh_make_vertex( min_x, min_y, min_z, 0.0f,-1.0f, 0.0f, color, color_index );
+        current_vertex[1] = _mesh_make_vertex( max_x, min_y, min_z, 0.0f,-1.0f, 0.0f, color, color_index );
+        current_vertex[2] = _mesh_make_vertex( max_x, min_y, max_z, 0.0f,-1.0f, 0.0f, color, color_index );
+        current_vertex[3] = _mesh_make_vertex( min_x, min_y, max_z, 0.0f,-1.0f, 0.0f, color, color_index );
+        current_index[0] = total_vertex_count + 0;
+        current_index[1] = total_vertex_count + 1;
+        current_index[2] = total_vertex_count + 2;
+        current_index[3] = total_vertex_count + 2;
+        current_index[4] = total_vertex_count + 3;
+        current_index[5] = total_vertex_count + 0;
+        total_vertex_count += 4;
+        current_vertex += 4;
+        current_index += 6;
+        face_count++;
+    }
+    // +Y direction face
+    if (face_flags & k_voxel_face_pos_y)
+    {
+        current_vertex[0] = _mesh_make_vertex( min_x, max_y, min_z, 0.0f, 1.0f, 0.0f, color, color_index );
+        current_vertex[1] = _mesh_make_vertex( max_x, max_y, min_z, 0.0f, 1.0f, 0.0f, color, color_index );
+        current_vertex[2] = _mesh_make_vertex( max_x, max_y, max_z, 0.0f, 1.0f, 0.0f, color, color_index );
+        current_vertex[3] = _mesh_make_vertex( min_x, max_y, max_z, 0.0f, 1.0f, 0.0f, color, color_index );
+        current_index[0] = total_vertex_count + 2;
+        current_index[1] = total_vertex_count + 1;
+        current_index[2] = total_vertex_count + 0;
+        current_index[3] = total_vertex_count + 0;
+        current_index[4] = total_vertex_count + 3;
+        current_index[5] = total_vertex_count + 2;
+        total_vertex_count += 4;
+        current_vertex += 4;
+        current_index += 6;
+        face_count++;
+    }
+    // -Z direction face
+    if (face_flags & k_voxel_face_neg_z)
+    {
+        current_vertex[0] = _mesh_make_vertex( min_x, min_y, min_z, 0.0f, 0.0f,-1.0f, color, color_index );
+        current_vertex[1] = _mesh_make_vertex( max_x, min_y, min_z, 0.0f, 0.0f,-1.0f, color, color_index );
+        current_vertex[2] = _mesh_make_vertex( max_x, max_y, min_z, 0.0f, 0.0f,-1.0f, color, color_index );
+        current_vertex[3] = _mesh_make_vertex( min_x, max_y, min_z, 0.0f, 0.0f,-1.0f, color, color_index );
+        current_index[0] = total_vertex_count + 2;
+        current_index[1] = total_vertex_count + 1;
+        current_index[2] = total_vertex_count + 0;
+        current_index[3] = total_vertex_count + 0;
+        current_index[4] = total_vertex_count + 3;
+        current_index[5] = total_vertex_count + 2;
+        total_vertex_count += 4;
+        current_vertex += 4;
+        current_index += 6;
+        face_count++;
+    }
+    // +Z direction face
+    if (face_flags & k_voxel_face_pos_z)
+    {
+        current_vertex[0] = _mesh_make_vertex( min_x, min_y, max_z, 0.0f, 0.0f, 1.0f, color, color_index );
+        current_vertex[1] = _mesh_make_vertex( max_x, min_y, max_z, 0.0f, 0.0f, 1.0f, color, color_index );
+        current_vertex[2] = _mesh_make_vertex( max_x, max_y, max_z, 0.0f, 0.0f, 1.0f, color, color_index );
+        current_vertex[3] = _mesh_make_vertex( min_x, max_y, max_z, 0.0f, 0.0f, 1.0f, color, color_index );
+        current_index[0] = total_vertex_count + 0;
+        current_index[1] = total_vertex_count + 1;
+        current_index[2] = total_vertex_count + 2;
+        current_index[3] = total_vertex_count + 2;
+        current_index[4] = total_vertex_count + 3;
+        current_index[5] = total_vertex_count + 0;
+        total_vertex_count += 4;
+        current_vertex += 4;
+        current_index += 6;
+        face_count++;
+    }
+    return face_count;
+}
+
+// Sinks receive the faces of each voxel from _simple_meshify_voxels. The voxel loop is a template on the sink rather than calling
+// it through a function pointer, so that whatever the sink does with the faces of each voxel is inlined into the loop. A sink has:
+//   void get_voxel_buffers(ogt_mesh_vertex*& vertices, uint32_t*& indices)
+//       returns memory for the vertices and indices of the next voxel, with room for all 6 of its faces.
+//   void add_voxel_faces(uint32_t i, uint32_t j, uint32_t k, uint32_t face_flags, uint32_t face_count)
+//       invoked once the faces for the k_voxel_face_* bits in face_flags of voxel (i,j,k) have been written to that memory.
+
+// passes the faces of each voxel on to a per-voxel stream function.
+struct ogt_mesh_simple_voxel_sink {
+    ogt_voxel_simple_stream_func stream_func;
+    void*                        stream_func_data;
+    ogt_mesh_vertex              vertices[6 * 4];
+    uint32_t                     indices[6 * 6];
+
+    inline void get_voxel_buffers(ogt_mesh_vertex*& out_vertices, uint32_t*& out_indices) {
+        out_vertices = vertices;
+        out_indices  = indices;
+    }
+    inline void add_voxel_faces(uint32_t i, uint32_t j, uint32_t k, uint32_t face_flags, uint32_t face_count) {
+        (void)face_flags;
+        stream_func(i, j, k, vertices, face_count * 4, indices, face_count * 6, stream_func_data);
+    }
+};
+
+// accumulates the faces of voxels in buffers that hold up to max_face_count faces, and flushes them to a batch stream function
+// whenever the next voxel might not fit. flush must be called once more after the last voxel.
+struct ogt_mesh_simple_batch_sink {
+    ogt_voxel_simple_batch_stream_func stream_func;
+    void*                              stream_func_data;
+    ogt_mesh_vertex*                   vertices;
+    uint32_t*                          indices;
+    uint32_t                           max_face_count;
+    uint32_t                           face_count;      // faces currently in the buffers.
+
+    inline void flush() {
+        if (face_count)
+            stream_func(vertices, face_count * 4, indices, face_count * 6, stream_func_data);
+        face_count = 0;
+    }
+    inline void get_voxel_buffers(ogt_mesh_vertex*& out_vertices, uint32_t*& out_indices) {
+        if (face_count + 6 > max_face_count)
+            flush();
+        out_vertices = &vertices[face_count * 4];
+        out_indices  = &indices[face_count * 6];
+    }
+    inline void add_voxel_faces(uint32_t i, uint32_t j, uint32_t k, uint32_t face_flags, uint32_t voxel_face_count) {
+        (void)i; (void)j; (void)k; (void)face_flags;
+        face_count += voxel_face_count;
+    }
+};
+
+// writes the faces of voxels directly into mesh vertices that have room for all of them, with the indices of the faces in each
+// ogt_mesh_direction going to the cursor for that direction.
+struct ogt_mesh_simple_direction_sink {
+    ogt_mesh_vertex* vertices;
+    uint32_t         face_count;                // faces written so far.
+    uint32_t**       direction_index_cursors;   // a cursor for each ogt_mesh_direction.
+    uint32_t         face_indices[6 * 6];
+
+    inline void get_voxel_buffers(ogt_mesh_vertex*& out_vertices, uint32_t*& out_indices) {
+        out_vertices = &vertices[face_count * 4];
+        out_indices  = face_indices;
+    }
+    inline void add_voxel_faces(uint32_t i, uint32_t j, uint32_t k, uint32_t face_flags, uint32_t voxel_face_count) {
+        (void)i; (void)j; (void)k;
+        // faces are generated in k_voxel_face_* bit order, and the ogt_mesh_direction of each bit is bit ^ 1.
+        uint32_t face = 0;
+        for (uint64_t flags = face_flags; flags; flags &= flags - 1, face++) {
+            uint32_t*& cursor = direction_index_cursors[_bit_scan_forward64(flags) ^ 1];
+            memcpy(cursor, &face_indices[face * 6], sizeof(uint32_t) * 6);
+            cursor += 6;
+        }
+        face_count += voxel_face_count;
+    }
+};
+
+// generates simple geometry for every voxel that needs at least one face, and hands the faces of each voxel to the sink. Indices
+// are relative to the first vertex of all faces generated. If ao_grid is specified, the ao of each vertex is computed and quads
+// are oriented for it. Returns the total number of faces that were generated.
+template <class SINK>
+static uint32_t _simple_meshify_voxels(
+    const uint8_t* voxels, uint32_t size_x, uint32_t size_y, uint32_t size_z, const ogt_mesh_rgba* palette,
+    const ogt_mesh_voxel_model* ao_grid, SINK& sink)
+{
+    const uint32_t k_stride_y = size_x;
+    const uint32_t k_stride_z = size_x * size_y;
+
+    uint32_t total_face_count = 0;
+    for (uint32_t k = 0; k < size_z; k++)
+    {
+        for (uint32_t j = 0; j < size_y; j++)
+        {
+            for (uint32_t run_start = 0; run_start < size_x; run_start += 64)
+            {
+                // determine which faces we need to generate for the next 64 voxels along the row, and only visit
+                // the voxels that need at least one face.
+                uint32_t run_count = (size_x - run_start) < 64 ? (size_x - run_start) : 64;
+                ogt_mesh_face_masks face_masks = _get_voxel_face_masks(voxels, size_x, size_y, size_z, run_start, j, k, run_count);
+                uint64_t visible_voxels = face_masks.neg_x | face_masks.pos_x | face_masks.neg_y | face_masks.pos_y | face_masks.neg_z | face_masks.pos_z;
+                while (visible_voxels)
+                {
+                    uint32_t bit = _bit_scan_forward64(visible_voxels);
+                    visible_voxels &= visible_voxels - 1;
+
+                    const uint32_t i = run_start + bit;
+                    const uint8_t  color_index = voxels[i + (j * k_stride_y) + (k * k_stride_z)];
+                    const uint32_t face_flags = _get_voxel_face_flags(face_masks, bit);
+                    ogt_mesh_vertex* voxel_vertices;
+                    uint32_t*        voxel_indices;
+                    sink.get_voxel_buffers(voxel_vertices, voxel_indices);
+                    uint32_t face_count = _simple_meshify_voxel(voxel_vertices, voxel_indices, total_face_count * 4,
+                        i, j, k, face_flags, palette[color_index], color_index);
+                    if (ao_grid) {
+                        for (uint32_t v = 0; v < face_count * 4; v++)
+                            _set_vertex_ao(*ao_grid, voxel_vertices[v]);
+                        for (uint32_t face = 0; face < face_count; face++)
+                            _orient_quad_for_ao(&voxel_indices[face * 6], voxel_vertices, total_face_count * 4);
+                    }
+                    sink.add_voxel_faces(i, j, k, face_flags, face_count);
+                    total_face_count += face_count;
+                }
+            }
+        }
+    }
+    return total_face_count;
 }
 
-static void _streaming_add_to_mesh(uint32_t x, uint32_t y, uint32_t z, const ogt_mesh_vertex* vertices, uint32_t vertex_count, const uint32_t* indices, uint32_t index_count, void* stream_func_data) {
-    // these params are unused for now.
-    (void)x; (void)y; (void)z;
-    // copy the specified vertices and indices into the mesh
-    ogt_mesh* mesh = (ogt_mesh*)stream_func_data;
-    memcpy(&mesh->vertices[mesh->vertex_count], vertices, vertex_count * sizeof(ogt_mesh_vertex));
-    memcpy(&mesh->indices[mesh->index_count], indices, index_count * sizeof(uint32_t));
-    mesh->vertex_count += vertex_count;
-    mesh->index_count += index_count;
+// generates simple geometry for all voxels directly into mesh vertices that have room for all faces, with the indices of the
+// faces in each ogt_mesh_direction going to the cursor for that direction. Returns the total number of faces that were generated.
+static uint32_t _simple_meshify_voxels_by_direction(const ogt_voxel_meshify_context* ctx,
+    const uint8_t* voxels, uint32_t size_x, uint32_t size_y, uint32_t size_z, const ogt_mesh_rgba* palette,
+    ogt_mesh_vertex* vertices, uint32_t** direction_index_cursors)
+{
+    ogt_mesh_voxel_model grid;
+    grid.voxels = voxels;
+    grid.size_x = size_x;
+    grid.size_y = size_y;
+    grid.size_z = size_z;
+    ogt_mesh_simple_direction_sink sink;
+    sink.vertices                = vertices;
+    sink.face_count              = 0;
+    sink.direction_index_cursors = direction_index_cursors;
+    return _simple_meshify_voxels(voxels, size_x, size_y, size_z, palette, _get_ao_grid(ctx, grid), sink);
 }
 
 // returns the number of quad faces that would be generated by tessellating the specified voxel field using the simple algorithm.
@@ -558,7 +2375,8 @@ ogt_mesh* ogt_mesh_from_paletted_voxels_simple(
     const ogt_voxel_meshify_context* ctx,
     const uint8_t* voxels, uint32_t size_x, uint32_t size_y, uint32_t size_z, const ogt_mesh_rgba* palette) 
 {
-    uint32_t max_face_count   = _count_voxel_sized_faces( voxels, size_x, size_y, size_z );
+    uint32_t direction_face_counts[ogt_mesh_direction_count];
+    uint32_t max_face_count   = _count_voxel_sized_faces_per_direction( voxels, size_x, size_y, size_z, direction_face_counts );
     uint32_t max_vertex_count = max_face_count * 4;
     uint32_t max_index_count  = max_face_count * 6;
     
@@ -569,10 +2387,14 @@ ogt_mesh* ogt_mesh_from_paletted_voxels_simple(
     
     mesh->vertices = (ogt_mesh_vertex*)&mesh[1];
     mesh->indices  = (uint32_t*)&mesh->vertices[max_vertex_count];
-    mesh->vertex_count = 0;
-    mesh->index_count  = 0;
     
-    ogt_stream_from_paletted_voxels_simple(voxels, size_x, size_y, size_z, palette, _streaming_add_to_mesh, mesh);
+    // the mesh is already big enough to hold all faces, so we generate geometry directly into it, with the indices of 
+    // each direction going to its own range.
+    uint32_t* direction_index_cursors[ogt_mesh_direction_count];
+    _init_direction_ranges(mesh, direction_face_counts, direction_index_cursors);
+    uint32_t face_count = _simple_meshify_voxels_by_direction(ctx, voxels, size_x, size_y, size_z, palette, mesh->vertices, direction_index_cursors);
+    mesh->vertex_count = face_count * 4;
+    mesh->index_count  = face_count * 6;
     
     assert( mesh->vertex_count == max_vertex_count);
     assert( mesh->index_count == max_index_count);	
@@ -585,211 +2407,470 @@ void ogt_stream_from_paletted_voxels_simple(
     ogt_voxel_simple_stream_func stream_func, void* stream_func_data) 
 {
     assert(stream_func);
-    const int32_t k_stride_x = 1;
-    const int32_t k_stride_y = size_x;
-    const int32_t k_stride_z = size_x * size_y;
-    const int32_t k_max_x = size_x - 1;
-    const int32_t k_max_y = size_y - 1;
-    const int32_t k_max_z = size_z - 1;
-    
-    const uint8_t* current_voxel = voxels;
+    ogt_mesh_simple_voxel_sink sink;
+    sink.stream_func      = stream_func;
+    sink.stream_func_data = stream_func_data;
+    _simple_meshify_voxels(voxels, size_x, size_y, size_z, palette, NULL, sink);
+}
 
-    uint32_t total_vertex_count = 0;
-    uint32_t total_index_count = 0;
-    for (int32_t k = 0; k < (int32_t)size_z; k++)
-    {
-        const float min_z = (float)k;
-        const float max_z = min_z + 1.0f;
-        for (int32_t j = 0; j < (int32_t)size_y; j++)
-        {
-            const float min_y = (float)j;
-            const float max_y = min_y + 1.0f;
-            for (int32_t i = 0; i < (int32_t)size_x; i++, current_voxel++)
-            {
-                // current voxel slot is empty? skip it.
-                if (current_voxel[0] == 0)
-                    continue;
+// the largest batch that ogt_stream_from_paletted_voxels_simple_batched allocates, which is about 150MB.
+static const uint32_t k_max_batch_face_count = 1 << 20;
 
-                ogt_mesh_rgba color = palette[ current_voxel[0]];
-                
-                // determine the min/max coords of the voxel for each dimension.
-                const float min_x = (float)i;
-                const float max_x = min_x + 1.0f;
-
-                // determine which faces we need to generate
-                uint32_t neg_x = ((i == 0)       || (current_voxel[-k_stride_x] == 0));
-                uint32_t pos_x = ((i == k_max_x) || (current_voxel[ k_stride_x] == 0));
-                uint32_t neg_y = ((j == 0)       || (current_voxel[-k_stride_y] == 0));
-                uint32_t pos_y = ((j == k_max_y) || (current_voxel[ k_stride_y] == 0));
-                uint32_t neg_z = ((k == 0)       || (current_voxel[-k_stride_z] == 0));
-                uint32_t pos_z = ((k == k_max_z) || (current_voxel[ k_stride_z] == 0));
-
-                // count the number of faces. skip if zero.
-                const uint32_t face_count_needed = (neg_x + pos_x + neg_y + pos_y + neg_z + pos_z);
-                if (!face_count_needed)
-                    continue;
+// streams geometry in batches of up to batch_face_count faces to a specified user function.
+void ogt_stream_from_paletted_voxels_simple_batched(
+    const ogt_voxel_meshify_context* ctx,
+    const uint8_t* voxels, uint32_t size_x, uint32_t size_y, uint32_t size_z, const ogt_mesh_rgba* palette,
+    uint32_t batch_face_count, ogt_voxel_simple_batch_stream_func stream_func, void* stream_func_data)
+{
+    assert(stream_func);
+    // we need to be able to hold all the faces of a single voxel in a batch, and the batch size must fit in memory.
+    if (!batch_face_count)
+        batch_face_count = 4096;
+    if (batch_face_count < 6)
+        batch_face_count = 6;
+    if (batch_face_count > k_max_batch_face_count)
+        batch_face_count = k_max_batch_face_count;
+
+    size_t batch_size = ((size_t)batch_face_count * 4 * sizeof(ogt_mesh_vertex)) + ((size_t)batch_face_count * 6 * sizeof(uint32_t));
+    ogt_mesh_scratch_mark scratch_mark = _scratch_begin(ctx);
+    ogt_mesh_vertex* batch_vertices = (ogt_mesh_vertex*)_scratch_alloc(ctx, batch_size);
+    if (batch_vertices) {
+        ogt_mesh_voxel_model grid;
+        grid.voxels = voxels;
+        grid.size_x = size_x;
+        grid.size_y = size_y;
+        grid.size_z = size_z;
+        ogt_mesh_simple_batch_sink sink;
+        sink.stream_func      = stream_func;
+        sink.stream_func_data = stream_func_data;
+        sink.vertices         = batch_vertices;
+        sink.indices          = (uint32_t*)&batch_vertices[(size_t)batch_face_count * 4];
+        sink.max_face_count   = batch_face_count;
+        sink.face_count       = 0;
+        _simple_meshify_voxels(voxels, size_x, size_y, size_z, palette, _get_ao_grid(ctx, grid), sink);
+        sink.flush();
+        _scratch_free(ctx, batch_vertices);
+    }
+    _scratch_end(ctx, scratch_mark);
+}
 
-                // generate geometry for this voxel to a local buffer first.
-                ogt_mesh_vertex  local_vertex[24];
-                uint32_t         local_index[36];
-                ogt_mesh_vertex* current_vertex = local_vertex;
-                uint32_t*        current_index  = local_index;
 
-                // -X direction face
-                if (neg_x)
-                {
-                    current_vertex[0] = _mesh_make_vertex( min_x, min_y, min_z, -1.0f, 0.0f, 0.0f, color, current_voxel[0] );
-                    current_vertex[1] = _mesh_make_vertex( min_x, max_y, min_z, -1.0f, 0.0f, 0.0f, color, current_voxel[0] );
-                    current_vertex[2] = _mesh_make_vertex( min_x, max_y, max_z, -1.0f, 0.0f, 0.0f, color, current_voxel[0] );
-                    current_vertex[3] = _mesh_make_vertex( min_x, min_y, max_z, -1.0f, 0.0f, 0.0f, color, current_voxel[0] );
-                    current_index[0] = total_vertex_count + 2;
-                    current_index[1] = total_vertex_count + 1;
-                    current_index[2] = total_vertex_count + 0;
-                    current_index[3] = total_vertex_count + 0;
-                    current_index[4] = total_vertex_count + 3;
-                    current_index[5] = total_vertex_count + 2;
-                    total_vertex_count += 4;
-                    total_index_count  += 6;
-                    current_vertex += 4;
-                    current_index += 6;
-                }
-                
-                // +X direction face
-                if (pos_x)
-                {
-                    current_vertex[0] = _mesh_make_vertex( max_x, min_y, min_z, 1.0f, 0.0f, 0.0f, color, current_voxel[0] );
-                    current_vertex[1] = _mesh_make_vertex( max_x, max_y, min_z, 1.0f, 0.0f, 0.0f, color, current_voxel[0] );
-                    current_vertex[2] = _mesh_make_vertex( max_x, max_y, max_z, 1.0f, 0.0f, 0.0f, color, current_voxel[0] );
-                    current_vertex[3] = _mesh_make_vertex( max_x, min_y, max_z, 1.0f, 0.0f, 0.0f, color, current_voxel[0] );
-                    current_index[0] = total_vertex_count + 0;
-                    current_index[1] = total_vertex_count + 1;
-                    current_index[2] = total_vertex_count + 2;
-                    current_index[3] = total_vertex_count + 2;
-                    current_index[4] = total_vertex_count + 3;
-                    current_index[5] = total_vertex_count + 0;
-                    total_vertex_count += 4;
-                    total_index_count  += 6;
-                    current_vertex += 4;
-                    current_index += 6;
-                }
-                
-                // -Y direction face
-                if (neg_y)
-                {
-                    current_vertex[0] = _mesh_make_vertex( min_x, min_y, min_z, 0.0f,-1.0f, 0.0f, color, current_voxel[0] );
-                    current_vertex[1] = _mesh_make_vertex( max_x, min_y, min_z, 0.0f,-1.0f, 0.0f, color, current_voxel[0] );
-                    current_vertex[2] = _mesh_make_vertex( max_x, min_y, max_z, 0.0f,-1.0f, 0.0f, color, current_voxel[0] );
-                    current_vertex[3] = _mesh_make_vertex( min_x, min_y, max_z, 0.0f,-1.0f, 0.0f, color, current_voxel[0] );
-                    current_index[0] = total_vertex_count + 0;
-                    current_index[1] = total_vertex_count + 1;
-                    current_index[2] = total_vertex_count + 2;
-                    current_index[3] = total_vertex_count + 2;
-                    current_index[4] = total_vertex_count + 3;
-                    current_index[5] = total_vertex_count + 0;
-                    total_vertex_count += 4;
-                    total_index_count  += 6;
-                    current_vertex += 4;
-                    current_index += 6;
-                }
-                // +Y direction face
-                if (pos_y)
-                {
-                    current_vertex[0] = _mesh_make_vertex( min_x, max_y, min_z, 0.0f, 1.0f, 0.0f, color, current_voxel[0] );
-                    current_vertex[1] = _mesh_make_vertex( max_x, max_y, min_z, 0.0f, 1.0f, 0.0f, color, current_voxel[0] );
-                    current_vertex[2] = _mesh_make_vertex( max_x, max_y, max_z, 0.0f, 1.0f, 0.0f, color, current_voxel[0] );
-                    current_vertex[3] = _mesh_make_vertex( min_x, max_y, max_z, 0.0f, 1.0f, 0.0f, color, current_voxel[0] );
-                    current_index[0] = total_vertex_count + 2;
-                    current_index[1] = total_vertex_count + 1;
-                    current_index[2] = total_vertex_count + 0;
-                    current_index[3] = total_vertex_count + 0;
-                    current_index[4] = total_vertex_count + 3;
-                    current_index[5] = total_vertex_count + 2;
-                    total_vertex_count += 4;
-                    total_index_count  += 6;
-                    current_vertex += 4;
-                    current_index += 6;
-               }
-                // -Z direction face
-                if (neg_z)
-                {
-                    current_vertex[0] = _mesh_make_vertex( min_x, min_y, min_z, 0.0f, 0.0f,-1.0f, color, current_voxel[0] );
-                    current_vertex[1] = _mesh_make_vertex( max_x, min_y, min_z, 0.0f, 0.0f,-1.0f, color, current_voxel[0] );
-                    current_vertex[2] = _mesh_make_vertex( max_x, max_y, min_z, 0.0f, 0.0f,-1.0f, color, current_voxel[0] );
-                    current_vertex[3] = _mesh_make_vertex( min_x, max_y, min_z, 0.0f, 0.0f,-1.0f, color, current_voxel[0] );
-                    current_index[0] = total_vertex_count + 2;
-                    current_index[1] = total_vertex_count + 1;
-                    current_index[2] = total_vertex_count + 0;
-                    current_index[3] = total_vertex_count + 0;
-                    current_index[4] = total_vertex_count + 3;
-                    current_index[5] = total_vertex_count + 2;
-                    total_vertex_count += 4;
-                    total_index_count  += 6;
-                    current_vertex += 4;
-                    current_index += 6;
-                }
-                // +Z direction face
-                if (pos_z)
+// a slot at a corner of the voxel grid that refers to a vertex that has already been generated at that corner.
+struct ogt_mesh_corner_slot {
+    uint32_t key;           // (z << 8) | palette_index of the vertex. 
+    uint32_t vertex_index;  // index of the vertex in the output mesh.
+};
+
+// finds the vertex within a corner's slots that matches the specified key, or adds a new vertex to the mesh and 
+// to the slots if none match. Slots with a key from a different z are stale, and can be reused. Each corner is 
+// shared by at most 4 faces in the same direction, so 4 slots are always enough. The ao at a corner is the same for
+// all faces in the same direction, so it doesn't need to be part of the key.
+static inline uint32_t _get_shared_corner_vertex(ogt_mesh_corner_slot* slots, uint32_t key, ogt_mesh* out_mesh, 
+    float x, float y, float z, const ogt_mesh_vec3& normal, const ogt_mesh_rgba& color, uint8_t color_index, const ogt_mesh_voxel_model* ao_grid)
+{
+    uint32_t free_slot = 4;
+    for (uint32_t s = 0; s < 4; s++) {
+        if (slots[s].key == key)
+            return slots[s].vertex_index;
+        if (free_slot == 4 && (slots[s].key >> 8) != (key >> 8))
+            free_slot = s;
+    }
+    assert(free_slot < 4);
+    uint32_t vertex_index = out_mesh->vertex_count++;
+    out_mesh->vertices[vertex_index] = _mesh_make_vertex(_make_vec3(x, y, z), normal, color, color_index);
+    if (ao_grid)
+        _set_vertex_ao(*ao_grid, out_mesh->vertices[vertex_index]);
+    slots[free_slot].key          = key;
+    slots[free_slot].vertex_index = vertex_index;
+    return vertex_index;
+}
+
+// generates the faces of the simple meshifier into mesh, sharing vertices between faces. The mesh must have room for 4 vertices 
+// and 6 indices per simple face, where direction_face_counts is the number of simple faces in each ogt_mesh_direction.  
+// Returns false if temporary memory could not be allocated.
+static bool _simple_shared_meshify_voxels(
+    const ogt_voxel_meshify_context* ctx,
+    const uint8_t* voxels, uint32_t size_x, uint32_t size_y, uint32_t size_z, const ogt_mesh_rgba* palette, 
+    const uint32_t* direction_face_counts, ogt_mesh* mesh)
+{
+    assert(size_z < (1 << 24) - 1);  // corner z goes up to size_z and must fit the slot key, where (0xFFFFFF << 8) | 255 is the empty slot key.
+    mesh->vertex_count = 0;
+    mesh->index_count  = 0;
+
+    // Vertices of faces in each of the 6 face directions are tracked separately in a table of slots at the grid corners.  
+    // Faces of voxels in slice k only touch corners at z=k and z=k+1, so each table only needs 2 layers of corners, and 
+    // we can alternate between them based on z.
+    const uint32_t corners_x = size_x + 1;
+    const uint32_t corners_y = size_y + 1;
+    const uint32_t slots_per_table = corners_x * corners_y * 2 * 4;
+    ogt_mesh_scratch_mark scratch_mark = _scratch_begin(ctx);
+    ogt_mesh_corner_slot* corner_slots = (ogt_mesh_corner_slot*)_scratch_alloc(ctx, 6 * slots_per_table * sizeof(ogt_mesh_corner_slot));
+    if (!corner_slots) {
+        _scratch_end(ctx, scratch_mark);
+        return false;
+    }
+    memset(corner_slots, 0xFF, 6 * slots_per_table * sizeof(ogt_mesh_corner_slot));
+    
+    ogt_mesh_corner_slot* neg_x_slots = &corner_slots[0 * slots_per_table];
+    ogt_mesh_corner_slot* pos_x_slots = &corner_slots[1 * slots_per_table];
+    ogt_mesh_corner_slot* neg_y_slots = &corner_slots[2 * slots_per_table];
+    ogt_mesh_corner_slot* pos_y_slots = &corner_slots[3 * slots_per_table];
+    ogt_mesh_corner_slot* neg_z_slots = &corner_slots[4 * slots_per_table];
+    ogt_mesh_corner_slot* pos_z_slots = &corner_slots[5 * slots_per_table];
+
+    const ogt_mesh_vec3 neg_x_normal = _make_vec3(-1.0f, 0.0f, 0.0f);
+    const ogt_mesh_vec3 pos_x_normal = _make_vec3( 1.0f, 0.0f, 0.0f);
+    const ogt_mesh_vec3 neg_y_normal = _make_vec3( 0.0f,-1.0f, 0.0f);
+    const ogt_mesh_vec3 pos_y_normal = _make_vec3( 0.0f, 1.0f, 0.0f);
+    const ogt_mesh_vec3 neg_z_normal = _make_vec3( 0.0f, 0.0f,-1.0f);
+    const ogt_mesh_vec3 pos_z_normal = _make_vec3( 0.0f, 0.0f, 1.0f);
+
+    const uint32_t k_stride_y = size_x;
+    const uint32_t k_stride_z = size_x * size_y;
+    ogt_mesh_voxel_model grid;
+    grid.voxels = voxels;
+    grid.size_x = size_x;
+    grid.size_y = size_y;
+    grid.size_z = size_z;
+    const ogt_mesh_voxel_model* ao_grid = _get_ao_grid(ctx, grid);
+
+#define CORNER_INDEX(_x,_y,_z)      ((((_z) & 1) * corners_y + (_y)) * corners_x + (_x)) * 4
+#define CORNER_KEY(_z)              (((_z) << 8) | color_index)
+#define SHARED_VERTEX(_slots,_x,_y,_z,_normal)  _get_shared_corner_vertex(&_slots[CORNER_INDEX(_x,_y,_z)], CORNER_KEY(_z), mesh, (float)(_x), (float)(_y), (float)(_z), _normal, color, color_index, ao_grid)
+
+    // the indices of each direction go to their own range of the index buffer.
+    uint32_t* direction_index_cursors[ogt_mesh_direction_count];
+    _init_direction_ranges(mesh, direction_face_counts, direction_index_cursors);
+    uint32_t*& neg_x_indices = direction_index_cursors[ogt_mesh_direction_neg_x];
+    uint32_t*& pos_x_indices = direction_index_cursors[ogt_mesh_direction_pos_x];
+    uint32_t*& neg_y_indices = direction_index_cursors[ogt_mesh_direction_neg_y];
+    uint32_t*& pos_y_indices = direction_index_cursors[ogt_mesh_direction_pos_y];
+    uint32_t*& neg_z_indices = direction_index_cursors[ogt_mesh_direction_neg_z];
+    uint32_t*& pos_z_indices = direction_index_cursors[ogt_mesh_direction_pos_z];
+
+    for (uint32_t k = 0; k < size_z; k++)
+    {
+        for (uint32_t j = 0; j < size_y; j++)
+        {
+            for (uint32_t run_start = 0; run_start < size_x; run_start += 64)
+            {
+                // determine which faces we need to generate for the next 64 voxels along the row, and only visit
+                // the voxels that need at least one face.
+                uint32_t run_count = (size_x - run_start) < 64 ? (size_x - run_start) : 64;
+                ogt_mesh_face_masks face_masks = _get_voxel_face_masks(voxels, size_x, size_y, size_z, run_start, j, k, run_count);
+                uint64_t visible_voxels = face_masks.neg_x | face_masks.pos_x | face_masks.neg_y | face_masks.pos_y | face_masks.neg_z | face_masks.pos_z;
+                while (visible_voxels)
                 {
-                    current_vertex[0] = _mesh_make_vertex( min_x, min_y, max_z, 0.0f, 0.0f, 1.0f, color, current_voxel[0] );
-                    current_vertex[1] = _mesh_make_vertex( max_x, min_y, max_z, 0.0f, 0.0f, 1.0f, color, current_voxel[0] );
-                    current_vertex[2] = _mesh_make_vertex( max_x, max_y, max_z, 0.0f, 0.0f, 1.0f, color, current_voxel[0] );
-                    current_vertex[3] = _mesh_make_vertex( min_x, max_y, max_z, 0.0f, 0.0f, 1.0f, color, current_voxel[0] );
-                    current_index[0] = total_vertex_count + 0;
-                    current_index[1] = total_vertex_count + 1;
-                    current_index[2] = total_vertex_count + 2;
-                    current_index[3] = total_vertex_count + 2;
-                    current_index[4] = total_vertex_count + 3;
-                    current_index[5] = total_vertex_count + 0;
-                    total_vertex_count += 4;
-                    total_index_count  += 6;
-                    current_vertex += 4;
-                    current_index += 6;
+                    uint32_t bit = _bit_scan_forward64(visible_voxels);
+                    visible_voxels &= visible_voxels - 1;
+
+                    const uint32_t i = run_start + bit;
+                    const uint8_t  color_index = voxels[i + (j * k_stride_y) + (k * k_stride_z)];
+                    const ogt_mesh_rgba color = palette[color_index];
+                    const uint32_t face_flags = _get_voxel_face_flags(face_masks, bit);
+
+                    // the corners and winding of each face matches that of _simple_meshify_voxel.
+                    if (face_flags & k_voxel_face_neg_x) {
+                        uint32_t v0 = SHARED_VERTEX(neg_x_slots, i, j  , k  , neg_x_normal);
+                        uint32_t v1 = SHARED_VERTEX(neg_x_slots, i, j+1, k  , neg_x_normal);
+                        uint32_t v2 = SHARED_VERTEX(neg_x_slots, i, j+1, k+1, neg_x_normal);
+                        uint32_t v3 = SHARED_VERTEX(neg_x_slots, i, j  , k+1, neg_x_normal);
+                        neg_x_indices[0] = v2; neg_x_indices[1] = v1; neg_x_indices[2] = v0;
+                        neg_x_indices[3] = v0; neg_x_indices[4] = v3; neg_x_indices[5] = v2;
+                        neg_x_indices += 6;
+                        if (ao_grid)
+                            _orient_quad_for_ao(neg_x_indices - 6, mesh->vertices, 0);
+                    }
+                    if (face_flags & k_voxel_face_pos_x) {
+                        uint32_t v0 = SHARED_VERTEX(pos_x_slots, i+1, j  , k  , pos_x_normal);
+                        uint32_t v1 = SHARED_VERTEX(pos_x_slots, i+1, j+1, k  , pos_x_normal);
+                        uint32_t v2 = SHARED_VERTEX(pos_x_slots, i+1, j+1, k+1, pos_x_normal);
+                        uint32_t v3 = SHARED_VERTEX(pos_x_slots, i+1, j  , k+1, pos_x_normal);
+                        pos_x_indices[0] = v0; pos_x_indices[1] = v1; pos_x_indices[2] = v2;
+                        pos_x_indices[3] = v2; pos_x_indices[4] = v3; pos_x_indices[5] = v0;
+                        pos_x_indices += 6;
+                        if (ao_grid)
+                            _orient_quad_for_ao(pos_x_indices - 6, mesh->vertices, 0);
+                    }
+                    if (face_flags & k_voxel_face_neg_y) {
+                        uint32_t v0 = SHARED_VERTEX(neg_y_slots, i  , j, k  , neg_y_normal);
+                        uint32_t v1 = SHARED_VERTEX(neg_y_slots, i+1, j, k  , neg_y_normal);
+                        uint32_t v2 = SHARED_VERTEX(neg_y_slots, i+1, j, k+1, neg_y_normal);
+                        uint32_t v3 = SHARED_VERTEX(neg_y_slots, i  , j, k+1, neg_y_normal);
+                        neg_y_indices[0] = v0; neg_y_indices[1] = v1; neg_y_indices[2] = v2;
+                        neg_y_indices[3] = v2; neg_y_indices[4] = v3; neg_y_indices[5] = v0;
+                        neg_y_indices += 6;
+                        if (ao_grid)
+                            _orient_quad_for_ao(neg_y_indices - 6, mesh->vertices, 0);
+                    }
+                    if (face_flags & k_voxel_face_pos_y) {
+                        uint32_t v0 = SHARED_VERTEX(pos_y_slots, i  , j+1, k  , pos_y_normal);
+                        uint32_t v1 = SHARED_VERTEX(pos_y_slots, i+1, j+1, k  , pos_y_normal);
+                        uint32_t v2 = SHARED_VERTEX(pos_y_slots, i+1, j+1, k+1, pos_y_normal);
+                        uint32_t v3 = SHARED_VERTEX(pos_y_slots, i  , j+1, k+1, pos_y_normal);
+                        pos_y_indices[0] = v2; pos_y_indices[1] = v1; pos_y_indices[2] = v0;
+                        pos_y_indices[3] = v0; pos_y_indices[4] = v3; pos_y_indices[5] = v2;
+                        pos_y_indices += 6;
+                        if (ao_grid)
+                            _orient_quad_for_ao(pos_y_indices - 6, mesh->vertices, 0);
+                    }
+                    if (face_flags & k_voxel_face_neg_z) {
+                        uint32_t v0 = SHARED_VERTEX(neg_z_slots, i  , j  , k, neg_z_normal);
+                        uint32_t v1 = SHARED_VERTEX(neg_z_slots, i+1, j  , k, neg_z_normal);
+                        uint32_t v2 = SHARED_VERTEX(neg_z_slots, i+1, j+1, k, neg_z_normal);
+                        uint32_t v3 = SHARED_VERTEX(neg_z_slots, i  , j+1, k, neg_z_normal);
+                        neg_z_indices[0] = v2; neg_z_indices[1] = v1; neg_z_indices[2] = v0;
+                        neg_z_indices[3] = v0; neg_z_indices[4] = v3; neg_z_indices[5] = v2;
+                        neg_z_indices += 6;
+                        if (ao_grid)
+                            _orient_quad_for_ao(neg_z_indices - 6, mesh->vertices, 0);
+                    }
+                    if (face_flags & k_voxel_face_pos_z) {
+                        uint32_t v0 = SHARED_VERTEX(pos_z_slots, i  , j  , k+1, pos_z_normal);
+                        uint32_t v1 = SHARED_VERTEX(pos_z_slots, i+1, j  , k+1, pos_z_normal);
+                        uint32_t v2 = SHARED_VERTEX(pos_z_slots, i+1, j+1, k+1, pos_z_normal);
+                        uint32_t v3 = SHARED_VERTEX(pos_z_slots, i  , j+1, k+1, pos_z_normal);
+                        pos_z_indices[0] = v0; pos_z_indices[1] = v1; pos_z_indices[2] = v2;
+                        pos_z_indices[3] = v2; pos_z_indices[4] = v3; pos_z_indices[5] = v0;
+                        pos_z_indices += 6;
+                        if (ao_grid)
+                            _orient_quad_for_ao(pos_z_indices - 6, mesh->vertices, 0);
+                    }
                 }
-
-                // geometry for this voxel is provided to a caller-specified stream function/callback
-                stream_func(i, j, k, local_vertex, face_count_needed*4, local_index, face_count_needed*6, stream_func_data);
             }
         }
-    }	
+    }
 
-}
+#undef CORNER_INDEX
+#undef CORNER_KEY
+#undef SHARED_VERTEX
 
+    mesh->index_count = (uint32_t)(direction_index_cursors[ogt_mesh_direction_count - 1] - mesh->indices);
+    _scratch_free(ctx, corner_slots);
+    _scratch_end(ctx, scratch_mark);
+    return true;
+}
 
-// The base algorithm that is used here, is as follows:
-// On a per slice basis, we find a voxel that has not yet been polygonized. We then try to 
-// grow a rectangle from that voxel within the slice that can be represented by a polygon.
-// We create the quad polygon to represent the voxel, mark the voxels in the slice that are
-// covered by the rectangle as having been polygonized, and continue on the search through 
-// the rest of the slice.
-void _greedy_meshify_voxels_in_face_direction(
-    const uint8_t* voxels,
-    const ogt_mesh_rgba* palette,
-    int32_t size_x, int32_t size_y, int32_t size_z,                // how many voxels in each of X,Y,Z dimensions
-    int32_t k_stride_x, int32_t k_stride_y, int32_t k_stride_z,            // the memory stride for each of those X,Y,Z dimensions within the voxel data.
-    const ogt_mesh_transform& transform,                                    // transform to convert from X,Y,Z to "objectSpace"
-    ogt_mesh* out_mesh)
+// constructs and returns a mesh from the specified voxel grid with the same faces as the simple meshifier, but with vertices shared between faces.
+ogt_mesh* ogt_mesh_from_paletted_voxels_simple_shared(
+    const ogt_voxel_meshify_context* ctx,
+    const uint8_t* voxels, uint32_t size_x, uint32_t size_y, uint32_t size_z, const ogt_mesh_rgba* palette)
 {
+    uint32_t direction_face_counts[ogt_mesh_direction_count];
+    uint32_t max_face_count   = _count_voxel_sized_faces_per_direction( voxels, size_x, size_y, size_z, direction_face_counts );
+    uint32_t max_vertex_count = max_face_count * 4;
+    uint32_t max_index_count  = max_face_count * 6;
 
-    // enable aggressive voxel optimization for now.
-    uint32_t max_voxels_per_slice = size_x * size_y;
-
-    // allocate a structure that is used for tracking which voxels in a slice have already been included in output mesh.
-    assert(max_voxels_per_slice <= 65536);	// 
-    ogt_mesh_bitset_64k voxel_polygonized;
+    uint32_t mesh_size = sizeof(ogt_mesh) + (max_vertex_count * sizeof(ogt_mesh_vertex)) + (max_index_count * sizeof(uint32_t));
+    ogt_mesh* mesh = (ogt_mesh*)_voxel_meshify_malloc(ctx, mesh_size);
+    if (!mesh)
+        return NULL;
 
-    ogt_mesh_vec3 normal = _transform_vector(transform, _make_vec3(0.0f, 0.0f, 1.0f));
+    mesh->vertices = (ogt_mesh_vertex*)&mesh[1];
+    mesh->indices  = (uint32_t*)&mesh->vertices[max_vertex_count];
+    if (!_simple_shared_meshify_voxels(ctx, voxels, size_x, size_y, size_z, palette, direction_face_counts, mesh)) {
+        _voxel_meshify_free(ctx, mesh);
+        return NULL;
+    }
 
-#define VOXELDATA_INDEX(_x,_y,_z)        ((_x) * k_stride_x) + ((_y) * k_stride_y) + ((_z) * k_stride_z)
-#define LOCALDATA_INDEX(_x,_y)            ((_x) + ((_y) * size_x))
+    assert( mesh->vertex_count <= max_vertex_count);
+    assert( mesh->index_count == max_index_count);
+    return mesh;
+}
 
-    uint32_t* index_data         = &out_mesh->indices[out_mesh->index_count];
-    ogt_mesh_vertex* vertex_data = &out_mesh->vertices[out_mesh->vertex_count];
 
-    // determine if the transform parity has flipped in a way that winding would have been switched.
-    const ogt_mesh_vec3* side = _make_vec3_ptr(&transform.m00);
-    const ogt_mesh_vec3* up   = _make_vec3_ptr(&transform.m10);
-    const ogt_mesh_vec3* fwd  = _make_vec3_ptr(&transform.m20);
-    bool is_parity_flipped = _dot3(*fwd, _cross3(*side, *up)) < 0.0f;
+// how many slices are transposed into contiguous memory at a time when a face direction's slices are not contiguous.
+static const int32_t k_voxel_slab_slice_count = 16;
+
+// Provides each slice of voxels in a face direction as contiguous memory, where voxel (i,j) of the slice is at [i + j*size_x].
+// The +Z/-Z directions already are laid out like that, so slices come directly from the voxel data. For the other directions, 
+// slabs of k_voxel_slab_slice_count slices are copied into contiguous scratch memory with a transpose, so meshing runs on 
+// unit-stride memory instead of striding through the whole voxel grid for every slice. 
+struct ogt_mesh_voxel_slices {
+    const uint8_t*  voxels;
+    int32_t         size_x, size_y, size_z;
+    int32_t         stride_x, stride_y, stride_z;
+    uint8_t*        slab;               // transposed slices, or NULL if slices come directly from voxels.
+    int32_t         slab_slice_stride;  // bytes between slices in the slab. Padded so that slices don't alias in the cache.
+    int32_t         slab_first_slice;   // the first slice that is in the slab
+    int32_t         slab_slice_count;   // the number of slices in the slab
+};
+
+// copies slice_count slices starting at src into dst, where each slice is slice_stride bytes apart.
+static void _transpose_voxel_slices(uint8_t* dst, int32_t slice_stride, const uint8_t* src, int32_t size_x, int32_t size_y, int32_t slice_count, int32_t stride_x, int32_t stride_y, int32_t stride_z) {
+    // transpose in 16x16 blocks so both the reads and the writes of a block stay in cache.
+    const int32_t k_block_size = 16;
+    if (stride_z == 1 || stride_z == -1) {
+        // each voxel row in memory runs across the slices, so blocks are over (i,k) for each row j. 
+        for (int32_t j = 0; j < size_y; j++) {
+            for (int32_t i0 = 0; i0 < size_x; i0 += k_block_size) {
+                int32_t i1 = (i0 + k_block_size) < size_x ? (i0 + k_block_size) : size_x;
+                for (int32_t k = 0; k < slice_count; k++) {
+                    const uint8_t* src_row = &src[(j * stride_y) + (k * stride_z)];
+                    uint8_t*       dst_row = &dst[(k * slice_stride) + (j * size_x)];
+                    for (int32_t i = i0; i < i1; i++)
+                        dst_row[i] = src_row[i * stride_x];
+                }
+            }
+        }
+    }
+    else if (stride_y == 1 || stride_y == -1) {
+        // each voxel row in memory runs along the j axis of the slice, so blocks are over (i,j) for each slice k.
+        for (int32_t k = 0; k < slice_count; k++) {
+            const uint8_t* src_slice = &src[k * stride_z];
+            uint8_t*       dst_slice = &dst[k * slice_stride];
+            for (int32_t i0 = 0; i0 < size_x; i0 += k_block_size) {
+                int32_t i1 = (i0 + k_block_size) < size_x ? (i0 + k_block_size) : size_x;
+                for (int32_t j0 = 0; j0 < size_y; j0 += k_block_size) {
+                    int32_t j1 = (j0 + k_block_size) < size_y ? (j0 + k_block_size) : size_y;
+                    for (int32_t i = i0; i < i1; i++)
+                        for (int32_t j = j0; j < j1; j++)
+                            dst_slice[i + (j * size_x)] = src_slice[(i * stride_x) + (j * stride_y)];
+                }
+            }
+        }
+    }
+    else {
+        for (int32_t k = 0; k < slice_count; k++)
+            for (int32_t j = 0; j < size_y; j++)
+                for (int32_t i = 0; i < size_x; i++)
+                    dst[(k * slice_stride) + i + (j * size_x)] = src[(i * stride_x) + (j * stride_y) + (k * stride_z)];
+    }
+}
+
+// sets up access to slices. If the slices are not contiguous, this allocates a slab from scratch memory and returns false if that fails.
+static bool _voxel_slices_init(const ogt_voxel_meshify_context* ctx, ogt_mesh_voxel_slices& slices, const uint8_t* voxels, 
+    int32_t size_x, int32_t size_y, int32_t size_z, int32_t stride_x, int32_t stride_y, int32_t stride_z) 
+{
+    slices.voxels           = voxels;
+    slices.size_x           = size_x;
+    slices.size_y           = size_y;
+    slices.size_z           = size_z;
+    slices.stride_x         = stride_x;
+    slices.stride_y         = stride_y;
+    slices.stride_z         = stride_z;
+    slices.slab             = NULL;
+    slices.slab_slice_stride = 0;
+    slices.slab_first_slice = 0;
+    slices.slab_slice_count = 0;
+    if (stride_x == 1 && stride_y == size_x)
+        return true;
+    // the slab holds one extra slice so the next slice is always available alongside the current one.
+    slices.slab_slice_stride = ((size_x * size_y + 63) & ~63) + 64;
+    slices.slab = (uint8_t*)_scratch_alloc(ctx, (size_t)slices.slab_slice_stride * (k_voxel_slab_slice_count + 1));
+    return slices.slab != NULL;
+}
+
+static void _voxel_slices_free(const ogt_voxel_meshify_context* ctx, ogt_mesh_voxel_slices& slices) {
+    _scratch_free(ctx, slices.slab);
+}
+
+// gets contiguous memory for slice k and the slice after it, or NULL for the slice after the last one. Slices must be 
+// requested in ascending order.
+static void _voxel_slices_get(ogt_mesh_voxel_slices& slices, int32_t k, const uint8_t** slice, const uint8_t** next_slice) {
+    const bool is_last_slice = (k + 1) == slices.size_z;
+    if (!slices.slab) {
+        *slice      = &slices.voxels[k * slices.stride_z];
+        *next_slice = !is_last_slice ? &slices.voxels[(k + 1) * slices.stride_z] : NULL;
+        return;
+    }
+    int32_t last_needed_slice = is_last_slice ? k : k + 1;
+    if (last_needed_slice >= slices.slab_first_slice + slices.slab_slice_count) {
+        int32_t slice_count = (slices.size_z - k) < (k_voxel_slab_slice_count + 1) ? (slices.size_z - k) : (k_voxel_slab_slice_count + 1);
+        _transpose_voxel_slices(slices.slab, slices.slab_slice_stride, &slices.voxels[k * slices.stride_z], slices.size_x, slices.size_y, slice_count, 
+            slices.stride_x, slices.stride_y, slices.stride_z);
+        slices.slab_first_slice = k;
+        slices.slab_slice_count = slice_count;
+    }
+    *slice      = &slices.slab[(k - slices.slab_first_slice) * slices.slab_slice_stride];
+    *next_slice = !is_last_slice ? *slice + slices.slab_slice_stride : NULL;
+}
+
+// meshes the faces of voxels that point in a single face direction. X,Y,Z are local to the face direction. ao_grid is the 
+// whole voxel grid when vertex ao should be computed, or NULL otherwise.
+typedef void (*ogt_mesh_face_direction_func)(const ogt_voxel_meshify_context* ctx, const uint8_t* voxels, const ogt_mesh_rgba* palette,
+    int32_t size_x, int32_t size_y, int32_t size_z, int32_t k_stride_x, int32_t k_stride_y, int32_t k_stride_z,
+    const ogt_mesh_face_direction& direction, const ogt_mesh_voxel_model* ao_grid, ogt_mesh* mesh);
+
+// invokes the face direction mesher for each of the six face directions with the local sizes and strides of that direction, 
+// and records the range of indices generated for each direction. For negative directions, local z starts at the far end 
+// of the grid and steps backward through it.
+static void _meshify_voxels_in_all_face_directions(
+    const ogt_voxel_meshify_context* ctx, const uint8_t* voxels, uint32_t size_x, uint32_t size_y, uint32_t size_z,
+    const ogt_mesh_rgba* palette, ogt_mesh_face_direction_func face_direction_func, ogt_mesh* mesh)
+{
+    const int32_t sizes[3]   = { (int32_t)size_x, (int32_t)size_y, (int32_t)size_z };
+    const int32_t strides[3] = { 1, (int32_t)size_x, (int32_t)(size_x * size_y) };
+    ogt_mesh_voxel_model grid;
+    grid.voxels = voxels;
+    grid.size_x = size_x;
+    grid.size_y = size_y;
+    grid.size_z = size_z;
+    for (uint32_t d = 0; d < 6; d++) {
+        const ogt_mesh_face_direction& direction = k_face_directions[d];
+        const int32_t stride_z = strides[direction.axis_z];
+        const uint8_t* first_slice = (direction.is_negative && sizes[direction.axis_z]) ? voxels + (sizes[direction.axis_z] - 1) * stride_z : voxels;
+        ogt_mesh_index_range& range = mesh->direction_ranges[_face_direction_mesh_direction(direction)];
+        range.index_offset = mesh->index_count;
+        face_direction_func(ctx, first_slice, palette, 
+            sizes[direction.axis_x], sizes[direction.axis_y], sizes[direction.axis_z],
+            strides[direction.axis_x], strides[direction.axis_y], direction.is_negative ? -stride_z : stride_z,
+            direction, _get_ao_grid(ctx, grid), mesh);
+        range.index_count = mesh->index_count - range.index_offset;
+    }
+}
+
+// computes the ao of the 4 corners of the voxel face at local i,j whose front is slice k1, packed 2 bits per corner in the 
+// order (i,j), (i+1,j), (i+1,j+1), (i,j+1).
+template <class DIRECTION>
+static inline uint8_t _greedy_face_ao(const ogt_mesh_voxel_model& grid, int32_t i, int32_t j, int32_t k1, int32_t size_z) {
+    uint8_t a0 = _voxel_corner_ao(grid, DIRECTION::k_axis_z, DIRECTION::k_is_negative, DIRECTION::point(i,     j,     k1, size_z));
+    uint8_t a1 = _voxel_corner_ao(grid, DIRECTION::k_axis_z, DIRECTION::k_is_negative, DIRECTION::point(i + 1, j,     k1, size_z));
+    uint8_t a2 = _voxel_corner_ao(grid, DIRECTION::k_axis_z, DIRECTION::k_is_negative, DIRECTION::point(i + 1, j + 1, k1, size_z));
+    uint8_t a3 = _voxel_corner_ao(grid, DIRECTION::k_axis_z, DIRECTION::k_is_negative, DIRECTION::point(i,     j + 1, k1, size_z));
+    return (uint8_t)(a0 | (a1 << 2) | (a2 << 4) | (a3 << 6));
+}
+
+// The base algorithm that is used here, is as follows:
+// On a per slice basis, we find a voxel that has not yet been polygonized. We then try to 
+// grow a rectangle from that voxel within the slice that can be represented by a polygon.
+// We create the quad polygon to represent the voxel, mark the voxels in the slice that are
+// covered by the rectangle as having been polygonized, and continue on the search through 
+// the rest of the slice. When ao is computed, a rectangle only grows over faces with the same corner ao as the first
+// face, and only in a direction along which that ao is constant, so the merged quad interpolates ao exactly as the
+// individual faces would. DIRECTION is the ogt_mesh_face_direction_t that faces point in, which maps X,Y,Z to the voxel grid.
+template <class DIRECTION>
+static void _greedy_meshify_voxels_in_face_direction_kernel(
+    const ogt_voxel_meshify_context* ctx,
+    const uint8_t* voxels,
+    const ogt_mesh_rgba* palette,
+    int32_t size_x, int32_t size_y, int32_t size_z,                // how many voxels in each of X,Y,Z dimensions
+    int32_t k_stride_x, int32_t k_stride_y, int32_t k_stride_z,            // the memory stride for each of those X,Y,Z dimensions within the voxel data.
+    const ogt_mesh_voxel_model* ao_grid,                                    // the whole voxel grid if ao should be computed, otherwise NULL.
+    ogt_mesh* out_mesh)
+{
+
+    // enable aggressive voxel optimization for now.
+    uint32_t max_voxels_per_slice = size_x * size_y;
+    if (!max_voxels_per_slice)
+        return;
+
+    // allocate a structure that is used for tracking which voxels in a slice have already been included in output mesh.
+    ogt_mesh_scratch_mark scratch_mark = _scratch_begin(ctx);
+    ogt_mesh_bitset voxel_polygonized;
+    voxel_polygonized.bits = (uint8_t*)_scratch_alloc(ctx, ogt_mesh_bitset::get_size(max_voxels_per_slice));
+    ogt_mesh_voxel_slices slices;
+    if (!voxel_polygonized.bits || !_voxel_slices_init(ctx, slices, voxels, size_x, size_y, size_z, k_stride_x, k_stride_y, k_stride_z)) {
+        _scratch_end(ctx, scratch_mark);
+        return;
+    }
+
+    const ogt_mesh_vec3 normal = DIRECTION::normal();
+
+#define LOCALDATA_INDEX(_x,_y)            ((_x) + ((_y) * size_x))
+
+    uint32_t* index_data         = &out_mesh->indices[out_mesh->index_count];
+    ogt_mesh_vertex* vertex_data = &out_mesh->vertices[out_mesh->vertex_count];
 
     for (int32_t k0 = 0; k0 < size_z; k0++) {
         // k0 = current slice, k1 = next slice
@@ -801,27 +2882,38 @@ void _greedy_meshify_voxels_in_face_direction(
         // is this the last slice? If yes, we don't check
         bool is_last_k_slice = (k1 == size_z);
 
+        // get contiguous voxel memory for both slices.
+        const uint8_t* slice0;
+        const uint8_t* slice1;
+        _voxel_slices_get(slices, k0, &slice0, &slice1);
+
         // here, we search for the first unprocessed voxel
         for (int32_t j0 = 0; j0 < size_y; j0++) {
             for (int32_t i0 = 0; i0 < size_x; i0++) {
                 // determine the polygon color index
-                uint8_t  color_index = voxels[VOXELDATA_INDEX(i0, j0, k0)];
+                uint8_t  color_index = slice0[LOCALDATA_INDEX(i0, j0)];
 
                 // this voxel doesn't need to be polygonized if...
                 if ((color_index == 0) ||                                             // (1) voxel is empty
                     voxel_polygonized.is_set(LOCALDATA_INDEX(i0, j0)) ||              // (2) voxel is already part of a polygon for the zslice.
-                    (!is_last_k_slice && voxels[VOXELDATA_INDEX(i0, j0, k1)] != 0))   // (3) voxel in the next slice (+z direction) is solid
+                    (!is_last_k_slice && slice1[LOCALDATA_INDEX(i0, j0)] != 0))       // (3) voxel in the next slice (+z direction) is solid
                 {
                     continue;
                 }
 
+                // the corner ao of this face, and whether it is constant along i (grow_i) and along j (grow_j).
+                uint8_t face_ao = ao_grid ? _greedy_face_ao<DIRECTION>(*ao_grid, i0, j0, k1, size_z) : 0xFF;
+                bool grow_i = ((face_ao & 3) == ((face_ao >> 2) & 3)) && (((face_ao >> 6) & 3) == ((face_ao >> 4) & 3));
+                bool grow_j = ((face_ao & 3) == ((face_ao >> 6) & 3)) && (((face_ao >> 2) & 3) == ((face_ao >> 4) & 3));
+
                 // compute i1. This is the coord bounding the longest span of identical voxels in the +i direction.
                 int32_t i1 = i0 + 1;
-                for (i1 = i0 + 1; i1 < size_x; i1++) {
+                for (i1 = i0 + 1; grow_i && i1 < size_x; i1++) {
                     // stop extending i1 if...
-                    if ((voxels[VOXELDATA_INDEX(i1, j0, k0)] != color_index) ||			// (1) this voxel doesn't match the match color
+                    if ((slice0[LOCALDATA_INDEX(i1, j0)] != color_index) ||			    // (1) this voxel doesn't match the match color
                         (voxel_polygonized.is_set(LOCALDATA_INDEX(i1, j0))) ||          // (2) voxel is already part of a polygon for the zslice
-                        (!is_last_k_slice && voxels[VOXELDATA_INDEX(i1, j0, k1)] != 0)) // (3) voxel in the next slice (+z direction) is solid
+                        (!is_last_k_slice && slice1[LOCALDATA_INDEX(i1, j0)] != 0) ||   // (3) voxel in the next slice (+z direction) is solid
+                        (ao_grid && _greedy_face_ao<DIRECTION>(*ao_grid, i1, j0, k1, size_z) != face_ao)) // (4) ao of this face differs
                     {
                         break;
                     }
@@ -830,13 +2922,14 @@ void _greedy_meshify_voxels_in_face_direction(
 
                 // compute j1. The is the coord bounding the longest span of identical voxels [i0..i1] in the +j direction
                 int32_t j1 = j0 + 1;
-                for (j1 = j0 + 1; j1 < size_y; j1++) {
+                for (j1 = j0 + 1; grow_j && j1 < size_y; j1++) {
                     bool got_j1 = false;
                     for (int32_t a = i0; a < i1; a++) {
                         // stop extending i1 if...
-                        if ((voxels[VOXELDATA_INDEX(a, j1, k0)] != color_index) ||        // (1) this voxel doesn't match the match color
+                        if ((slice0[LOCALDATA_INDEX(a, j1)] != color_index) ||            // (1) this voxel doesn't match the match color
                             (voxel_polygonized.is_set(LOCALDATA_INDEX(a,j1))) ||          // (2) voxel is already part of a polygon for the zslice
-                            (!is_last_k_slice && voxels[VOXELDATA_INDEX(a,j1,k1)] != 0))  // (3) voxel in the next slice (+z direction) is solid
+                            (!is_last_k_slice && slice1[LOCALDATA_INDEX(a,j1)] != 0) ||   // (3) voxel in the next slice (+z direction) is solid
+                            (ao_grid && _greedy_face_ao<DIRECTION>(*ao_grid, a, j1, k1, size_z) != face_ao)) // (4) ao of this face differs
                         {
                             got_j1 = true;
                             break;
@@ -853,24 +2946,23 @@ void _greedy_meshify_voxels_in_face_direction(
                     for (int32_t a = i0; a < i1; a++)
                         voxel_polygonized.set(LOCALDATA_INDEX(a,b));
 
-                // determine the min/max coords of the polygon for each dimension.
-                float min_x = (float)i0;
-                float max_x = (float)i1;
-                float min_y = (float)j0;
-                float max_y = (float)j1;
-                float max_z = (float)k1;
-
                 // cache the color
                 ogt_mesh_rgba color = palette[color_index];
 
                 // write the verts for this face
-                vertex_data[0] = _mesh_make_vertex(_transform_point(transform, _make_vec3(min_x, min_y, max_z)), normal, color, color_index);
-                vertex_data[1] = _mesh_make_vertex(_transform_point(transform, _make_vec3(max_x, min_y, max_z)), normal, color, color_index);
-                vertex_data[2] = _mesh_make_vertex(_transform_point(transform, _make_vec3(max_x, max_y, max_z)), normal, color, color_index);
-                vertex_data[3] = _mesh_make_vertex(_transform_point(transform, _make_vec3(min_x, max_y, max_z)), normal, color, color_index);
+                vertex_data[0] = _mesh_make_vertex(DIRECTION::point(i0, j0, k1, size_z), normal, color, color_index);
+                vertex_data[1] = _mesh_make_vertex(DIRECTION::point(i1, j0, k1, size_z), normal, color, color_index);
+                vertex_data[2] = _mesh_make_vertex(DIRECTION::point(i1, j1, k1, size_z), normal, color, color_index);
+                vertex_data[3] = _mesh_make_vertex(DIRECTION::point(i0, j1, k1, size_z), normal, color, color_index);
+#ifdef OGT_VOXEL_MESHIFY_VERTEX_AO
+                if (ao_grid) {
+                    for (uint32_t v = 0; v < 4; v++)
+                        vertex_data[v].ao = (face_ao >> (v * 2)) & 3;
+                }
+#endif
 
-                // reserve the index order to ensure parity/winding is still correct.
-                if (is_parity_flipped) {
+                // faces that point along a negative axis need their winding switched.
+                if (DIRECTION::k_is_negative) {
                     index_data[0] = out_mesh->vertex_count + 0;
                     index_data[1] = out_mesh->vertex_count + 3;
                     index_data[2] = out_mesh->vertex_count + 2;
@@ -886,6 +2978,8 @@ void _greedy_meshify_voxels_in_face_direction(
                     index_data[4] = out_mesh->vertex_count + 3;
                     index_data[5] = out_mesh->vertex_count + 0;
                 }
+                if (ao_grid)
+                    _orient_quad_for_ao(index_data, out_mesh->vertices, 0);
 
                 vertex_data += 4;
                 index_data  += 6;
@@ -896,9 +2990,27 @@ void _greedy_meshify_voxels_in_face_direction(
         }
     }
 
-#undef VOXELDATA_INDEX
 #undef LOCALDATA_INDEX
 
+    _voxel_slices_free(ctx, slices);
+    _scratch_free(ctx, voxel_polygonized.bits);
+    _scratch_end(ctx, scratch_mark);
+}
+
+// meshes faces that point in a single face direction with the greedy kernel that is specialized for that direction.
+static void _greedy_meshify_voxels_in_face_direction(const ogt_voxel_meshify_context* ctx, const uint8_t* voxels, const ogt_mesh_rgba* palette,
+    int32_t size_x, int32_t size_y, int32_t size_z, int32_t k_stride_x, int32_t k_stride_y, int32_t k_stride_z,
+    const ogt_mesh_face_direction& direction, const ogt_mesh_voxel_model* ao_grid, ogt_mesh* mesh)
+{
+    switch (_face_direction_mesh_direction(direction)) {
+        case ogt_mesh_direction_pos_x: _greedy_meshify_voxels_in_face_direction_kernel<ogt_mesh_face_direction_pos_x>(ctx, voxels, palette, size_x, size_y, size_z, k_stride_x, k_stride_y, k_stride_z, ao_grid, mesh); break;
+        case ogt_mesh_direction_neg_x: _greedy_meshify_voxels_in_face_direction_kernel<ogt_mesh_face_direction_neg_x>(ctx, voxels, palette, size_x, size_y, size_z, k_stride_x, k_stride_y, k_stride_z, ao_grid, mesh); break;
+        case ogt_mesh_direction_pos_y: _greedy_meshify_voxels_in_face_direction_kernel<ogt_mesh_face_direction_pos_y>(ctx, voxels, palette, size_x, size_y, size_z, k_stride_x, k_stride_y, k_stride_z, ao_grid, mesh); break;
+        case ogt_mesh_direction_neg_y: _greedy_meshify_voxels_in_face_direction_kernel<ogt_mesh_face_direction_neg_y>(ctx, voxels, palette, size_x, size_y, size_z, k_stride_x, k_stride_y, k_stride_z, ao_grid, mesh); break;
+        case ogt_mesh_direction_pos_z: _greedy_meshify_voxels_in_face_direction_kernel<ogt_mesh_face_direction_pos_z>(ctx, voxels, palette, size_x, size_y, size_z, k_stride_x, k_stride_y, k_stride_z, ao_grid, mesh); break;
+        case ogt_mesh_direction_neg_z: _greedy_meshify_voxels_in_face_direction_kernel<ogt_mesh_face_direction_neg_z>(ctx, voxels, palette, size_x, size_y, size_z, k_stride_x, k_stride_y, k_stride_z, ao_grid, mesh); break;
+        default: assert(0); break;
+    }
 }
 
 ogt_mesh* ogt_mesh_from_paletted_voxels_greedy(
@@ -919,103 +3031,7 @@ ogt_mesh* ogt_mesh_from_paletted_voxels_greedy(
     mesh->vertex_count = 0;
     mesh->index_count  = 0;
     
-    const int32_t k_stride_x = 1;
-    const int32_t k_stride_y = size_x;
-    const int32_t k_stride_z = size_x * size_y;
-    
-    // do the +y PASS
-    {
-        ogt_mesh_transform transform_pos_y = _make_transform(
-            0.0f, 0.0f, 1.0f, 0.0f,
-            1.0f, 0.0f, 0.0f, 0.0f,
-            0.0f, 1.0f, 0.0f, 0.0f,
-            0.0f, 0.0f, 0.0f, 0.0f);
-
-        _greedy_meshify_voxels_in_face_direction(
-            voxels, palette,
-            size_z, size_x, size_y,
-            k_stride_z, k_stride_x, k_stride_y,
-            transform_pos_y,
-            mesh);
-    }
-    // do the -y PASS
-    {
-        ogt_mesh_transform transform_neg_y = _make_transform(
-            0.0f, 0.0f, 1.0f, 0.0f,
-            1.0f, 0.0f, 0.0f, 0.0f,
-            0.0f,-1.0f, 0.0f, 0.0f,
-            0.0f, (float)(size_y), 0.0f, 0.0f);
-
-        _greedy_meshify_voxels_in_face_direction(
-            voxels + (size_y - 1) * k_stride_y, 
-            palette,
-            size_z, size_x, size_y,
-            k_stride_z, k_stride_x,-k_stride_y,
-            transform_neg_y,
-            mesh);
-    }
-    // do the +X pass
-    {
-        ogt_mesh_transform transform_pos_x = _make_transform(
-            0.0f, 1.0f, 0.0f, 0.0f,
-            0.0f, 0.0f, 1.0f, 0.0f,
-            1.0f, 0.0f, 0.0f, 0.0f,
-            0.0f, 0.0f, 0.0f, 0.0f);
-
-        _greedy_meshify_voxels_in_face_direction(
-            voxels, palette,
-            size_y, size_z, size_x,
-            k_stride_y, k_stride_z, k_stride_x,
-            transform_pos_x,
-            mesh);
-    }
-    // do the -X pass
-    {
-        ogt_mesh_transform transform_neg_x = _make_transform(
-            0.0f, 1.0f, 0.0f, 0.0f,
-            0.0f, 0.0f, 1.0f, 0.0f,
-           -1.0f, 0.0f, 0.0f, 0.0f,
-        (float)size_x, 0.0f, 0.0f, 0.0f);
-
-        _greedy_meshify_voxels_in_face_direction(
-            voxels + (size_x - 1) * k_stride_x,
-            palette,
-            size_y, size_z, size_x,
-            k_stride_y, k_stride_z, -k_stride_x,
-            transform_neg_x,
-            mesh);
-    }
-    // do the +Z pass
-    {
-        ogt_mesh_transform transform_pos_z = _make_transform(
-            1.0f, 0.0f, 0.0f, 0.0f,
-            0.0f, 1.0f, 0.0f, 0.0f,
-            0.0f, 0.0f, 1.0f, 0.0f,
-            0.0f, 0.0f, 0.0f, 0.0f);
-
-        _greedy_meshify_voxels_in_face_direction(
-            voxels, palette,
-            size_x, size_y, size_z,
-            k_stride_x, k_stride_y, k_stride_z,
-            transform_pos_z,
-            mesh);
-    }
-    // do the -Z pass
-    {
-        ogt_mesh_transform transform_neg_z = _make_transform(
-            1.0f, 0.0f, 0.0f, 0.0f,
-            0.0f, 1.0f, 0.0f, 0.0f,
-            0.0f, 0.0f, -1.0f, 0.0f,
-            0.0f, 0.0f,(float)size_z, 0.0f);
-
-        _greedy_meshify_voxels_in_face_direction(
-            voxels + (size_z-1) * k_stride_z, 
-            palette,
-            size_x, size_y, size_z,
-            k_stride_x, k_stride_y, -k_stride_z,
-            transform_neg_z,
-            mesh);
-    }
+    _meshify_voxels_in_all_face_directions(ctx, voxels, size_x, size_y, size_z, palette, _greedy_meshify_voxels_in_face_direction, mesh);
 
     assert( mesh->vertex_count <= max_vertex_count);
     assert( mesh->index_count <= max_index_count);	
@@ -1093,42 +3109,39 @@ bool is_point_in_triangle(const ogt_mesh_vec2i& v0,const ogt_mesh_vec2i& v1,cons
     return (convex_v0v1 == convex_v1v2) && (convex_v0v1 == convex_v2v0);
 }
 
-uint32_t _tessellate_polygon(uint32_t* indices, const ogt_mesh_vec2i* verts, uint32_t vert_count) {
-    static const uint32_t k_max_polygon_size = 16384;   // 32KB of stack!
-    uint16_t ring_indices[k_max_polygon_size]; 
-    assert(vert_count >= 3 && vert_count <= k_max_polygon_size);
+// naieve "ear clipping" algorithm. Start with a ring of polygon corners.
+// Find 3 sequential corners on the polygon and make sure no other points of the polygon are contained within it.
+// If so, remove the inner point from the ring. Rinse and repeat.
+// The ring is kept as a linked list in ring_next (which must have space for vert_count elements) so removing a corner is O(1).
+uint32_t _tessellate_polygon_ear_clipping(uint32_t* indices, uint32_t* ring_next, const ogt_mesh_vec2i* verts, uint32_t vert_count) {
+    assert(vert_count >= 3);
 
-    for (uint16_t i = 0; i < vert_count; i++)
-        ring_indices[i] = i;
+    for (uint32_t i = 0; i < vert_count; i++)
+        ring_next[i] = (i + 1) < vert_count ? i + 1 : 0;
     uint32_t ring_count = vert_count;
-
+    uint32_t ring_head  = 0;        // the corner at the start of the ring
     uint32_t index_count = 0;
 
-    // naieve "ear clipping" algorithm. Start with a ring of polygon corners.
-    // Find 3 sequential corners on the polygon and make sure no other points of the polygon are contained within it.
-    // If so, remove the inner point from the ring. Rinse and repeat.
     uint32_t no_progress_counter = 0;
-    uint32_t i0 = 0;
+    uint32_t i0 = 0;                // the corner we're currently trying to clip an ear from
+    uint32_t i0_position = 0;       // the position of i0 within the ring relative to ring_head.
     while (ring_count > 3) {
-                 i0 = (i0 + 0) % ring_count;
-        uint32_t i1 = (i0 + 1) % ring_count;
-        uint32_t i2 = (i0 + 2) % ring_count;
+        uint32_t i1 = ring_next[i0];
+        uint32_t i2 = ring_next[i1];
 
-        ogt_mesh_vec2i v0 = verts[ring_indices[i0]];
-        ogt_mesh_vec2i v1 = verts[ring_indices[i1]];
-        ogt_mesh_vec2i v2 = verts[ring_indices[i2]];
+        ogt_mesh_vec2i v0 = verts[i0];
+        ogt_mesh_vec2i v1 = verts[i1];
+        ogt_mesh_vec2i v2 = verts[i2];
 
         // check whether we can carve off this ear.
         bool can_triangulate = is_triangle_convex(v0, v1, v2);
 
         if (can_triangulate) {
             // make sure that no other points are inside this triangle. We do allow points to be coincident with corners of the triangle though.
-            for (uint32_t i = 0; i < ring_count; i++) {
-                if (i == i0 || i == i1 || i == i2)
-                    continue;
-                const ogt_mesh_vec2i& p = verts[ring_indices[i]];
+            for (uint32_t i = ring_next[i2]; i != i0; i = ring_next[i]) {
+                const ogt_mesh_vec2i& p = verts[i];
                 bool point_on_corner = is_vec2i_equal(v0, p) || is_vec2i_equal(v1,p) || is_vec2i_equal(v2,p);
-                if (!point_on_corner && is_point_in_triangle(v0,v1,v2,verts[ring_indices[i]])) {
+                if (!point_on_corner && is_point_in_triangle(v0,v1,v2,p)) {
                     can_triangulate = false;
                     break;
                 }
@@ -1136,19 +3149,24 @@ uint32_t _tessellate_polygon(uint32_t* indices, const ogt_mesh_vec2i* verts, uin
         }
 
         if (can_triangulate) {
-            indices[index_count++] = (uint32_t)ring_indices[i2];
-            indices[index_count++] = (uint32_t)ring_indices[i1];
-            indices[index_count++] = (uint32_t)ring_indices[i0];
-            // compact verts down in the ring indices
+            indices[index_count++] = i2;
+            indices[index_count++] = i1;
+            indices[index_count++] = i0;
+            // remove i1 from the ring. If i1 was the start of the ring, i2 is now the start and we continue from there.
+            ring_next[i0] = i2;
             ring_count--;
-            for (uint32_t i = i1; i < ring_count; i++)
-                ring_indices[i] = ring_indices[i+1];
+            if (i1 == ring_head) {
+                ring_head   = i2;
+                i0          = i2;
+                i0_position = 0;
+            }
             // reset no progress counter because we just made progress!
             no_progress_counter = 0;
         }
         else {
             no_progress_counter++;
-            i0++;
+            i0 = ring_next[i0];
+            i0_position = (i0_position + 1) < ring_count ? i0_position + 1 : 0;
         }
         // we haven't made progress in a full trip around the ring -- the geometry is probably malformed and cannot be tessellated
         if (no_progress_counter == ring_count) {
@@ -1156,13 +3174,514 @@ uint32_t _tessellate_polygon(uint32_t* indices, const ogt_mesh_vec2i* verts, uin
         }
     }
     // trailing case, just have one triangle left -- emit it.
-    indices[index_count++] = (uint32_t)ring_indices[2];
-    indices[index_count++] = (uint32_t)ring_indices[1];
-    indices[index_count++] = (uint32_t)ring_indices[0];
+    indices[index_count++] = ring_next[ring_next[ring_head]];
+    indices[index_count++] = ring_next[ring_head];
+    indices[index_count++] = ring_head;
 
     return index_count;
 }
 
+// Below is a triangulator for larger polygons that runs in O(n log n). It decomposes the polygon into y-monotone pieces 
+// with a sweep line from top to bottom, then triangulates each monotone piece with a stack in linear time.
+// See chapter 3 of "Computational Geometry: Algorithms and Applications" by de Berg et al. 
+//
+// It works on a counter-clockwise copy of the ring. The polygon rings we generate can touch themselves at a corner, so 
+// any corner that occurs more than once in the ring is nudged toward the inside of the polygon, which makes the polygon 
+// strictly simple. Coordinates are scaled up by 8x the extent of the polygon so that the nudge is too small to flip
+// the orientation of any triangle between corners. Triangles that end up spanning a pinch have zero area and are dropped.
+
+// polygons with fewer vertices than this are triangulated with ear clipping, which is faster for tiny polygons.
+static const uint32_t k_min_monotone_polygon_size = 64;
+// polygons wider or taller than this are triangulated with ear clipping, as the scaled coordinates would overflow.
+static const int32_t  k_max_monotone_polygon_extent = 8192;
+
+enum ogt_mesh_sweep_vertex_type {
+    k_sweep_vertex_start,
+    k_sweep_vertex_end,
+    k_sweep_vertex_split,
+    k_sweep_vertex_merge,
+    k_sweep_vertex_regular_left,   // a regular vertex with the polygon interior to its right
+    k_sweep_vertex_regular_right   // a regular vertex with the polygon interior to its left
+};
+
+// a vertex sorted in sweep order.
+struct ogt_mesh_sweep_event {
+    int32_t  y, x;
+    uint32_t vertex_index;
+};
+
+// half-edge used to walk the faces of the polygon after diagonals have been inserted.
+struct ogt_mesh_sweep_half_edge {
+    uint32_t from, to;
+    uint32_t next_out;      // the next half-edge that leaves the same vertex
+    uint32_t used;          // whether this half-edge has been assigned to a face.
+};
+
+// the scratch state of the monotone triangulator.
+struct ogt_mesh_monotone_state {
+    uint32_t                    n;
+    ogt_mesh_vec2i*             points;         // counter-clockwise scaled and nudged points
+    uint8_t*                    types;          // ogt_mesh_sweep_vertex_type of each point
+    uint32_t*                   helpers;        // helper vertex of each edge (edge i goes from point i to i+1)
+    uint32_t*                   status;         // edges that cross the sweep line, sorted left to right.
+    uint32_t                    status_count;
+    ogt_mesh_sweep_half_edge*   half_edges;     // n polygon edges, followed by 2 half-edges per diagonal
+    uint32_t                    half_edge_count;
+    uint32_t                    max_half_edges;
+    uint32_t*                   first_out;      // the first half-edge leaving each point.
+};
+
+// >0 if a,b,c turn counter-clockwise, <0 if they turn clockwise, 0 if collinear.
+static inline int64_t _sweep_orient(const ogt_mesh_vec2i& a, const ogt_mesh_vec2i& b, const ogt_mesh_vec2i& c) {
+    return ((int64_t)(b.x - a.x) * (int64_t)(c.y - a.y)) - ((int64_t)(b.y - a.y) * (int64_t)(c.x - a.x));
+}
+
+// whether a is visited before b by the sweep line. Points with larger y come first, then points with smaller x.
+static inline bool _sweep_is_above(const ogt_mesh_vec2i& a, const ogt_mesh_vec2i& b) {
+    return a.y > b.y || (a.y == b.y && a.x < b.x);
+}
+
+static int _sweep_compare_events(const void* lhs, const void* rhs) {
+    const ogt_mesh_sweep_event* a = (const ogt_mesh_sweep_event*)lhs;
+    const ogt_mesh_sweep_event* b = (const ogt_mesh_sweep_event*)rhs;
+    if (a->y != b->y) return a->y > b->y ? -1 : 1;
+    if (a->x != b->x) return a->x < b->x ? -1 : 1;
+    return a->vertex_index < b->vertex_index ? -1 : (a->vertex_index > b->vertex_index ? 1 : 0);
+}
+
+// returns the number of edges in the sweep status that are to the left of the specified point.
+static uint32_t _sweep_count_edges_left_of(const ogt_mesh_monotone_state& state, const ogt_mesh_vec2i& p) {
+    // edges in the status always point downward, so the point is right of the edge when it is to the left of its direction.
+    uint32_t lo = 0, hi = state.status_count;
+    while (lo < hi) {
+        uint32_t mid  = (lo + hi) / 2;
+        uint32_t edge = state.status[mid];
+        uint32_t edge_end = (edge + 1) < state.n ? edge + 1 : 0;
+        if (_sweep_orient(state.points[edge], state.points[edge_end], p) > 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+static void _sweep_insert_edge(ogt_mesh_monotone_state& state, uint32_t edge, uint32_t helper) {
+    uint32_t position = _sweep_count_edges_left_of(state, state.points[edge]);
+    memmove(&state.status[position + 1], &state.status[position], (state.status_count - position) * sizeof(uint32_t));
+    state.status[position] = edge;
+    state.status_count++;
+    state.helpers[edge] = helper;
+}
+
+static bool _sweep_remove_edge(ogt_mesh_monotone_state& state, uint32_t edge) {
+    // the edge ends at the current sweep point, so it should be immediately after all edges left of that point.
+    uint32_t edge_end = (edge + 1) < state.n ? edge + 1 : 0;
+    uint32_t position = _sweep_count_edges_left_of(state, state.points[edge_end]);
+    if (position >= state.status_count || state.status[position] != edge) {
+        for (position = 0; position < state.status_count && state.status[position] != edge; position++) {}
+        if (position == state.status_count)
+            return false;
+    }
+    state.status_count--;
+    memmove(&state.status[position], &state.status[position + 1], (state.status_count - position) * sizeof(uint32_t));
+    return true;
+}
+
+// finds the edge immediately left of the specified point, or returns UINT32_MAX if there is none.
+static uint32_t _sweep_find_edge_left_of(const ogt_mesh_monotone_state& state, const ogt_mesh_vec2i& p) {
+    uint32_t count = _sweep_count_edges_left_of(state, p);
+    return count ? state.status[count - 1] : UINT32_MAX;
+}
+
+static void _sweep_add_half_edge(ogt_mesh_monotone_state& state, uint32_t from, uint32_t to) {
+    ogt_mesh_sweep_half_edge& half_edge = state.half_edges[state.half_edge_count];
+    half_edge.from      = from;
+    half_edge.to        = to;
+    half_edge.used      = 0;
+    half_edge.next_out  = state.first_out[from];
+    state.first_out[from] = state.half_edge_count++;
+}
+
+static bool _sweep_add_diagonal(ogt_mesh_monotone_state& state, uint32_t a, uint32_t b) {
+    if (state.half_edge_count + 2 > state.max_half_edges || a == b)
+        return false;
+    _sweep_add_half_edge(state, a, b);
+    _sweep_add_half_edge(state, b, a);
+    return true;
+}
+
+// Categorizes a direction by its clockwise angle from ref: 0 = (0,180), 1 = 180, 2 = (180,360), 3 = 0/360.
+static inline uint32_t _sweep_clockwise_quadrant(const ogt_mesh_vec2i& ref, const ogt_mesh_vec2i& dir) {
+    int64_t cross = ((int64_t)ref.x * dir.y) - ((int64_t)ref.y * dir.x);
+    int64_t dot   = ((int64_t)ref.x * dir.x) + ((int64_t)ref.y * dir.y);
+    if (cross < 0) return 0;
+    if (cross > 0) return 2;
+    return dot < 0 ? 1 : 3;
+}
+
+// whether dir_a comes before dir_b when turning clockwise from ref.
+static bool _sweep_is_clockwise_before(const ogt_mesh_vec2i& ref, const ogt_mesh_vec2i& dir_a, const ogt_mesh_vec2i& dir_b) {
+    uint32_t quadrant_a = _sweep_clockwise_quadrant(ref, dir_a);
+    uint32_t quadrant_b = _sweep_clockwise_quadrant(ref, dir_b);
+    if (quadrant_a != quadrant_b)
+        return quadrant_a < quadrant_b;
+    // same half-plane: a is first if b is clockwise of a.
+    return (((int64_t)dir_a.x * dir_b.y) - ((int64_t)dir_a.y * dir_b.x)) < 0;
+}
+
+// emits a counter-clockwise triangle. Returns false if the triangle is degenerate.
+static inline bool _sweep_emit_triangle(const ogt_mesh_monotone_state& state, uint32_t* indices, uint32_t& index_count, uint32_t a, uint32_t b, uint32_t c) {
+    int64_t orient = _sweep_orient(state.points[a], state.points[b], state.points[c]);
+    if (orient == 0)
+        return false;
+    if (orient < 0) {
+        uint32_t temp = b;
+        b = c;
+        c = temp;
+    }
+    indices[index_count++] = a;
+    indices[index_count++] = b;
+    indices[index_count++] = c;
+    return true;
+}
+
+// triangulates a y-monotone counter-clockwise polygon. face_order and face_chain must have space for face_count elements,
+// and stack must have space for face_count elements.
+static bool _sweep_triangulate_monotone(const ogt_mesh_monotone_state& state, uint32_t* indices, uint32_t& index_count, 
+    const uint32_t* face, uint32_t face_count, uint32_t* face_order, uint8_t* face_chain, uint32_t* stack) 
+{
+    if (face_count == 3)
+        return _sweep_emit_triangle(state, indices, index_count, face[0], face[1], face[2]);
+
+    // find the top and bottom of the piece.
+    uint32_t top = 0, bottom = 0;
+    for (uint32_t i = 1; i < face_count; i++) {
+        if (_sweep_is_above(state.points[face[i]], state.points[face[top]]))
+            top = i;
+        if (_sweep_is_above(state.points[face[bottom]], state.points[face[i]]))
+            bottom = i;
+    }
+    // merge the left chain (counter-clockwise from top to bottom) with the right chain (clockwise from top to bottom) 
+    const uint8_t k_left = 0, k_right = 1;
+    uint32_t left  = top + 1 < face_count ? top + 1 : 0;
+    uint32_t right = top > 0 ? top - 1 : face_count - 1;
+    face_order[0] = face[top];
+    face_chain[0] = k_left;
+    for (uint32_t i = 1; i < face_count; i++) {
+        bool take_left = (left != bottom) && (right == bottom || _sweep_is_above(state.points[face[left]], state.points[face[right]]));
+        if (i == face_count - 1) {
+            face_order[i] = face[bottom];
+            face_chain[i] = k_left;
+        }
+        else if (take_left) {
+            face_order[i] = face[left];
+            face_chain[i] = k_left;
+            left = left + 1 < face_count ? left + 1 : 0;
+        }
+        else {
+            face_order[i] = face[right];
+            face_chain[i] = k_right;
+            right = right > 0 ? right - 1 : face_count - 1;
+        }
+    }
+    // the merge should have met at the bottom. If not, this face is not monotone.
+    if (left != bottom || right != bottom)
+        return false;
+
+    uint32_t stack_count = 0;
+    stack[stack_count++] = 0;
+    stack[stack_count++] = 1;
+    for (uint32_t j = 2; j < face_count - 1; j++) {
+        uint32_t top_of_stack = stack[stack_count - 1];
+        if (face_chain[j] != face_chain[top_of_stack]) {
+            // connect u_j to every vertex on the stack.
+            for (uint32_t s = 0; s + 1 < stack_count; s++) {
+                if (!_sweep_emit_triangle(state, indices, index_count, face_order[j], face_order[stack[s]], face_order[stack[s + 1]]))
+                    return false;
+            }
+            stack_count = 0;
+            stack[stack_count++] = j - 1;
+            stack[stack_count++] = j;
+        }
+        else {
+            // connect u_j to vertices on the stack for as long as the diagonals are inside the polygon.
+            uint32_t last = stack[--stack_count];
+            while (stack_count) {
+                uint32_t next = stack[stack_count - 1];
+                int64_t orient = _sweep_orient(state.points[face_order[j]], state.points[face_order[last]], state.points[face_order[next]]);
+                bool is_inside = face_chain[j] == k_left ? orient < 0 : orient > 0;
+                if (!is_inside)
+                    break;
+                if (!_sweep_emit_triangle(state, indices, index_count, face_order[j], face_order[last], face_order[next]))
+                    return false;
+                last = next;
+                stack_count--;
+            }
+            stack[stack_count++] = last;
+            stack[stack_count++] = j;
+        }
+    }
+    // connect the bottom to every vertex left on the stack.
+    for (uint32_t s = 0; s + 1 < stack_count; s++) {
+        if (!_sweep_emit_triangle(state, indices, index_count, face_order[face_count - 1], face_order[stack[s]], face_order[stack[s + 1]]))
+            return false;
+    }
+    return true;
+}
+
+// Triangulates the polygon in O(n log n). Returns the number of indices written, or 0 if the polygon could not be 
+// triangulated this way, in which case the caller should fall back to ear clipping. 
+uint32_t _tessellate_polygon_monotone(const ogt_voxel_meshify_context* ctx, uint32_t* indices, const ogt_mesh_vec2i* verts, uint32_t vert_count) {
+    const uint32_t n = vert_count;
+    // a decomposition into monotone pieces needs fewer than n diagonals.
+    const uint32_t max_half_edges = n + (n * 2);
+
+    ogt_mesh_scratch_mark scratch_mark = _scratch_begin(ctx);
+    ogt_mesh_monotone_state state;
+    state.n                 = n;
+    state.status_count      = 0;
+    state.half_edge_count   = 0;
+    state.max_half_edges    = max_half_edges;
+    state.points            = (ogt_mesh_vec2i*)_scratch_alloc(ctx, n * sizeof(ogt_mesh_vec2i));
+    state.types             = (uint8_t*)_scratch_alloc(ctx, n * sizeof(uint8_t));
+    state.helpers           = (uint32_t*)_scratch_alloc(ctx, n * sizeof(uint32_t));
+    state.status            = (uint32_t*)_scratch_alloc(ctx, n * sizeof(uint32_t));
+    state.first_out         = (uint32_t*)_scratch_alloc(ctx, n * sizeof(uint32_t));
+    state.half_edges        = (ogt_mesh_sweep_half_edge*)_scratch_alloc(ctx, max_half_edges * sizeof(ogt_mesh_sweep_half_edge));
+    ogt_mesh_sweep_event* events = (ogt_mesh_sweep_event*)_scratch_alloc(ctx, n * sizeof(ogt_mesh_sweep_event));
+    uint32_t* face          = (uint32_t*)_scratch_alloc(ctx, max_half_edges * sizeof(uint32_t));
+    uint32_t* face_order    = (uint32_t*)_scratch_alloc(ctx, max_half_edges * sizeof(uint32_t));
+    uint32_t* stack         = (uint32_t*)_scratch_alloc(ctx, max_half_edges * sizeof(uint32_t));
+    uint8_t*  face_chain    = (uint8_t*)_scratch_alloc(ctx, max_half_edges * sizeof(uint8_t));
+
+    uint32_t index_count = 0;
+    bool success = state.points && state.types && state.helpers && state.status && state.first_out && state.half_edges && 
+                   events && face && face_order && stack && face_chain;
+
+    // (1) make a counter-clockwise copy of the ring with scaled coordinates, and sort it into sweep order.
+    if (success) {
+        ogt_mesh_vec2i min_vert = verts[0], max_vert = verts[0];
+        for (uint32_t i = 1; i < n; i++) {
+            min_vert.x = verts[i].x < min_vert.x ? verts[i].x : min_vert.x;
+            min_vert.y = verts[i].y < min_vert.y ? verts[i].y : min_vert.y;
+            max_vert.x = verts[i].x > max_vert.x ? verts[i].x : max_vert.x;
+            max_vert.y = verts[i].y > max_vert.y ? verts[i].y : max_vert.y;
+        }
+        int32_t extent = (max_vert.x - min_vert.x) > (max_vert.y - min_vert.y) ? (max_vert.x - min_vert.x) : (max_vert.y - min_vert.y);
+        success = extent <= k_max_monotone_polygon_extent;
+        int32_t scale = (extent + 1) * 8;
+        for (uint32_t i = 0; success && i < n; i++) {
+            state.points[i].x = (verts[n - 1 - i].x - min_vert.x) * scale;
+            state.points[i].y = (verts[n - 1 - i].y - min_vert.y) * scale;
+        }
+    }
+    if (success) {
+        for (uint32_t i = 0; i < n; i++) {
+            events[i].x = state.points[i].x;
+            events[i].y = state.points[i].y;
+            events[i].vertex_index = i;
+        }
+        qsort(events, n, sizeof(ogt_mesh_sweep_event), _sweep_compare_events);
+
+        // nudge apart any points that occur more than once toward the inside of the polygon.
+        bool any_nudged = false;
+        for (uint32_t i = 0; i < n; ) {
+            uint32_t run_end = i + 1;
+            while (run_end < n && events[run_end].x == events[i].x && events[run_end].y == events[i].y)
+                run_end++;
+            for (uint32_t r = i; (run_end - i) > 1 && r < run_end; r++) {
+                uint32_t v = events[r].vertex_index;
+                const ogt_mesh_vec2i& prev = state.points[v > 0 ? v - 1 : n - 1];
+                const ogt_mesh_vec2i& next = state.points[v + 1 < n ? v + 1 : 0];
+                const ogt_mesh_vec2i& curr = state.points[v];
+                // the inside of a counter-clockwise polygon is to the left of each edge.
+                int32_t in_x  = (curr.x > prev.x) - (curr.x < prev.x), in_y  = (curr.y > prev.y) - (curr.y < prev.y);
+                int32_t out_x = (next.x > curr.x) - (next.x < curr.x), out_y = (next.y > curr.y) - (next.y < curr.y);
+                int32_t nudge_x = -in_y - out_y;
+                int32_t nudge_y =  in_x + out_x;
+                events[r].x += (nudge_x > 0) - (nudge_x < 0);
+                events[r].y += (nudge_y > 0) - (nudge_y < 0);
+                any_nudged = true;
+            }
+            i = run_end;
+        }
+        if (any_nudged) {
+            for (uint32_t i = 0; i < n; i++) {
+                state.points[events[i].vertex_index].x = events[i].x;
+                state.points[events[i].vertex_index].y = events[i].y;
+            }
+            qsort(events, n, sizeof(ogt_mesh_sweep_event), _sweep_compare_events);
+        }
+    }
+
+    // (2) classify each vertex, and set up the polygon edges as half-edges.
+    if (success) {
+        for (uint32_t i = 0; i < n; i++) {
+            const ogt_mesh_vec2i& prev = state.points[i > 0 ? i - 1 : n - 1];
+            const ogt_mesh_vec2i& next = state.points[i + 1 < n ? i + 1 : 0];
+            const ogt_mesh_vec2i& curr = state.points[i];
+            bool prev_below = _sweep_is_above(curr, prev);
+            bool next_below = _sweep_is_above(curr, next);
+            bool is_convex  = _sweep_orient(prev, curr, next) > 0;
+            if (prev_below && next_below)
+                state.types[i] = (uint8_t)(is_convex ? k_sweep_vertex_start : k_sweep_vertex_split);
+            else if (!prev_below && !next_below)
+                state.types[i] = (uint8_t)(is_convex ? k_sweep_vertex_end : k_sweep_vertex_merge);
+            else
+                state.types[i] = (uint8_t)(prev_below ? k_sweep_vertex_regular_right : k_sweep_vertex_regular_left);
+            state.first_out[i] = UINT32_MAX;
+        }
+        for (uint32_t i = 0; i < n; i++)
+            _sweep_add_half_edge(state, i, i + 1 < n ? i + 1 : 0);
+    }
+
+    // (3) sweep from top to bottom, inserting diagonals that split the polygon into monotone pieces.
+    for (uint32_t e = 0; success && e < n; e++) {
+        uint32_t v = events[e].vertex_index;
+        uint32_t prev_edge = v > 0 ? v - 1 : n - 1;
+        const ogt_mesh_vec2i& p = state.points[v];
+        switch (state.types[v]) {
+            case k_sweep_vertex_start: {
+                _sweep_insert_edge(state, v, v);
+                break;
+            }
+            case k_sweep_vertex_end: {
+                if (state.types[state.helpers[prev_edge]] == k_sweep_vertex_merge)
+                    success = _sweep_add_diagonal(state, v, state.helpers[prev_edge]);
+                success = success && _sweep_remove_edge(state, prev_edge);
+                break;
+            }
+            case k_sweep_vertex_split: {
+                uint32_t left_edge = _sweep_find_edge_left_of(state, p);
+                success = (left_edge != UINT32_MAX) && _sweep_add_diagonal(state, v, state.helpers[left_edge]);
+                if (success) {
+                    state.helpers[left_edge] = v;
+                    _sweep_insert_edge(state, v, v);
+                }
+                break;
+            }
+            case k_sweep_vertex_merge: {
+                if (state.types[state.helpers[prev_edge]] == k_sweep_vertex_merge)
+                    success = _sweep_add_diagonal(state, v, state.helpers[prev_edge]);
+                success = success && _sweep_remove_edge(state, prev_edge);
+                uint32_t left_edge = success ? _sweep_find_edge_left_of(state, p) : UINT32_MAX;
+                success = success && (left_edge != UINT32_MAX);
+                if (success && state.types[state.helpers[left_edge]] == k_sweep_vertex_merge)
+                    success = _sweep_add_diagonal(state, v, state.helpers[left_edge]);
+                if (success)
+                    state.helpers[left_edge] = v;
+                break;
+            }
+            case k_sweep_vertex_regular_left: {
+                if (state.types[state.helpers[prev_edge]] == k_sweep_vertex_merge)
+                    success = _sweep_add_diagonal(state, v, state.helpers[prev_edge]);
+                success = success && _sweep_remove_edge(state, prev_edge);
+                if (success)
+                    _sweep_insert_edge(state, v, v);
+                break;
+            }
+            case k_sweep_vertex_regular_right: {
+                uint32_t left_edge = _sweep_find_edge_left_of(state, p);
+                success = (left_edge != UINT32_MAX);
+                if (success && state.types[state.helpers[left_edge]] == k_sweep_vertex_merge)
+                    success = _sweep_add_diagonal(state, v, state.helpers[left_edge]);
+                if (success)
+                    state.helpers[left_edge] = v;
+                break;
+            }
+        }
+    }
+
+    // (4) walk the faces formed by the polygon edges and diagonals, and triangulate each of them. The next edge of a face 
+    // is the first edge leaving the vertex when turning clockwise from the edge we arrived on.
+    for (uint32_t h = 0; success && h < state.half_edge_count; h++) {
+        if (state.half_edges[h].used)
+            continue;
+        uint32_t face_count = 0;
+        uint32_t current = h;
+        do {
+            ogt_mesh_sweep_half_edge& half_edge = state.half_edges[current];
+            if (half_edge.used || face_count == max_half_edges) {
+                success = false;
+                break;
+            }
+            half_edge.used = 1;
+            face[face_count++] = half_edge.from;
+
+            const ogt_mesh_vec2i& at = state.points[half_edge.to];
+            ogt_mesh_vec2i back = state.points[half_edge.from] - at;
+            uint32_t best = UINT32_MAX;
+            for (uint32_t out = state.first_out[half_edge.to]; out != UINT32_MAX; out = state.half_edges[out].next_out) {
+                if (best == UINT32_MAX || _sweep_is_clockwise_before(back, state.points[state.half_edges[out].to] - at, state.points[state.half_edges[best].to] - at))
+                    best = out;
+            }
+            current = best;
+        } while (current != h && current != UINT32_MAX);
+
+        success = success && (current == h) && (face_count >= 3) && 
+                  _sweep_triangulate_monotone(state, indices, index_count, face, face_count, face_order, face_chain, stack);
+    }
+
+    // (5) the result must be a full triangulation of the original polygon: n-2 triangles that add up to the area of the polygon, 
+    // none of which flipped when the nudged points are moved back. Triangles across a pinch have zero area, so drop those.
+    // Convert indices back to the clockwise ring order as we go.
+    if (success && index_count == (n - 2) * 3) {
+        int64_t polygon_area = 0;
+        for (uint32_t i = 0; i < n; i++) {
+            const ogt_mesh_vec2i& a = verts[i];
+            const ogt_mesh_vec2i& b = verts[i + 1 < n ? i + 1 : 0];
+            polygon_area += ((int64_t)b.x * a.y) - ((int64_t)a.x * b.y);
+        }
+        int64_t triangle_area = 0;
+        uint32_t kept_index_count = 0;
+        for (uint32_t i = 0; success && i < index_count; i += 3) {
+            uint32_t i0 = n - 1 - indices[i + 0];
+            uint32_t i1 = n - 1 - indices[i + 1];
+            uint32_t i2 = n - 1 - indices[i + 2];
+            int64_t area = _sweep_orient(verts[i0], verts[i1], verts[i2]);
+            success = area >= 0;
+            triangle_area += area;
+            if (area > 0) {
+                indices[kept_index_count++] = i0;
+                indices[kept_index_count++] = i1;
+                indices[kept_index_count++] = i2;
+            }
+        }
+        success = success && (triangle_area == polygon_area) && kept_index_count;
+        index_count = kept_index_count;
+    }
+    else {
+        success = false;
+    }
+
+    _scratch_free(ctx, face_chain);
+    _scratch_free(ctx, stack);
+    _scratch_free(ctx, face_order);
+    _scratch_free(ctx, face);
+    _scratch_free(ctx, events);
+    _scratch_free(ctx, state.half_edges);
+    _scratch_free(ctx, state.first_out);
+    _scratch_free(ctx, state.status);
+    _scratch_free(ctx, state.helpers);
+    _scratch_free(ctx, state.types);
+    _scratch_free(ctx, state.points);
+    _scratch_end(ctx, scratch_mark);
+
+    return success ? index_count : 0;
+}
+
+// triangulates the polygon ring, writing counter-clockwise triangles to indices. Returns the number of indices written.
+// ring_indices must have space for vert_count elements.
+uint32_t _tessellate_polygon(const ogt_voxel_meshify_context* ctx, uint32_t* indices, uint32_t* ring_indices, const ogt_mesh_vec2i* verts, uint32_t vert_count) {
+    assert(vert_count >= 3);
+    if (vert_count >= k_min_monotone_polygon_size) {
+        uint32_t index_count = _tessellate_polygon_monotone(ctx, indices, verts, vert_count);
+        if (index_count)
+            return index_count;
+    }
+    return _tessellate_polygon_ear_clipping(indices, ring_indices, verts, vert_count);
+}
+
 // where do we sample for the specified edge
 ogt_mesh_vec2i get_edge_bias(const ogt_mesh_vec2i& edge_vert0, const ogt_mesh_vec2i& edge_vert1) {
     if (edge_vert0.x < edge_vert1.x) {
@@ -1322,7 +3841,8 @@ uint32_t _tessellate_edge(ogt_mesh_vec2i* tess, uint32_t max_tess, const ogt_mes
 // When we can no longer extrude any of the polygon ring edges, we
 // terminate, as that'll mean we've flood filled the space.
 //
-int32_t _construct_polygon_for_slice(ogt_mesh_vec2i* verts, uint32_t max_verts, int32_t i, int32_t j, int32_t size_x, int32_t size_y, const uint8_t* slice_colors, ogt_mesh_bitset_64k& voxel_polygonized) {
+int32_t _construct_polygon_for_slice(ogt_mesh_vec2i* verts, uint32_t max_verts, ogt_mesh_vec2i* tess_buffer, uint32_t max_tessellations, 
+    int32_t i, int32_t j, int32_t size_x, int32_t size_y, const uint8_t* slice_colors, ogt_mesh_bitset& voxel_polygonized) {
     assert(max_verts > 4);
     // start with just a single 4 vertex closed polygon
     verts[0] = make_vec2i(i,   j  );
@@ -1421,9 +3941,6 @@ int32_t _construct_polygon_for_slice(ogt_mesh_vec2i* verts, uint32_t max_verts,
             bool is_e1e2_extrude = is_vec2i_equal(edge1_unitvec, edge2_unitvec); 
 
             // (1) try tessellate edge0, edge1, edge2.
-            const uint32_t k_max_tessellations = 512;
-            assert(edge1_pushed_distance < k_max_tessellations);
-            ogt_mesh_vec2i tess_buffer[k_max_tessellations];
             uint32_t tess_offset = 0;
             
             // allocate tess_e0
@@ -1434,25 +3951,25 @@ int32_t _construct_polygon_for_slice(ogt_mesh_vec2i* verts, uint32_t max_verts,
             }
             else {
                 tess_buffer[tess_offset++] = cached_v0;
-                tess_offset += _tessellate_edge(&tess_buffer[tess_offset], k_max_tessellations-tess_offset, cached_v0, extruded_v1, slice_colors, size_x, size_y );
+                tess_offset += _tessellate_edge(&tess_buffer[tess_offset], max_tessellations-tess_offset, cached_v0, extruded_v1, slice_colors, size_x, size_y );
             }
             uint32_t tess_count_e0 = tess_offset - e0_offset;
             // allocate tess_e1
             uint32_t e1_offset = tess_offset;
             if (is_e0e1_extrude)
-                tess_offset += _tessellate_edge(&tess_buffer[tess_offset], k_max_tessellations-tess_offset, cached_v1, extruded_v1, slice_colors, size_x, size_y );
+                tess_offset += _tessellate_edge(&tess_buffer[tess_offset], max_tessellations-tess_offset, cached_v1, extruded_v1, slice_colors, size_x, size_y );
             tess_buffer[tess_offset++] = extruded_v1;
-            tess_offset += _tessellate_edge(&tess_buffer[tess_offset], k_max_tessellations-tess_offset, extruded_v1, extruded_v2, slice_colors, size_x, size_y );
+            tess_offset += _tessellate_edge(&tess_buffer[tess_offset], max_tessellations-tess_offset, extruded_v1, extruded_v2, slice_colors, size_x, size_y );
             tess_buffer[tess_offset++] = extruded_v2;
             if (is_e1e2_extrude)
-                tess_offset += _tessellate_edge(&tess_buffer[tess_offset], k_max_tessellations-tess_offset, extruded_v2, cached_v2, slice_colors, size_x, size_y );
+                tess_offset += _tessellate_edge(&tess_buffer[tess_offset], max_tessellations-tess_offset, extruded_v2, cached_v2, slice_colors, size_x, size_y );
             uint32_t tess_count_e1 = tess_offset - e1_offset;
             // allocate tess_e2
             uint32_t e2_offset = tess_offset;
             if (is_e1e2_extrude)
                 tess_buffer[tess_offset++] = cached_v2;
             else
-                tess_offset += _tessellate_edge(&tess_buffer[tess_offset], k_max_tessellations-tess_offset, extruded_v2, cached_v3, slice_colors, size_x, size_y );
+                tess_offset += _tessellate_edge(&tess_buffer[tess_offset], max_tessellations-tess_offset, extruded_v2, cached_v3, slice_colors, size_x, size_y );
             uint32_t tess_count_e2 = tess_offset - e2_offset;
             // allocate tess_e3
             uint32_t e3_offset = tess_offset;
@@ -1543,27 +4060,48 @@ int32_t _construct_polygon_for_slice(ogt_mesh_vec2i* verts, uint32_t max_verts,
     return vert_count;
 }
 
-void _polygon_meshify_voxels_in_face_direction(
+// DIRECTION is the ogt_mesh_face_direction_t that faces point in, which maps X,Y,Z to the voxel grid. Polygons span voxels 
+// with differing ao, so ao is not computed.
+template <class DIRECTION>
+static void _polygon_meshify_voxels_in_face_direction_kernel(
+    const ogt_voxel_meshify_context* ctx,
     const uint8_t* voxels,
     const ogt_mesh_rgba* palette,
     int32_t size_x, int32_t size_y, int32_t size_z,                // how many voxels in each of X,Y,Z dimensions
     int32_t k_stride_x, int32_t k_stride_y, int32_t k_stride_z,    // the memory stride for each of those X,Y,Z dimensions within the voxel data.
-    const ogt_mesh_transform& transform,                           // transform to convert from X,Y,Z to "objectSpace"
     ogt_mesh* mesh)
 {
     // enable aggressive voxel optimization for now.
     uint32_t max_voxels_per_slice = size_x * size_y;
-    assert(max_voxels_per_slice <= 65536);	// voxel_polygonized and slice_colors requires this.
-    ogt_mesh_bitset_64k voxel_polygonized;
-    uint8_t slice_colors[65536];
-
-    // determine if the transform parity has flipped in a way that winding would have been switched.
-    const ogt_mesh_vec3* side = _make_vec3_ptr(&transform.m00);
-    const ogt_mesh_vec3* up   = _make_vec3_ptr(&transform.m10);
-    const ogt_mesh_vec3* fwd  = _make_vec3_ptr(&transform.m20);
-    bool is_parity_flipped    = _dot3(*fwd, _cross3(*side, *up)) < 0.0f;
+    if (!max_voxels_per_slice)
+        return;
+
+    // A polygon ring can't have more vertices than there are cell edges in the slice, and a single edge extrusion can't 
+    // generate more tessellated points than 5 edges of maximum length.
+    const uint32_t max_verts          = (size_x * (size_y + 1)) + (size_y * (size_x + 1)) + 4;
+    const uint32_t max_tessellations  = ((size_x > size_y ? size_x : size_y) * 5) + 8;
+
+    ogt_mesh_scratch_mark scratch_mark = _scratch_begin(ctx);
+    ogt_mesh_bitset voxel_polygonized;
+    voxel_polygonized.bits          = (uint8_t*)_scratch_alloc(ctx, ogt_mesh_bitset::get_size(max_voxels_per_slice));
+    uint8_t*        slice_colors    = (uint8_t*)_scratch_alloc(ctx, max_voxels_per_slice);
+    ogt_mesh_vec2i* verts           = (ogt_mesh_vec2i*)_scratch_alloc(ctx, max_verts * sizeof(ogt_mesh_vec2i));
+    uint32_t*       ring_indices    = (uint32_t*)_scratch_alloc(ctx, max_verts * sizeof(uint32_t));
+    ogt_mesh_vec2i* tess_buffer     = (ogt_mesh_vec2i*)_scratch_alloc(ctx, max_tessellations * sizeof(ogt_mesh_vec2i));
+    ogt_mesh_voxel_slices slices;
+    bool has_slices = _voxel_slices_init(ctx, slices, voxels, size_x, size_y, size_z, k_stride_x, k_stride_y, k_stride_z);
+    if (!voxel_polygonized.bits || !slice_colors || !verts || !ring_indices || !tess_buffer || !has_slices) {
+        _voxel_slices_free(ctx, slices);
+        _scratch_free(ctx, tess_buffer);
+        _scratch_free(ctx, ring_indices);
+        _scratch_free(ctx, verts);
+        _scratch_free(ctx, slice_colors);
+        _scratch_free(ctx, voxel_polygonized.bits);
+        _scratch_end(ctx, scratch_mark);
+        return;
+    }
 
-    ogt_mesh_vec3 normal = _transform_vector(transform, _make_vec3(0.0f, 0.0f, 1.0f));
+    const ogt_mesh_vec3 normal = DIRECTION::normal();
 
     for ( int32_t k = 0; k < (int32_t)size_z; k++ ) {
         bool is_last_slice = (k == (size_z-1)) ? true : false;
@@ -1571,20 +4109,25 @@ void _polygon_meshify_voxels_in_face_direction(
         // clear this slice
         voxel_polygonized.clear(max_voxels_per_slice);
 
+        // get contiguous voxel memory for this slice and the next.
+        const uint8_t* slice0;
+        const uint8_t* slice1;
+        _voxel_slices_get(slices, k, &slice0, &slice1);
+
         // first, fill this slice with all colors for the voxel grid but set to zero where the
         // slice has a non-empty voxel in the corresponding location in the k+1 slice.
         uint32_t num_non_empty_cells = 0;
         for (int32_t j = 0; j < size_y; j++) {
             for (int32_t i = 0; i < size_x; i++) {
                 int32_t index_in_slice = i+(j*size_x);
-                uint8_t cell_color = voxels[i*k_stride_x + j*k_stride_y + (k+0)*k_stride_z];
+                uint8_t cell_color = slice0[index_in_slice];
 
                 // if the this cell on this slice is occluded by the corresponding cell on the next slice, we 
                 // mark this polygon as voxelized already so it doesn't get included in any polygons for the current slice.
                 // we also inherit the next slice's color to ensure the polygon flood fill inserts 
                 // discontinuities where necessary in order to generate a water-tight tessellation
                 // to the next slice.
-                uint8_t next_cell_color = !is_last_slice ? voxels[i * k_stride_x + j * k_stride_y + (k + 1) * k_stride_z] : 0;
+                uint8_t next_cell_color = !is_last_slice ? slice1[index_in_slice] : 0;
                 if (next_cell_color != 0) {
                     cell_color = next_cell_color;
                     voxel_polygonized.set(index_in_slice);
@@ -1619,23 +4162,21 @@ void _polygon_meshify_voxels_in_face_direction(
                 //	(j > 0 && slice_colors[index_in_slice-size_x] == color_index))
                 //	continue;
 
-                const uint32_t MAX_VERTS = 4096;
-                ogt_mesh_vec2i verts[MAX_VERTS];
-                uint32_t vert_count = _construct_polygon_for_slice(verts, MAX_VERTS, i, j, size_x, size_y, slice_colors, voxel_polygonized);
+                uint32_t vert_count = _construct_polygon_for_slice(verts, max_verts, tess_buffer, max_tessellations, i, j, size_x, size_y, slice_colors, voxel_polygonized);
                 
                 const ogt_mesh_rgba& color = palette[color_index];
 
                 // generate the verts in the output mesh
                 uint32_t base_vertex_index = mesh->vertex_count;
                 for (uint32_t vert_index = 0; vert_index < vert_count; vert_index++) {
-                    mesh->vertices[mesh->vertex_count++] = _mesh_make_vertex(_transform_point(transform, _make_vec3((float)verts[vert_index].x, (float)verts[vert_index].y,   (float)(k+1))), normal, color, color_index);
+                    mesh->vertices[mesh->vertex_count++] = _mesh_make_vertex(DIRECTION::point(verts[vert_index].x, verts[vert_index].y, k + 1, size_z), normal, color, color_index);
                 }
 
                 // generate the indices in the output mesh.
-                uint32_t tessellated_index_count = _tessellate_polygon(&mesh->indices[mesh->index_count], verts, vert_count);
+                uint32_t tessellated_index_count = _tessellate_polygon(ctx, &mesh->indices[mesh->index_count], ring_indices, verts, vert_count);
 
-                // flip the winding of tessellated triangles to account for an inversion in the transform.
-                if (is_parity_flipped) {
+                // flip the winding of tessellated triangles of faces that point along a negative axis.
+                if (DIRECTION::k_is_negative) {
                     for (uint32_t index = 0; index < tessellated_index_count; index += 3) {
                         uint32_t i0 = mesh->indices[mesh->index_count + index + 0];
                         uint32_t i1 = mesh->indices[mesh->index_count + index + 1];
@@ -1662,6 +4203,31 @@ void _polygon_meshify_voxels_in_face_direction(
     }
 
     #undef SLICE_INDEX
+
+    _voxel_slices_free(ctx, slices);
+    _scratch_free(ctx, tess_buffer);
+    _scratch_free(ctx, ring_indices);
+    _scratch_free(ctx, verts);
+    _scratch_free(ctx, slice_colors);
+    _scratch_free(ctx, voxel_polygonized.bits);
+    _scratch_end(ctx, scratch_mark);
+}
+
+// meshes faces that point in a single face direction with the polygon kernel that is specialized for that direction.
+static void _polygon_meshify_voxels_in_face_direction(const ogt_voxel_meshify_context* ctx, const uint8_t* voxels, const ogt_mesh_rgba* palette,
+    int32_t size_x, int32_t size_y, int32_t size_z, int32_t k_stride_x, int32_t k_stride_y, int32_t k_stride_z,
+    const ogt_mesh_face_direction& direction, const ogt_mesh_voxel_model* ao_grid, ogt_mesh* mesh)
+{
+    (void)ao_grid;
+    switch (_face_direction_mesh_direction(direction)) {
+        case ogt_mesh_direction_pos_x: _polygon_meshify_voxels_in_face_direction_kernel<ogt_mesh_face_direction_pos_x>(ctx, voxels, palette, size_x, size_y, size_z, k_stride_x, k_stride_y, k_stride_z, mesh); break;
+        case ogt_mesh_direction_neg_x: _polygon_meshify_voxels_in_face_direction_kernel<ogt_mesh_face_direction_neg_x>(ctx, voxels, palette, size_x, size_y, size_z, k_stride_x, k_stride_y, k_stride_z, mesh); break;
+        case ogt_mesh_direction_pos_y: _polygon_meshify_voxels_in_face_direction_kernel<ogt_mesh_face_direction_pos_y>(ctx, voxels, palette, size_x, size_y, size_z, k_stride_x, k_stride_y, k_stride_z, mesh); break;
+        case ogt_mesh_direction_neg_y: _polygon_meshify_voxels_in_face_direction_kernel<ogt_mesh_face_direction_neg_y>(ctx, voxels, palette, size_x, size_y, size_z, k_stride_x, k_stride_y, k_stride_z, mesh); break;
+        case ogt_mesh_direction_pos_z: _polygon_meshify_voxels_in_face_direction_kernel<ogt_mesh_face_direction_pos_z>(ctx, voxels, palette, size_x, size_y, size_z, k_stride_x, k_stride_y, k_stride_z, mesh); break;
+        case ogt_mesh_direction_neg_z: _polygon_meshify_voxels_in_face_direction_kernel<ogt_mesh_face_direction_neg_z>(ctx, voxels, palette, size_x, size_y, size_z, k_stride_x, k_stride_y, k_stride_z, mesh); break;
+        default: assert(0); break;
+    }
 }
 
 // for each slice
@@ -1688,104 +4254,7 @@ ogt_mesh* ogt_mesh_from_paletted_voxels_polygon(
     mesh->vertex_count = 0;
     mesh->index_count  = 0;
     
-    const int32_t k_stride_x = 1;
-    const int32_t k_stride_y = size_x;
-    const int32_t k_stride_z = size_x * size_y;
-    
-    // do the +y PASS
-    {
-        ogt_mesh_transform transform_pos_y = _make_transform(
-            0.0f, 0.0f, 1.0f, 0.0f,
-            1.0f, 0.0f, 0.0f, 0.0f,
-            0.0f, 1.0f, 0.0f, 0.0f,
-            0.0f, 0.0f, 0.0f, 0.0f);
-
-        _polygon_meshify_voxels_in_face_direction(
-            voxels, palette,
-            size_z, size_x, size_y,
-            k_stride_z, k_stride_x, k_stride_y,
-            transform_pos_y,
-            mesh);
-    }
-    
-    // do the -y PASS
-    {
-        ogt_mesh_transform transform_neg_y = _make_transform(
-            0.0f, 0.0f, 1.0f, 0.0f,
-            1.0f, 0.0f, 0.0f, 0.0f,
-            0.0f,-1.0f, 0.0f, 0.0f,
-            0.0f, (float)(size_y), 0.0f, 0.0f);
-
-        _polygon_meshify_voxels_in_face_direction(
-            voxels + (size_y - 1) * k_stride_y, 
-            palette,
-            size_z, size_x, size_y,
-            k_stride_z, k_stride_x,-k_stride_y,
-            transform_neg_y,
-            mesh);
-    }
-    // do the +X pass
-    {
-        ogt_mesh_transform transform_pos_x = _make_transform(
-            0.0f, 1.0f, 0.0f, 0.0f,
-            0.0f, 0.0f, 1.0f, 0.0f,
-            1.0f, 0.0f, 0.0f, 0.0f,
-            0.0f, 0.0f, 0.0f, 0.0f);
-
-        _polygon_meshify_voxels_in_face_direction(
-            voxels, palette,
-            size_y, size_z, size_x,
-            k_stride_y, k_stride_z, k_stride_x,
-            transform_pos_x,
-            mesh);
-    }
-    // do the -X pass
-    {
-        ogt_mesh_transform transform_neg_x = _make_transform(
-            0.0f, 1.0f, 0.0f, 0.0f,
-            0.0f, 0.0f, 1.0f, 0.0f,
-           -1.0f, 0.0f, 0.0f, 0.0f,
-        (float)size_x, 0.0f, 0.0f, 0.0f);
-
-        _polygon_meshify_voxels_in_face_direction(
-            voxels + (size_x - 1) * k_stride_x,
-            palette,
-            size_y, size_z, size_x,
-            k_stride_y, k_stride_z, -k_stride_x,
-            transform_neg_x,
-            mesh);
-    }
-    // do the +Z pass
-    {
-        ogt_mesh_transform transform_pos_z = _make_transform(
-            1.0f, 0.0f, 0.0f, 0.0f,
-            0.0f, 1.0f, 0.0f, 0.0f,
-            0.0f, 0.0f, 1.0f, 0.0f,
-            0.0f, 0.0f, 0.0f, 0.0f);
-
-        _polygon_meshify_voxels_in_face_direction(
-            voxels, palette,
-            size_x, size_y, size_z,
-            k_stride_x, k_stride_y, k_stride_z,
-            transform_pos_z,
-            mesh);
-    }
-    // do the -Z pass
-    {
-        ogt_mesh_transform transform_neg_z = _make_transform(
-            1.0f, 0.0f, 0.0f, 0.0f,
-            0.0f, 1.0f, 0.0f, 0.0f,
-            0.0f, 0.0f, -1.0f, 0.0f,
-            0.0f, 0.0f,(float)size_z, 0.0f);
-
-        _polygon_meshify_voxels_in_face_direction(
-            voxels + (size_z-1) * k_stride_z, 
-            palette,
-            size_x, size_y, size_z,
-            k_stride_x, k_stride_y, -k_stride_z,
-            transform_neg_z,
-            mesh);
-    }
+    _meshify_voxels_in_all_face_directions(ctx, voxels, size_x, size_y, size_z, palette, _polygon_meshify_voxels_in_face_direction, mesh);
 
     assert( mesh->vertex_count <= max_vertex_count);
     assert( mesh->index_count <= max_index_count);
@@ -1799,6 +4268,1221 @@ void ogt_mesh_destroy(const ogt_voxel_meshify_context* ctx, ogt_mesh* mesh )
     _voxel_meshify_free(ctx, mesh);
 }
 
+// meshes a voxel grid with the specified algorithm into mesh, which must have room for 4 vertices and 6 indices per simple face, 
+// where direction_face_counts is the number of simple faces in each ogt_mesh_direction. Returns false if temporary memory 
+// could not be allocated.
+static bool _meshify_paletted_voxels(const ogt_voxel_meshify_context* ctx, ogt_mesh_algorithm algorithm, 
+    const uint8_t* voxels, uint32_t size_x, uint32_t size_y, uint32_t size_z, const ogt_mesh_rgba* palette, const uint32_t* direction_face_counts, ogt_mesh* mesh)
+{
+    mesh->vertex_count = 0;
+    mesh->index_count  = 0;
+    memset(mesh->direction_ranges, 0, sizeof(mesh->direction_ranges));
+    switch (algorithm) {
+        case ogt_mesh_algorithm_simple: {
+            uint32_t* direction_index_cursors[ogt_mesh_direction_count];
+            _init_direction_ranges(mesh, direction_face_counts, direction_index_cursors);
+            uint32_t face_count = _simple_meshify_voxels_by_direction(ctx, voxels, size_x, size_y, size_z, palette, mesh->vertices, direction_index_cursors);
+            mesh->vertex_count = face_count * 4;
+            mesh->index_count  = face_count * 6;
+            return true;
+        }
+        case ogt_mesh_algorithm_simple_shared:
+            return _simple_shared_meshify_voxels(ctx, voxels, size_x, size_y, size_z, palette, direction_face_counts, mesh);
+        case ogt_mesh_algorithm_greedy:
+            _meshify_voxels_in_all_face_directions(ctx, voxels, size_x, size_y, size_z, palette, _greedy_meshify_voxels_in_face_direction, mesh);
+            return true;
+        case ogt_mesh_algorithm_polygon:
+            _meshify_voxels_in_all_face_directions(ctx, voxels, size_x, size_y, size_z, palette, _polygon_meshify_voxels_in_face_direction, mesh);
+            return true;
+    }
+    return false;
+}
+
+// meshes the voxels inside the one voxel padding of a padded chunk grid with a face direction mesher. Each direction only meshes
+// the slices inside the padding plus the padding slice in front of them, so that faces against voxels of neighbouring chunks are 
+// culled. Faces of that padding slice are generated too, and must be cropped. Positions are in padded grid space.
+static void _meshify_padded_chunk_in_all_face_directions(const ogt_voxel_meshify_context* ctx, const uint8_t* voxels, int32_t chunk_size,
+    const ogt_mesh_rgba* palette, ogt_mesh_face_direction_func face_direction_func, ogt_mesh* mesh)
+{
+    const int32_t padded_size = chunk_size + 2;
+    const int32_t strides[3]  = { 1, padded_size, padded_size * padded_size };
+    for (uint32_t d = 0; d < 6; d++) {
+        const ogt_mesh_face_direction& direction = k_face_directions[d];
+        const int32_t stride_z = strides[direction.axis_z];
+        const uint8_t* first_slice = voxels + strides[direction.axis_x] + strides[direction.axis_y] + (direction.is_negative ? chunk_size : 1) * stride_z;
+        ogt_mesh_index_range& range = mesh->direction_ranges[_face_direction_mesh_direction(direction)];
+        range.index_offset = mesh->index_count;
+        uint32_t first_vertex = mesh->vertex_count;
+        face_direction_func(ctx, first_slice, palette, chunk_size, chunk_size, chunk_size + 1,
+            strides[direction.axis_x], strides[direction.axis_y], direction.is_negative ? -stride_z : stride_z,
+            direction, NULL, mesh);
+        range.index_count = mesh->index_count - range.index_offset;
+        // local x, y and the local z of positive directions start inside the padding. Local z of negative directions counts 
+        // back from chunk_size + 1, which already is the padded position.
+        for (uint32_t v = first_vertex; v < mesh->vertex_count; v++) {
+            float* pos = &mesh->vertices[v].pos.x;
+            pos[direction.axis_x] += 1.0f;
+            pos[direction.axis_y] += 1.0f;
+            if (!direction.is_negative)
+                pos[direction.axis_z] += 1.0f;
+        }
+    }
+}
+
+// removes the triangles of the mesh of a padded chunk grid that belong to voxels of the padding, followed by vertices that are
+// no longer used. The voxel a triangle belongs to is the one half a voxel behind its centroid. Returns false if temporary 
+// memory could not be allocated.
+static bool _crop_padded_chunk_mesh(const ogt_voxel_meshify_context* ctx, ogt_mesh* mesh, int32_t chunk_size)
+{
+    ogt_mesh_scratch_mark scratch_mark = _scratch_begin(ctx);
+    uint32_t* vertex_remap = (uint32_t*)_scratch_alloc(ctx, mesh->vertex_count * sizeof(uint32_t));
+    if (!vertex_remap && mesh->vertex_count) {
+        _scratch_end(ctx, scratch_mark);
+        return false;
+    }
+    for (uint32_t i = 0; i < mesh->vertex_count; i++)
+        vertex_remap[i] = UINT32_MAX;
+
+    // visit direction ranges in the order of their triangles, so that kept triangles only ever move backward.
+    uint32_t range_order[ogt_mesh_direction_count];
+    for (uint32_t d = 0; d < ogt_mesh_direction_count; d++) {
+        uint32_t r = d;
+        for (; r > 0 && mesh->direction_ranges[range_order[r - 1]].index_offset > mesh->direction_ranges[d].index_offset; r--)
+            range_order[r] = range_order[r - 1];
+        range_order[r] = d;
+    }
+    const float k_min_pos = 1.0f;
+    const float k_max_pos = (float)(chunk_size + 1);
+    uint32_t index_count = 0;
+    for (uint32_t r = 0; r < ogt_mesh_direction_count; r++) {
+        ogt_mesh_index_range& range = mesh->direction_ranges[range_order[r]];
+        const uint32_t range_offset = index_count;
+        for (uint32_t i = range.index_offset; i < range.index_offset + range.index_count; i += 3) {
+            const ogt_mesh_vertex& v0 = mesh->vertices[mesh->indices[i + 0]];
+            const ogt_mesh_vertex& v1 = mesh->vertices[mesh->indices[i + 1]];
+            const ogt_mesh_vertex& v2 = mesh->vertices[mesh->indices[i + 2]];
+            const float x = ((v0.pos.x + v1.pos.x + v2.pos.x) / 3.0f) - (v0.normal.x * 0.5f);
+            const float y = ((v0.pos.y + v1.pos.y + v2.pos.y) / 3.0f) - (v0.normal.y * 0.5f);
+            const float z = ((v0.pos.z + v1.pos.z + v2.pos.z) / 3.0f) - (v0.normal.z * 0.5f);
+            if (x < k_min_pos || x >= k_max_pos || y < k_min_pos || y >= k_max_pos || z < k_min_pos || z >= k_max_pos)
+                continue;
+            for (uint32_t k = 0; k < 3; k++) {
+                mesh->indices[index_count + k] = mesh->indices[i + k];
+                vertex_remap[mesh->indices[i + k]] = 0;
+            }
+            index_count += 3;
+        }
+        range.index_offset = range_offset;
+        range.index_count  = index_count - range_offset;
+    }
+    assert(index_count <= mesh->index_count);
+    mesh->index_count = index_count;
+
+    uint32_t vertex_count = 0;
+    for (uint32_t i = 0; i < mesh->vertex_count; i++) {
+        if (vertex_remap[i] == UINT32_MAX)
+            continue;
+        vertex_remap[i] = vertex_count;
+        mesh->vertices[vertex_count++] = mesh->vertices[i];
+    }
+    mesh->vertex_count = vertex_count;
+    for (uint32_t i = 0; i < mesh->index_count; i++)
+        mesh->indices[i] = vertex_remap[mesh->indices[i]];
+
+    _scratch_free(ctx, vertex_remap);
+    _scratch_end(ctx, scratch_mark);
+    return true;
+}
+
+// meshes a chunk grid of (chunk_size + 2) voxels on each axis, where the outer voxels are padding from neighbouring chunks that 
+// only cull faces. direction_face_counts are for the whole padded grid, and positions are in padded grid space.
+static bool _meshify_padded_chunk(const ogt_voxel_meshify_context* ctx, ogt_mesh_algorithm algorithm, const uint8_t* voxels, int32_t chunk_size,
+    const ogt_mesh_rgba* palette, const uint32_t* direction_face_counts, ogt_mesh* mesh)
+{
+    const uint32_t padded_size = (uint32_t)chunk_size + 2;
+    switch (algorithm) {
+        case ogt_mesh_algorithm_simple:
+        case ogt_mesh_algorithm_simple_shared:
+            // faces never span more than one voxel here, so the whole padded grid is meshed and faces of the padding are cropped.
+            if (!_meshify_paletted_voxels(ctx, algorithm, voxels, padded_size, padded_size, padded_size, palette, direction_face_counts, mesh))
+                return false;
+            break;
+        case ogt_mesh_algorithm_greedy:
+            _meshify_padded_chunk_in_all_face_directions(ctx, voxels, chunk_size, palette, _greedy_meshify_voxels_in_face_direction, mesh);
+            break;
+        case ogt_mesh_algorithm_polygon:
+            _meshify_padded_chunk_in_all_face_directions(ctx, voxels, chunk_size, palette, _polygon_meshify_voxels_in_face_direction, mesh);
+            break;
+        default:
+            return false;
+    }
+    return _crop_padded_chunk_mesh(ctx, mesh, chunk_size);
+}
+
+// state shared by the jobs of ogt_mesh_from_paletted_voxel_models.
+struct ogt_mesh_models_job_data {
+    const ogt_voxel_meshify_context* ctx;               // the context to mesh models with. 
+    const ogt_mesh_voxel_model*      models;
+    const ogt_mesh_rgba*             palette;
+    ogt_mesh_algorithm               algorithm;
+    uint32_t                         options;
+    int32_t                          chunk_size;        // if not 0, models are padded chunk grids as per _meshify_padded_chunk.
+    uint32_t*                        max_face_counts;   // the number of simple faces of each model, which bounds the size of its mesh.
+    uint32_t*                        direction_face_counts; // the number of simple faces of each model in each ogt_mesh_direction.
+    ogt_mesh*                        model_meshes;      // the mesh of each model, with room for max_face_counts faces.
+    bool*                            model_failed;      // whether meshing each model failed to allocate temporary memory.
+    ogt_mesh_models*                 result;            // the combined result that model meshes are copied into.
+};
+
+static bool _is_empty_voxel_model(const ogt_mesh_voxel_model& model) {
+    return !model.voxels || !model.size_x || !model.size_y || !model.size_z;
+}
+
+static void _mesh_models_count_faces_job(uint32_t job_index, void* job_data) {
+    ogt_mesh_models_job_data* data = (ogt_mesh_models_job_data*)job_data;
+    const ogt_mesh_voxel_model& model = data->models[job_index];
+    uint32_t* direction_face_counts = &data->direction_face_counts[job_index * ogt_mesh_direction_count];
+    memset(direction_face_counts, 0, ogt_mesh_direction_count * sizeof(uint32_t));
+    data->max_face_counts[job_index] = _is_empty_voxel_model(model) ? 0 : 
+        _count_voxel_sized_faces_per_direction(model.voxels, model.size_x, model.size_y, model.size_z, direction_face_counts);
+}
+
+static void _mesh_models_meshify_job(uint32_t job_index, void* job_data) {
+    ogt_mesh_models_job_data* data = (ogt_mesh_models_job_data*)job_data;
+    const ogt_mesh_voxel_model& model = data->models[job_index];
+    ogt_mesh* mesh = &data->model_meshes[job_index];
+    mesh->vertex_count = 0;
+    mesh->index_count  = 0;
+    memset(mesh->direction_ranges, 0, sizeof(mesh->direction_ranges));
+    data->model_failed[job_index] = false;
+    if (_is_empty_voxel_model(model))
+        return;
+    const uint32_t* direction_face_counts = &data->direction_face_counts[job_index * ogt_mesh_direction_count];
+    bool is_meshed = data->chunk_size ? 
+        _meshify_padded_chunk(data->ctx, data->algorithm, model.voxels, data->chunk_size, data->palette, direction_face_counts, mesh) :
+        _meshify_paletted_voxels(data->ctx, data->algorithm, model.voxels, model.size_x, model.size_y, model.size_z, data->palette, direction_face_counts, mesh);
+    if (!is_meshed) {
+        data->model_failed[job_index] = true;
+        return;
+    }
+    if (data->options & k_ogt_mesh_option_remove_duplicate_vertices)
+        ogt_mesh_remove_duplicate_vertices(data->ctx, mesh);
+    if (data->options & k_ogt_mesh_option_smooth_normals)
+        ogt_mesh_smooth_normals(data->ctx, mesh);
+}
+
+// moves the mesh of a model into its range of the result, and offsets its indices to refer to vertices of the combined mesh.
+static void _mesh_models_combine_job(uint32_t job_index, void* job_data) {
+    ogt_mesh_models_job_data* data = (ogt_mesh_models_job_data*)job_data;
+    const ogt_mesh& src = data->model_meshes[job_index];
+    const ogt_mesh_model_range& range = data->result->model_ranges[job_index];
+    ogt_mesh_vertex* dst_vertices = &data->result->mesh.vertices[range.vertex_offset];
+    uint32_t*        dst_indices  = &data->result->mesh.indices[range.index_offset];
+    if (dst_vertices != src.vertices)
+        memcpy(dst_vertices, src.vertices, range.vertex_count * sizeof(ogt_mesh_vertex));
+    for (uint32_t i = 0; i < range.index_count; i++)
+        dst_indices[i] = src.indices[i] + range.vertex_offset;
+}
+
+// allocates the combined result for model_count models, with room for the specified number of vertices and indices.
+static ogt_mesh_models* _alloc_mesh_models(const ogt_voxel_meshify_context* ctx, uint32_t model_count, uint32_t vertex_capacity, uint32_t index_capacity) {
+    size_t models_size = sizeof(ogt_mesh_models) + (model_count * sizeof(ogt_mesh_model_range)) + 
+        ((size_t)vertex_capacity * sizeof(ogt_mesh_vertex)) + ((size_t)index_capacity * sizeof(uint32_t));
+    ogt_mesh_models* models = (ogt_mesh_models*)_voxel_meshify_malloc(ctx, models_size);
+    if (!models)
+        return NULL;
+    models->model_count       = model_count;
+    models->model_ranges      = (ogt_mesh_model_range*)&models[1];
+    models->mesh.vertices     = (ogt_mesh_vertex*)&models->model_ranges[model_count];
+    models->mesh.indices      = (uint32_t*)&models->mesh.vertices[vertex_capacity];
+    models->mesh.vertex_count = 0;
+    models->mesh.index_count  = 0;
+    memset(models->mesh.direction_ranges, 0, sizeof(models->mesh.direction_ranges));
+    return models;
+}
+
+// implements ogt_mesh_from_paletted_voxel_models. If chunk_size is not 0, models are padded chunk grids as per _meshify_padded_chunk.
+static ogt_mesh_models* _mesh_voxel_models(const ogt_voxel_meshify_context* ctx, const ogt_mesh_voxel_model* models, uint32_t model_count, 
+    const ogt_mesh_rgba* palette, ogt_mesh_algorithm algorithm, uint32_t options, int32_t chunk_size)
+{
+    // when models are meshed in parallel, jobs can't share the scratch arena, and they mesh serially within themselves 
+    // so that we never call parallel_for_func from within one of its own jobs.
+    ogt_voxel_meshify_context job_ctx = *ctx;
+    if (ctx->parallel_for_func && model_count > 1) {
+        job_ctx.scratch           = NULL;
+        job_ctx.parallel_for_func = NULL;
+    }
+
+    ogt_mesh_scratch_mark scratch_mark = _scratch_begin(ctx);
+    void* scratch = _scratch_alloc(ctx, model_count * (sizeof(ogt_mesh) + ((1 + ogt_mesh_direction_count) * sizeof(uint32_t)) + sizeof(bool)));
+    if (!scratch && model_count) {
+        _scratch_end(ctx, scratch_mark);
+        return NULL;
+    }
+    ogt_mesh_models_job_data data;
+    data.ctx             = &job_ctx;
+    data.models          = models;
+    data.palette         = palette;
+    data.algorithm       = algorithm;
+    data.options         = options;
+    data.chunk_size      = chunk_size;
+    data.model_meshes    = (ogt_mesh*)scratch;
+    data.max_face_counts = (uint32_t*)&data.model_meshes[model_count];
+    data.direction_face_counts = &data.max_face_counts[model_count];
+    data.model_failed    = (bool*)&data.direction_face_counts[model_count * ogt_mesh_direction_count];
+    data.result          = NULL;
+
+    // count the faces of each model to bound the size of their meshes, and give each model room for that many faces in a 
+    // result that is big enough to hold all of them.
+    _voxel_meshify_parallel_for(ctx, _mesh_models_count_faces_job, &data, model_count);
+    uint64_t max_face_count = 0;
+    for (uint32_t i = 0; i < model_count; i++)
+        max_face_count += data.max_face_counts[i];
+    ogt_mesh_models* result = (max_face_count * 6 <= UINT32_MAX) ? _alloc_mesh_models(ctx, model_count, (uint32_t)(max_face_count * 4), (uint32_t)(max_face_count * 6)) : NULL;
+    if (!result) {
+        _scratch_free(ctx, scratch);
+        _scratch_end(ctx, scratch_mark);
+        return NULL;
+    }
+    uint32_t face_offset = 0;
+    for (uint32_t i = 0; i < model_count; i++) {
+        data.model_meshes[i].vertices = &result->mesh.vertices[face_offset * 4];
+        data.model_meshes[i].indices  = &result->mesh.indices[face_offset * 6];
+        face_offset += data.max_face_counts[i];
+    }
+
+    _voxel_meshify_parallel_for(ctx, _mesh_models_meshify_job, &data, model_count);
+
+    bool any_model_failed = false;
+    uint32_t vertex_count = 0;
+    uint32_t index_count  = 0;
+    for (uint32_t i = 0; i < model_count; i++) {
+        any_model_failed |= data.model_failed[i];
+        result->model_ranges[i].vertex_offset = vertex_count;
+        result->model_ranges[i].vertex_count  = data.model_meshes[i].vertex_count;
+        result->model_ranges[i].index_offset  = index_count;
+        result->model_ranges[i].index_count   = data.model_meshes[i].index_count;
+        for (uint32_t d = 0; d < ogt_mesh_direction_count; d++) {
+            result->model_ranges[i].direction_ranges[d].index_offset = index_count + data.model_meshes[i].direction_ranges[d].index_offset;
+            result->model_ranges[i].direction_ranges[d].index_count  = data.model_meshes[i].direction_ranges[d].index_count;
+        }
+        vertex_count += data.model_meshes[i].vertex_count;
+        index_count  += data.model_meshes[i].index_count;
+    }
+    if (any_model_failed) {
+        _voxel_meshify_free(ctx, result);
+        _scratch_free(ctx, scratch);
+        _scratch_end(ctx, scratch_mark);
+        return NULL;
+    }
+
+    // if every model used all of its room (eg. simple meshes) the model meshes are already packed together and only their
+    // indices need offsetting. Otherwise we copy them into a result that is exactly the right size.
+    data.result = result;
+    if (vertex_count != max_face_count * 4 || index_count != max_face_count * 6) {
+        data.result = _alloc_mesh_models(ctx, model_count, vertex_count, index_count);
+        if (!data.result) {
+            _voxel_meshify_free(ctx, result);
+            _scratch_free(ctx, scratch);
+            _scratch_end(ctx, scratch_mark);
+            return NULL;
+        }
+        memcpy(data.result->model_ranges, result->model_ranges, model_count * sizeof(ogt_mesh_model_range));
+    }
+    data.result->mesh.vertex_count = vertex_count;
+    data.result->mesh.index_count  = index_count;
+    _voxel_meshify_parallel_for(ctx, _mesh_models_combine_job, &data, model_count);
+    if (data.result != result)
+        _voxel_meshify_free(ctx, result);
+
+    _scratch_free(ctx, scratch);
+    _scratch_end(ctx, scratch_mark);
+    return data.result;
+}
+
+ogt_mesh_models* ogt_mesh_from_paletted_voxel_models(const ogt_voxel_meshify_context* ctx, const ogt_mesh_voxel_model* models, uint32_t model_count, 
+    const ogt_mesh_rgba* palette, ogt_mesh_algorithm algorithm, uint32_t options)
+{
+    return _mesh_voxel_models(ctx, models, model_count, palette, algorithm, options, 0);
+}
+
+#ifdef OGT_VOX_H__
+ogt_mesh_models* ogt_mesh_scene_models(const ogt_voxel_meshify_context* ctx, const ogt_vox_scene* scene, ogt_mesh_algorithm algorithm, uint32_t options)
+{
+    ogt_mesh_scratch_mark scratch_mark = _scratch_begin(ctx);
+    ogt_mesh_voxel_model* models = (ogt_mesh_voxel_model*)_scratch_alloc(ctx, scene->num_models * sizeof(ogt_mesh_voxel_model));
+    if (!models && scene->num_models) {
+        _scratch_end(ctx, scratch_mark);
+        return NULL;
+    }
+    // scenes can have NULL models, which we mesh as empty.
+    for (uint32_t i = 0; i < scene->num_models; i++) {
+        const ogt_vox_model* model = scene->models[i];
+        models[i].voxels = model ? model->voxel_data : NULL;
+        models[i].size_x = model ? model->size_x : 0;
+        models[i].size_y = model ? model->size_y : 0;
+        models[i].size_z = model ? model->size_z : 0;
+    }
+    ogt_mesh_models* result = ogt_mesh_from_paletted_voxel_models(ctx, models, scene->num_models, (const ogt_mesh_rgba*)&scene->palette.color[0], algorithm, options);
+    _scratch_free(ctx, models);
+    _scratch_end(ctx, scratch_mark);
+    return result;
+}
+#endif
+
+void ogt_mesh_models_destroy(const ogt_voxel_meshify_context* ctx, ogt_mesh_models* models)
+{
+    _voxel_meshify_free(ctx, models);
+}
+
+// meshes the surface of all solid voxels with the specified algorithm as if they all had color index 1, into a mesh that is 
+// allocated from scratch memory with room for every simple face. The caller must _scratch_free mesh.vertices, which also 
+// holds the indices. Returns false if memory could not be allocated.
+static bool _meshify_solid_voxels(const ogt_voxel_meshify_context* ctx, const uint8_t* voxels, uint32_t size_x, uint32_t size_y, uint32_t size_z, ogt_mesh_algorithm algorithm, ogt_mesh& mesh)
+{
+    // only color index 1 is ever looked up in the palette.
+    const size_t voxel_count = (size_t)size_x * size_y * size_z;
+    ogt_mesh_rgba palette[2];
+    memset(palette, 0, sizeof(palette));
+    mesh.vertices = NULL;
+
+    uint8_t* solid_voxels = (uint8_t*)_scratch_alloc(ctx, voxel_count);
+    if (!solid_voxels && voxel_count)
+        return false;
+    for (size_t i = 0; i < voxel_count; i++)
+        solid_voxels[i] = voxels[i] ? 1 : 0;
+
+    uint32_t direction_face_counts[ogt_mesh_direction_count];
+    uint32_t max_face_count = _count_voxel_sized_faces_per_direction(solid_voxels, size_x, size_y, size_z, direction_face_counts);
+    mesh.vertices = (ogt_mesh_vertex*)_scratch_alloc(ctx, max_face_count * (4 * sizeof(ogt_mesh_vertex) + 6 * sizeof(uint32_t)));
+    mesh.indices  = (uint32_t*)&mesh.vertices[max_face_count * 4];
+    // ao would split faces and vertices that are otherwise identical, and neither occluders nor atlases use it.
+    ogt_voxel_meshify_context solid_ctx = *ctx;
+    solid_ctx.ambient_occlusion = false;
+    bool is_meshed = (mesh.vertices || !max_face_count) && 
+        _meshify_paletted_voxels(&solid_ctx, algorithm, solid_voxels, size_x, size_y, size_z, palette, direction_face_counts, &mesh);
+    _scratch_free(ctx, solid_voxels);
+    return is_meshed;
+}
+
+ogt_mesh_occluder* ogt_mesh_occluder_from_voxels(const ogt_voxel_meshify_context* ctx, const uint8_t* voxels, uint32_t size_x, uint32_t size_y, uint32_t size_z, ogt_mesh_algorithm algorithm)
+{
+    // give every solid voxel the same color so that meshers merge faces across color changes. The mesh is only needed 
+    // in scratch memory until its vertices are welded.
+    ogt_mesh_scratch_mark scratch_mark = _scratch_begin(ctx);
+    ogt_mesh mesh;
+    bool is_meshed = _meshify_solid_voxels(ctx, voxels, size_x, size_y, size_z, algorithm, mesh);
+
+    // weld vertices by position only, so triangles of all directions share the vertices at their corners.
+    void* weld_scratch = is_meshed ? _scratch_alloc(ctx, _weld_get_scratch_size(mesh.vertex_count, true)) : NULL;
+    ogt_mesh_occluder* occluder = NULL;
+    if (weld_scratch || (is_meshed && !mesh.vertex_count)) {
+        uint32_t unique_vertex_count = 0;
+        ogt_mesh_weld_job_data data;
+        if (mesh.vertex_count) {
+            _weld_setup_job_data(data, weld_scratch, &mesh, true);
+            _weld_find_first_occurrences(ctx, data);
+            for (uint32_t i = 0; i < mesh.vertex_count; i++) {
+                uint32_t first_index = data.remap[i];
+                data.remap[i] = (first_index == i) ? unique_vertex_count++ : data.remap[first_index];
+            }
+        }
+        occluder = (ogt_mesh_occluder*)_voxel_meshify_malloc(ctx, 
+            sizeof(ogt_mesh_occluder) + (unique_vertex_count * sizeof(ogt_mesh_vec3)) + (mesh.index_count * sizeof(uint32_t)));
+        if (occluder) {
+            occluder->vertex_count = unique_vertex_count;
+            occluder->index_count  = mesh.index_count;
+            occluder->positions    = (ogt_mesh_vec3*)&occluder[1];
+            occluder->indices      = (uint32_t*)&occluder->positions[unique_vertex_count];
+            memcpy(occluder->direction_ranges, mesh.direction_ranges, sizeof(occluder->direction_ranges));
+            for (uint32_t i = 0; i < mesh.vertex_count; i++)
+                occluder->positions[data.remap[i]] = mesh.vertices[i].pos;
+            for (uint32_t i = 0; i < mesh.index_count; i++)
+                occluder->indices[i] = data.remap[mesh.indices[i]];
+        }
+        _scratch_free(ctx, weld_scratch);
+    }
+    _scratch_free(ctx, mesh.vertices);
+    _scratch_end(ctx, scratch_mark);
+    return occluder;
+}
+
+void ogt_mesh_occluder_destroy(const ogt_voxel_meshify_context* ctx, ogt_mesh_occluder* occluder)
+{
+    _voxel_meshify_free(ctx, occluder);
+}
+
+// a quad of an atlas mesh, with its size and position in the atlas in texels.
+struct ogt_mesh_atlas_quad {
+    uint32_t width, height;
+    uint32_t atlas_x, atlas_y;
+    uint32_t quad_index;        // index of the quad within the mesh
+    uint32_t direction;         // index into k_face_directions
+};
+
+// orders quads by descending height, then descending width, then by quad index.
+static int _compare_atlas_quads(const void* lhs, const void* rhs) {
+    const ogt_mesh_atlas_quad* a = (const ogt_mesh_atlas_quad*)lhs;
+    const ogt_mesh_atlas_quad* b = (const ogt_mesh_atlas_quad*)rhs;
+    if (a->height != b->height) return a->height > b->height ? -1 : 1;
+    if (a->width  != b->width)  return a->width  > b->width  ? -1 : 1;
+    return a->quad_index < b->quad_index ? -1 : (a->quad_index > b->quad_index ? 1 : 0);
+}
+
+// returns a component of v by axis index.
+static inline float _vec3_axis(const ogt_mesh_vec3& v, uint32_t axis) {
+    return axis == 0 ? v.x : (axis == 1 ? v.y : v.z);
+}
+
+ogt_mesh_atlas* ogt_mesh_atlas_from_paletted_voxels(const ogt_voxel_meshify_context* ctx, const uint8_t* voxels, uint32_t size_x, uint32_t size_y, uint32_t size_z)
+{
+    ogt_mesh_scratch_mark scratch_mark = _scratch_begin(ctx);
+    ogt_mesh mesh;
+    bool is_meshed = _meshify_solid_voxels(ctx, voxels, size_x, size_y, size_z, ogt_mesh_algorithm_greedy, mesh);
+
+    // the greedy mesher emits each quad as 4 vertices at its local (i0,j0), (i1,j0), (i1,j1), (i0,j1) corners followed by 6 
+    // indices, so quads can be recovered from the mesh along with the face direction of the range they are in.
+    const uint32_t quad_count = is_meshed ? mesh.vertex_count / 4 : 0;
+    ogt_mesh_atlas_quad* quads = (ogt_mesh_atlas_quad*)_scratch_alloc(ctx, quad_count * sizeof(ogt_mesh_atlas_quad));
+    ogt_mesh_atlas* result = NULL;
+    if (is_meshed && (quads || !quad_count)) {
+        uint64_t total_area = 0;
+        uint32_t max_width  = 1;
+        for (uint32_t d = 0; d < 6; d++) {
+            const ogt_mesh_face_direction& direction = k_face_directions[d];
+            const ogt_mesh_index_range& range = mesh.direction_ranges[_face_direction_mesh_direction(direction)];
+            for (uint32_t q = range.index_offset / 6; q < (range.index_offset + range.index_count) / 6; q++) {
+                const ogt_mesh_vertex* corners = &mesh.vertices[q * 4];
+                ogt_mesh_atlas_quad& quad = quads[q];
+                quad.width      = (uint32_t)(_vec3_axis(corners[2].pos, direction.axis_x) - _vec3_axis(corners[0].pos, direction.axis_x));
+                quad.height     = (uint32_t)(_vec3_axis(corners[2].pos, direction.axis_y) - _vec3_axis(corners[0].pos, direction.axis_y));
+                quad.quad_index = q;
+                quad.direction  = d;
+                total_area += (uint64_t)quad.width * quad.height;
+                max_width = quad.width > max_width ? quad.width : max_width;
+            }
+        }
+
+        // pack quads into rows from tallest to shortest, in an atlas whose width is the power of 2 that would make it 
+        // about square if packing was perfect.
+        if (quad_count)
+            qsort(quads, quad_count, sizeof(ogt_mesh_atlas_quad), _compare_atlas_quads);
+        uint32_t atlas_width = 1;
+        while ((uint64_t)atlas_width * atlas_width < total_area || atlas_width < max_width)
+            atlas_width *= 2;
+        uint32_t atlas_height = 0, row_x = 0, row_height = 0;
+        for (uint32_t i = 0; i < quad_count; i++) {
+            if (row_x + quads[i].width > atlas_width) {
+                atlas_height += row_height;
+                row_x = 0;
+                row_height = 0;
+            }
+            quads[i].atlas_x = row_x;
+            quads[i].atlas_y = atlas_height;
+            row_x += quads[i].width;
+            row_height = quads[i].height > row_height ? quads[i].height : row_height;
+        }
+        atlas_height += row_height;
+
+        size_t atlas_size = (size_t)atlas_width * atlas_height;
+        result = (ogt_mesh_atlas*)_voxel_meshify_malloc(ctx, sizeof(ogt_mesh_atlas) + 
+            (mesh.vertex_count * sizeof(ogt_mesh_atlas_vertex)) + (mesh.index_count * sizeof(uint32_t)) + atlas_size);
+        if (result) {
+            result->vertex_count = mesh.vertex_count;
+            result->index_count  = mesh.index_count;
+            result->vertices     = (ogt_mesh_atlas_vertex*)&result[1];
+            result->indices      = (uint32_t*)&result->vertices[mesh.vertex_count];
+            result->atlas_width  = atlas_width;
+            result->atlas_height = atlas_height;
+            result->atlas        = (uint8_t*)&result->indices[mesh.index_count];
+            memcpy(result->direction_ranges, mesh.direction_ranges, sizeof(result->direction_ranges));
+            if (mesh.index_count)
+                memcpy(result->indices, mesh.indices, mesh.index_count * sizeof(uint32_t));
+            memset(result->atlas, 0, atlas_size);
+
+            const uint32_t strides[3] = { 1, size_x, size_x * size_y };
+            const float inv_width  = atlas_width  ? 1.0f / (float)atlas_width  : 0.0f;
+            const float inv_height = atlas_height ? 1.0f / (float)atlas_height : 0.0f;
+            for (uint32_t i = 0; i < quad_count; i++) {
+                const ogt_mesh_atlas_quad& quad = quads[i];
+                const ogt_mesh_face_direction& direction = k_face_directions[quad.direction];
+                const ogt_mesh_vertex* corners = &mesh.vertices[quad.quad_index * 4];
+                const uint32_t min_x = (uint32_t)_vec3_axis(corners[0].pos, direction.axis_x);
+                const uint32_t min_y = (uint32_t)_vec3_axis(corners[0].pos, direction.axis_y);
+                // the face lies on the far side of voxels that face a positive direction.
+                const uint32_t plane = (uint32_t)_vec3_axis(corners[0].pos, direction.axis_z);
+                const uint32_t voxel_z = direction.is_negative ? plane : plane - 1;
+
+                for (uint32_t c = 0; c < 4; c++) {
+                    ogt_mesh_atlas_vertex& vertex = result->vertices[quad.quad_index * 4 + c];
+                    vertex.pos    = corners[c].pos;
+                    vertex.normal = corners[c].normal;
+                    vertex.u = ((float)quad.atlas_x + (_vec3_axis(corners[c].pos, direction.axis_x) - (float)min_x)) * inv_width;
+                    vertex.v = ((float)quad.atlas_y + (_vec3_axis(corners[c].pos, direction.axis_y) - (float)min_y)) * inv_height;
+                }
+                for (uint32_t y = 0; y < quad.height; y++) {
+                    uint8_t* texel = &result->atlas[((size_t)(quad.atlas_y + y) * atlas_width) + quad.atlas_x];
+                    const uint8_t* voxel = &voxels[((min_y + y) * strides[direction.axis_y]) + (voxel_z * strides[direction.axis_z]) + (min_x * strides[direction.axis_x])];
+                    for (uint32_t x = 0; x < quad.width; x++)
+                        texel[x] = voxel[x * strides[direction.axis_x]];
+                }
+            }
+        }
+    }
+    _scratch_free(ctx, quads);
+    _scratch_free(ctx, mesh.vertices);
+    _scratch_end(ctx, scratch_mark);
+    return result;
+}
+
+void ogt_mesh_atlas_destroy(const ogt_voxel_meshify_context* ctx, ogt_mesh_atlas* atlas)
+{
+    _voxel_meshify_free(ctx, atlas);
+}
+
+// box keys of voxels that are empty, filled interior space and outside space that is being flood filled.
+static const uint16_t k_box_key_empty    = 0;
+static const uint16_t k_box_key_interior = 256;
+static const uint16_t k_box_key_outside  = 0xFFFF;
+
+// marks every empty voxel that is reachable from outside the grid as outside, and every other empty voxel as interior.
+// stack must have room for an index per voxel.
+static void _fill_box_key_interior(uint16_t* keys, uint32_t size_x, uint32_t size_y, uint32_t size_z, uint32_t* stack) {
+    const uint32_t k_stride_y = size_x;
+    const uint32_t k_stride_z = size_x * size_y;
+    uint32_t stack_size = 0;
+#define PUSH_IF_EMPTY(_index)   if (keys[_index] == k_box_key_empty) { keys[_index] = k_box_key_outside; stack[stack_size++] = (_index); }
+    // seed the fill from all empty voxels on the boundary of the grid.
+    for (uint32_t k = 0; k < size_z; k++) {
+        for (uint32_t j = 0; j < size_y; j++) {
+            bool is_boundary_row = (k == 0 || k == size_z - 1 || j == 0 || j == size_y - 1);
+            for (uint32_t i = 0; i < size_x; i += (is_boundary_row || i == size_x - 1) ? 1 : size_x - 1) {
+                uint32_t index = i + (j * k_stride_y) + (k * k_stride_z);
+                PUSH_IF_EMPTY(index);
+            }
+        }
+    }
+    // flood fill through empty neighbors.
+    while (stack_size) {
+        uint32_t index = stack[--stack_size];
+        uint32_t i = index % size_x;
+        uint32_t j = (index / k_stride_y) % size_y;
+        uint32_t k = index / k_stride_z;
+        if (i > 0)          { PUSH_IF_EMPTY(index - 1); }
+        if (i < size_x - 1) { PUSH_IF_EMPTY(index + 1); }
+        if (j > 0)          { PUSH_IF_EMPTY(index - k_stride_y); }
+        if (j < size_y - 1) { PUSH_IF_EMPTY(index + k_stride_y); }
+        if (k > 0)          { PUSH_IF_EMPTY(index - k_stride_z); }
+        if (k < size_z - 1) { PUSH_IF_EMPTY(index + k_stride_z); }
+    }
+#undef PUSH_IF_EMPTY
+    uint32_t voxel_count = size_x * size_y * size_z;
+    for (uint32_t i = 0; i < voxel_count; i++) {
+        if (keys[i] == k_box_key_empty)
+            keys[i] = k_box_key_interior;
+        else if (keys[i] == k_box_key_outside)
+            keys[i] = k_box_key_empty;
+    }
+}
+
+// returns whether count keys starting at keys all have the value key.
+static inline bool _is_box_key_run(const uint16_t* keys, uint32_t count, uint16_t key) {
+    for (uint32_t i = 0; i < count; i++) {
+        if (keys[i] != key)
+            return false;
+    }
+    return true;
+}
+
+// greedily merges voxels with the same key into boxes, clearing the keys of the voxels that each box covers. Returns the boxes
+// in scratch memory, or NULL if there wasn't enough memory.
+static ogt_mesh_box* _boxes_from_keys(const ogt_voxel_meshify_context* ctx, uint16_t* keys, uint32_t size_x, uint32_t size_y, uint32_t size_z, uint32_t* out_box_count)
+{
+    const uint32_t k_stride_y = size_x;
+    const uint32_t k_stride_z = size_x * size_y;
+
+    // boxes are collected in scratch memory that doubles in size whenever it is full.
+    uint32_t box_count    = 0;
+    uint32_t box_capacity = 256;
+    ogt_mesh_box* boxes = (ogt_mesh_box*)_scratch_alloc(ctx, box_capacity * sizeof(ogt_mesh_box));
+    for (uint32_t k = 0; k < size_z && boxes; k++) {
+        for (uint32_t j = 0; j < size_y && boxes; j++) {
+            for (uint32_t i = 0; i < size_x; i++) {
+                uint16_t* first = &keys[i + (j * k_stride_y) + (k * k_stride_z)];
+                const uint16_t key = *first;
+                if (key == k_box_key_empty)
+                    continue;
+                // grow the box along x, then y, then z for as long as all voxels in the next row or slab match.
+                uint32_t box_size_x = 1, box_size_y = 1, box_size_z = 1;
+                while (i + box_size_x < size_x && first[box_size_x] == key)
+                    box_size_x++;
+                while (j + box_size_y < size_y && _is_box_key_run(&first[box_size_y * k_stride_y], box_size_x, key))
+                    box_size_y++;
+                for (; k + box_size_z < size_z; box_size_z++) {
+                    bool is_slab = true;
+                    for (uint32_t y = 0; y < box_size_y && is_slab; y++)
+                        is_slab = _is_box_key_run(&first[(box_size_z * k_stride_z) + (y * k_stride_y)], box_size_x, key);
+                    if (!is_slab)
+                        break;
+                }
+                for (uint32_t z = 0; z < box_size_z; z++) {
+                    for (uint32_t y = 0; y < box_size_y; y++)
+                        memset(&first[(z * k_stride_z) + (y * k_stride_y)], 0, box_size_x * sizeof(uint16_t));
+                }
+
+                if (box_count == box_capacity) {
+                    ogt_mesh_box* new_boxes = (ogt_mesh_box*)_scratch_alloc(ctx, box_capacity * 2 * sizeof(ogt_mesh_box));
+                    if (new_boxes)
+                        memcpy(new_boxes, boxes, box_count * sizeof(ogt_mesh_box));
+                    _scratch_free(ctx, boxes);
+                    boxes = new_boxes;
+                    box_capacity *= 2;
+                    if (!boxes)
+                        break;
+                }
+                ogt_mesh_box* box = &boxes[box_count++];
+                box->min_x = i;
+                box->min_y = j;
+                box->min_z = k;
+                box->max_x = i + box_size_x;
+                box->max_y = j + box_size_y;
+                box->max_z = k + box_size_z;
+                box->palette_index = 0;
+                i += box_size_x - 1;
+            }
+        }
+    }
+    *out_box_count = box_count;
+    return boxes;
+}
+
+// returns the palette index of the first solid voxel within the cell of scale^3 voxels at x,y,z, or 0 if there isn't one.
+static uint8_t _first_palette_index_in_cell(const uint8_t* voxels, uint32_t size_x, uint32_t size_y, uint32_t size_z, uint32_t x, uint32_t y, uint32_t z, uint32_t scale) {
+    uint32_t end_x = (x + scale < size_x) ? x + scale : size_x;
+    uint32_t end_y = (y + scale < size_y) ? y + scale : size_y;
+    uint32_t end_z = (z + scale < size_z) ? z + scale : size_z;
+    for (uint32_t k = z; k < end_z; k++) {
+        for (uint32_t j = y; j < end_y; j++) {
+            for (uint32_t i = x; i < end_x; i++) {
+                uint8_t palette_index = voxels[i + (j * size_x) + (k * size_x * size_y)];
+                if (palette_index)
+                    return palette_index;
+            }
+        }
+    }
+    return 0;
+}
+
+ogt_mesh_boxes* ogt_boxes_from_paletted_voxels(const ogt_voxel_meshify_context* ctx, const uint8_t* voxels, uint32_t size_x, uint32_t size_y, uint32_t size_z, uint32_t max_box_count, uint32_t options)
+{
+    const uint32_t k_stride_y  = size_x;
+    const uint32_t k_stride_z  = size_x * size_y;
+    const uint32_t voxel_count = size_x * size_y * size_z;
+
+    // voxels can only be merged into a box with voxels of the same key. Keys of voxels are cleared once a box covers them.
+    ogt_mesh_scratch_mark scratch_mark = _scratch_begin(ctx);
+    uint16_t* keys = (uint16_t*)_scratch_alloc(ctx, voxel_count * sizeof(uint16_t));
+    if (!keys && voxel_count) {
+        _scratch_end(ctx, scratch_mark);
+        return NULL;
+    }
+    const bool split_by_palette = (options & k_ogt_boxes_option_split_by_palette) != 0;
+    for (uint32_t i = 0; i < voxel_count; i++)
+        keys[i] = voxels[i] ? (split_by_palette ? voxels[i] : 1) : k_box_key_empty;
+    if (options & k_ogt_boxes_option_fill_interior) {
+        uint32_t* stack = (uint32_t*)_scratch_alloc(ctx, voxel_count * sizeof(uint32_t));
+        if (!stack && voxel_count) {
+            _scratch_free(ctx, keys);
+            _scratch_end(ctx, scratch_mark);
+            return NULL;
+        }
+        _fill_box_key_interior(keys, size_x, size_y, size_z, stack);
+        // without splitting by palette, interior space merges with the solid voxels around it.
+        if (!split_by_palette) {
+            for (uint32_t i = 0; i < voxel_count; i++)
+                keys[i] = keys[i] ? 1 : k_box_key_empty;
+        }
+        _scratch_free(ctx, stack);
+    }
+
+    // keep the keys of all voxels in case the boxes need to be coarsened to fit within max_box_count.
+    uint16_t* voxel_keys = NULL;
+    if (max_box_count && voxel_count) {
+        voxel_keys = (uint16_t*)_scratch_alloc(ctx, voxel_count * sizeof(uint16_t));
+        if (!voxel_keys) {
+            _scratch_free(ctx, keys);
+            _scratch_end(ctx, scratch_mark);
+            return NULL;
+        }
+        memcpy(voxel_keys, keys, voxel_count * sizeof(uint16_t));
+    }
+
+    uint32_t box_count = 0;
+    ogt_mesh_box* boxes = _boxes_from_keys(ctx, keys, size_x, size_y, size_z, &box_count);
+    for (uint32_t i = 0; boxes && i < box_count; i++)
+        boxes[i].palette_index = voxels[boxes[i].min_x + (boxes[i].min_y * k_stride_y) + (boxes[i].min_z * k_stride_z)];
+
+    // while there are too many boxes, merge voxels into cells twice as big on each axis as before, where each cell has the 
+    // key of its first solid voxel, and make boxes from those instead. A single cell always fits, so this always finishes.
+    uint32_t scale = 1;
+    while (boxes && max_box_count && box_count > max_box_count) {
+        _scratch_free(ctx, boxes);
+        scale *= 2;
+        uint32_t cells_x = (size_x + scale - 1) / scale;
+        uint32_t cells_y = (size_y + scale - 1) / scale;
+        uint32_t cells_z = (size_z + scale - 1) / scale;
+        memset(keys, 0, cells_x * cells_y * cells_z * sizeof(uint16_t));
+        for (uint32_t k = 0; k < size_z; k++) {
+            for (uint32_t j = 0; j < size_y; j++) {
+                uint16_t* cell_keys = &keys[((j / scale) * cells_x) + ((k / scale) * cells_x * cells_y)];
+                const uint16_t* row_keys = &voxel_keys[(j * k_stride_y) + (k * k_stride_z)];
+                for (uint32_t i = 0; i < size_x; i++) {
+                    if (row_keys[i] != k_box_key_empty && cell_keys[i / scale] == k_box_key_empty)
+                        cell_keys[i / scale] = row_keys[i];
+                }
+            }
+        }
+        boxes = _boxes_from_keys(ctx, keys, cells_x, cells_y, cells_z, &box_count);
+        for (uint32_t i = 0; boxes && i < box_count; i++) {
+            ogt_mesh_box* box = &boxes[i];
+            box->min_x *= scale;
+            box->min_y *= scale;
+            box->min_z *= scale;
+            box->max_x = (box->max_x * scale < size_x) ? box->max_x * scale : size_x;
+            box->max_y = (box->max_y * scale < size_y) ? box->max_y * scale : size_y;
+            box->max_z = (box->max_z * scale < size_z) ? box->max_z * scale : size_z;
+            box->palette_index = _first_palette_index_in_cell(voxels, size_x, size_y, size_z, box->min_x, box->min_y, box->min_z, scale);
+        }
+    }
+
+    ogt_mesh_boxes* result = NULL;
+    if (boxes) {
+        result = (ogt_mesh_boxes*)_voxel_meshify_malloc(ctx, sizeof(ogt_mesh_boxes) + (box_count * sizeof(ogt_mesh_box)));
+        if (result) {
+            result->box_count = box_count;
+            result->boxes     = (ogt_mesh_box*)&result[1];
+            result->scale     = scale;
+            memcpy(result->boxes, boxes, box_count * sizeof(ogt_mesh_box));
+        }
+        _scratch_free(ctx, boxes);
+    }
+    _scratch_free(ctx, voxel_keys);
+    _scratch_free(ctx, keys);
+    _scratch_end(ctx, scratch_mark);
+    return result;
+}
+
+void ogt_boxes_destroy(const ogt_voxel_meshify_context* ctx, ogt_mesh_boxes* boxes)
+{
+    _voxel_meshify_free(ctx, boxes);
+}
+
+// state shared by the jobs that downsample one level of detail from the previous one.
+struct ogt_mesh_lod_job_data {
+    const ogt_mesh_voxel_model* src;
+    ogt_mesh_voxel_model*       dst;
+    ogt_mesh_lod_filter         filter;
+    bool                        preserve_surface;
+};
+
+// returns whether the solid voxel at (x,y,z) has an empty neighbor, or is on the boundary of the grid.
+static inline bool _is_surface_voxel(const ogt_mesh_voxel_model& model, uint32_t x, uint32_t y, uint32_t z) {
+    const uint32_t k_stride_y = model.size_x;
+    const uint32_t k_stride_z = model.size_x * model.size_y;
+    if (x == 0 || y == 0 || z == 0 || x == model.size_x - 1 || y == model.size_y - 1 || z == model.size_z - 1)
+        return true;
+    const uint8_t* voxel = &model.voxels[x + (y * k_stride_y) + (z * k_stride_z)];
+    return !voxel[-1] || !voxel[1] || !voxel[-(int32_t)k_stride_y] || !voxel[k_stride_y] || !voxel[-(int32_t)k_stride_z] || !voxel[k_stride_z];
+}
+
+// downsamples a single z slice of the destination level.
+static void _downsample_lod_slice_job(uint32_t job_index, void* job_data) {
+    const ogt_mesh_lod_job_data* data = (const ogt_mesh_lod_job_data*)job_data;
+    const ogt_mesh_voxel_model& src = *data->src;
+    const ogt_mesh_voxel_model& dst = *data->dst;
+    const uint32_t z = job_index;
+    uint8_t* dst_voxels = (uint8_t*)&dst.voxels[z * dst.size_x * dst.size_y];
+    for (uint32_t y = 0; y < dst.size_y; y++) {
+        for (uint32_t x = 0; x < dst.size_x; x++) {
+            // gather the colors of the solid voxels in the 2x2x2 cell, some of which may be outside the grid for odd sizes.
+            uint8_t  colors[8];
+            bool     is_surface[8];
+            uint32_t voxel_count = 0;
+            uint32_t solid_count = 0;
+            uint32_t surface_count = 0;
+            for (uint32_t k = z * 2; k < z * 2 + 2 && k < src.size_z; k++) {
+                for (uint32_t j = y * 2; j < y * 2 + 2 && j < src.size_y; j++) {
+                    for (uint32_t i = x * 2; i < x * 2 + 2 && i < src.size_x; i++) {
+                        voxel_count++;
+                        uint8_t color = src.voxels[i + (j * src.size_x) + (k * src.size_x * src.size_y)];
+                        if (!color)
+                            continue;
+                        colors[solid_count] = color;
+                        is_surface[solid_count] = data->preserve_surface && _is_surface_voxel(src, i, j, k);
+                        surface_count += is_surface[solid_count] ? 1 : 0;
+                        solid_count++;
+                    }
+                }
+            }
+            bool is_solid = (data->filter == ogt_mesh_lod_filter_majority) ? (solid_count * 2 >= voxel_count && solid_count) : (solid_count > 0);
+            uint8_t best_color = 0;
+            if (is_solid) {
+                // pick the most frequent color, only counting surface voxels if there are any. Ties go to the first color found.
+                uint32_t best_count = 0;
+                for (uint32_t a = 0; a < solid_count; a++) {
+                    if (surface_count && !is_surface[a])
+                        continue;
+                    uint32_t count = 0;
+                    for (uint32_t b = 0; b < solid_count; b++)
+                        count += (colors[b] == colors[a] && (!surface_count || is_surface[b])) ? 1 : 0;
+                    if (count > best_count) {
+                        best_count = count;
+                        best_color = colors[a];
+                    }
+                }
+            }
+            dst_voxels[x + (y * dst.size_x)] = best_color;
+        }
+    }
+}
+
+ogt_mesh_voxel_lods* ogt_mesh_voxel_lods_create(const ogt_voxel_meshify_context* ctx, const uint8_t* voxels, uint32_t size_x, uint32_t size_y, uint32_t size_z, uint32_t max_lod_count, ogt_mesh_lod_filter filter, uint32_t options)
+{
+    // count the levels and the voxels of all levels, so the result can be a single allocation.
+    uint32_t lod_count   = 0;
+    size_t   voxel_count = 0;
+    for (uint32_t x = size_x, y = size_y, z = size_z; !max_lod_count || lod_count < max_lod_count; x = (x + 1) / 2, y = (y + 1) / 2, z = (z + 1) / 2) {
+        lod_count++;
+        voxel_count += (size_t)x * y * z;
+        if (x <= 1 && y <= 1 && z <= 1)
+            break;
+    }
+    ogt_mesh_voxel_lods* lods = (ogt_mesh_voxel_lods*)_voxel_meshify_malloc(ctx, sizeof(ogt_mesh_voxel_lods) + (lod_count * sizeof(ogt_mesh_voxel_model)) + voxel_count);
+    if (!lods)
+        return NULL;
+    lods->lod_count = lod_count;
+    lods->lods      = (ogt_mesh_voxel_model*)&lods[1];
+
+    uint8_t* lod_voxels = (uint8_t*)&lods->lods[lod_count];
+    memcpy(lod_voxels, voxels, (size_t)size_x * size_y * size_z);
+    ogt_mesh_lod_job_data data;
+    data.filter           = filter;
+    data.preserve_surface = (options & k_ogt_mesh_lod_option_preserve_surface) != 0;
+    for (uint32_t i = 0; i < lod_count; i++) {
+        ogt_mesh_voxel_model& lod = lods->lods[i];
+        lod.voxels = lod_voxels;
+        lod.size_x = i ? (lods->lods[i - 1].size_x + 1) / 2 : size_x;
+        lod.size_y = i ? (lods->lods[i - 1].size_y + 1) / 2 : size_y;
+        lod.size_z = i ? (lods->lods[i - 1].size_z + 1) / 2 : size_z;
+        lod_voxels += (size_t)lod.size_x * lod.size_y * lod.size_z;
+        if (i) {
+            data.src = &lods->lods[i - 1];
+            data.dst = &lod;
+            _voxel_meshify_parallel_for(ctx, _downsample_lod_slice_job, &data, lod.size_z);
+        }
+    }
+    return lods;
+}
+
+#ifdef OGT_VOX_H__
+ogt_mesh_voxel_lods* ogt_mesh_voxel_lods_from_vox_model(const ogt_voxel_meshify_context* ctx, const ogt_vox_model* model, uint32_t max_lod_count, ogt_mesh_lod_filter filter, uint32_t options)
+{
+    return ogt_mesh_voxel_lods_create(ctx, model->voxel_data, model->size_x, model->size_y, model->size_z, max_lod_count, filter, options);
+}
+#endif
+
+ogt_mesh_models* ogt_mesh_voxel_lods_meshify(const ogt_voxel_meshify_context* ctx, const ogt_mesh_voxel_lods* lods, const ogt_mesh_rgba* palette, ogt_mesh_algorithm algorithm, uint32_t options)
+{
+    ogt_mesh_models* result = ogt_mesh_from_paletted_voxel_models(ctx, lods->lods, lods->lod_count, palette, algorithm, options);
+    if (!result)
+        return NULL;
+    for (uint32_t i = 1; i < result->model_count; i++) {
+        const float scale = (float)(1u << i);
+        const ogt_mesh_model_range& range = result->model_ranges[i];
+        for (uint32_t v = 0; v < range.vertex_count; v++) {
+            ogt_mesh_vertex& vertex = result->mesh.vertices[range.vertex_offset + v];
+            vertex.pos.x *= scale;
+            vertex.pos.y *= scale;
+            vertex.pos.z *= scale;
+        }
+    }
+    return result;
+}
+
+void ogt_mesh_voxel_lods_destroy(const ogt_voxel_meshify_context* ctx, ogt_mesh_voxel_lods* lods)
+{
+    _voxel_meshify_free(ctx, lods);
+}
+
+// the chunk size used by ogt_mesh_chunks_from_voxel_instances when none is specified.
+static const uint32_t k_default_chunk_size = 32;
+
+// state shared by the jobs of ogt_mesh_chunks_from_voxel_instances.
+struct ogt_mesh_chunks_job_data {
+    const ogt_mesh_voxel_model*    models;
+    const ogt_mesh_voxel_instance* instances;
+    const int32_t*                 instance_bounds;   // the world voxel min x,y,z then max x,y,z (inclusive) of each instance. min > max if it has no voxels.
+    uint32_t                       instance_count;
+    int32_t                        chunk_size;
+    const ogt_mesh_chunk*          chunks;
+    uint8_t*                       padded_voxels;     // the voxels of each chunk, padded by a voxel of its neighbours on each side.
+    ogt_mesh_voxel_model*          padded_grids;      // the padded grid of each chunk.
+};
+
+// divides and rounds toward negative infinity, so that negative world positions map to the right chunk.
+static inline int32_t _floor_div(int32_t a, int32_t b) {
+    return (a >= 0) ? (a / b) : -((-a + b - 1) / b);
+}
+
+static int _compare_chunks(const void* lhs, const void* rhs) {
+    const ogt_mesh_chunk* a = (const ogt_mesh_chunk*)lhs;
+    const ogt_mesh_chunk* b = (const ogt_mesh_chunk*)rhs;
+    if (a->min_z != b->min_z) return a->min_z < b->min_z ? -1 : 1;
+    if (a->min_y != b->min_y) return a->min_y < b->min_y ? -1 : 1;
+    return a->min_x < b->min_x ? -1 : (a->min_x > b->min_x ? 1 : 0);
+}
+
+// rasterizes every instance that overlaps a chunk or its padding into the padded grid of the chunk, in instance order.
+static void _rasterize_chunk_job(uint32_t job_index, void* job_data) {
+    ogt_mesh_chunks_job_data* data = (ogt_mesh_chunks_job_data*)job_data;
+    const ogt_mesh_chunk& chunk = data->chunks[job_index];
+    const int32_t padded_size = data->chunk_size + 2;
+    const size_t  padded_voxel_count = (size_t)padded_size * padded_size * padded_size;
+    uint8_t* grid = &data->padded_voxels[job_index * padded_voxel_count];
+    memset(grid, 0, padded_voxel_count);
+    const int32_t grid_min[3]     = { chunk.min_x - 1, chunk.min_y - 1, chunk.min_z - 1 };
+    const int32_t grid_strides[3] = { 1, padded_size, padded_size * padded_size };
+
+    for (uint32_t i = 0; i < data->instance_count; i++) {
+        const int32_t* bounds = &data->instance_bounds[i * 6];
+        int32_t min[3], max[3];
+        bool is_overlapping = true;
+        for (uint32_t a = 0; a < 3; a++) {
+            min[a] = bounds[a] > grid_min[a] ? bounds[a] : grid_min[a];
+            max[a] = bounds[3 + a] < (grid_min[a] + padded_size - 1) ? bounds[3 + a] : (grid_min[a] + padded_size - 1);
+            is_overlapping &= min[a] <= max[a];
+        }
+        if (!is_overlapping)
+            continue;
+
+        // steps through model voxels for a step along each world axis, starting at the model voxel at the min world voxel.
+        const ogt_mesh_voxel_instance& instance = data->instances[i];
+        const ogt_mesh_voxel_model& model = data->models[instance.model_index];
+        const int32_t model_strides[3] = { 1, (int32_t)model.size_x, (int32_t)(model.size_x * model.size_y) };
+        int32_t steps[3];
+        int32_t first_voxel = 0;
+        for (uint32_t a = 0; a < 3; a++) {
+            steps[a] = instance.negate[a] ? -model_strides[instance.axes[a]] : model_strides[instance.axes[a]];
+            first_voxel += (min[a] - instance.offset[a]) * steps[a];
+        }
+        for (int32_t z = min[2]; z <= max[2]; z++) {
+            for (int32_t y = min[1]; y <= max[1]; y++) {
+                const uint8_t* src = &model.voxels[first_voxel + ((z - min[2]) * steps[2]) + ((y - min[1]) * steps[1])];
+                uint8_t*       dst = &grid[(min[0] - grid_min[0]) + ((y - grid_min[1]) * grid_strides[1]) + ((z - grid_min[2]) * grid_strides[2])];
+                for (int32_t x = 0; x <= max[0] - min[0]; x++) {
+                    uint8_t color_index = src[x * steps[0]];
+                    if (color_index)
+                        dst[x] = color_index;
+                }
+            }
+        }
+    }
+    ogt_mesh_voxel_model& padded_grid = data->padded_grids[job_index];
+    padded_grid.voxels = grid;
+    padded_grid.size_x = padded_size;
+    padded_grid.size_y = padded_size;
+    padded_grid.size_z = padded_size;
+}
+
+ogt_mesh_chunks* ogt_mesh_chunks_from_voxel_instances(const ogt_voxel_meshify_context* ctx, const ogt_mesh_voxel_model* models, uint32_t model_count, 
+    const ogt_mesh_voxel_instance* instances, uint32_t instance_count, const ogt_mesh_rgba* palette, uint32_t chunk_size, ogt_mesh_algorithm algorithm, uint32_t options)
+{
+    if (!chunk_size)
+        chunk_size = k_default_chunk_size;
+    const int32_t size = (int32_t)chunk_size;
+
+    // find the world bounds of each instance, and how many chunks they overlap in total.
+    ogt_mesh_scratch_mark scratch_mark = _scratch_begin(ctx);
+    int32_t* instance_bounds = (int32_t*)_scratch_alloc(ctx, instance_count * 6 * sizeof(int32_t));
+    if (!instance_bounds && instance_count) {
+        _scratch_end(ctx, scratch_mark);
+        return NULL;
+    }
+    uint64_t max_chunk_count = 0;
+    for (uint32_t i = 0; i < instance_count; i++) {
+        const ogt_mesh_voxel_instance& instance = instances[i];
+        int32_t* bounds = &instance_bounds[i * 6];
+        if (instance.model_index >= model_count || _is_empty_voxel_model(models[instance.model_index])) {
+            bounds[0] = bounds[1] = bounds[2] = 0;
+            bounds[3] = bounds[4] = bounds[5] = -1;
+            continue;
+        }
+        const ogt_mesh_voxel_model& model = models[instance.model_index];
+        const int32_t model_sizes[3] = { (int32_t)model.size_x, (int32_t)model.size_y, (int32_t)model.size_z };
+        uint64_t instance_chunk_count = 1;
+        for (uint32_t a = 0; a < 3; a++) {
+            int32_t extent = model_sizes[instance.axes[a]] - 1;
+            bounds[a]     = instance.negate[a] ? instance.offset[a] - extent : instance.offset[a];
+            bounds[3 + a] = bounds[a] + extent;
+            instance_chunk_count *= (uint64_t)(_floor_div(bounds[3 + a], size) - _floor_div(bounds[a], size) + 1);
+        }
+        max_chunk_count += instance_chunk_count;
+    }
+    ogt_mesh_chunk* chunks = (max_chunk_count <= UINT32_MAX) ? (ogt_mesh_chunk*)_scratch_alloc(ctx, (size_t)max_chunk_count * sizeof(ogt_mesh_chunk)) : NULL;
+    if (!chunks && max_chunk_count) {
+        _scratch_free(ctx, instance_bounds);
+        _scratch_end(ctx, scratch_mark);
+        return NULL;
+    }
+
+    // the sparse set of chunks is every chunk that any instance overlaps.
+    uint32_t chunk_count = 0;
+    for (uint32_t i = 0; i < instance_count; i++) {
+        const int32_t* bounds = &instance_bounds[i * 6];
+        if (bounds[0] > bounds[3])
+            continue;
+        for (int32_t z = _floor_div(bounds[2], size); z <= _floor_div(bounds[5], size); z++) {
+            for (int32_t y = _floor_div(bounds[1], size); y <= _floor_div(bounds[4], size); y++) {
+                for (int32_t x = _floor_div(bounds[0], size); x <= _floor_div(bounds[3], size); x++) {
+                    chunks[chunk_count].min_x = x * size;
+                    chunks[chunk_count].min_y = y * size;
+                    chunks[chunk_count].min_z = z * size;
+                    chunk_count++;
+                }
+            }
+        }
+    }
+    if (chunk_count)
+        qsort(chunks, chunk_count, sizeof(ogt_mesh_chunk), _compare_chunks);
+    uint32_t unique_chunk_count = 0;
+    for (uint32_t i = 0; i < chunk_count; i++) {
+        if (unique_chunk_count && !_compare_chunks(&chunks[unique_chunk_count - 1], &chunks[i]))
+            continue;
+        chunks[unique_chunk_count++] = chunks[i];
+    }
+    chunk_count = unique_chunk_count;
+
+    // rasterize and mesh each chunk in its own job.
+    const size_t padded_voxel_count = (size_t)(size + 2) * (size + 2) * (size + 2);
+    ogt_mesh_chunks_job_data data;
+    data.models          = models;
+    data.instances       = instances;
+    data.instance_bounds = instance_bounds;
+    data.instance_count  = instance_count;
+    data.chunk_size      = size;
+    data.chunks          = chunks;
+    data.padded_grids    = (ogt_mesh_voxel_model*)_scratch_alloc(ctx, chunk_count * sizeof(ogt_mesh_voxel_model));
+    data.padded_voxels   = (uint8_t*)_scratch_alloc(ctx, chunk_count * padded_voxel_count);
+    ogt_mesh_models* meshes = NULL;
+    if ((data.padded_grids && data.padded_voxels) || !chunk_count) {
+        _voxel_meshify_parallel_for(ctx, _rasterize_chunk_job, &data, chunk_count);
+        meshes = _mesh_voxel_models(ctx, data.padded_grids, chunk_count, palette, algorithm, options, size);
+    }
+    ogt_mesh_chunks* result = meshes ? (ogt_mesh_chunks*)_voxel_meshify_malloc(ctx, sizeof(ogt_mesh_chunks) + (chunk_count * sizeof(ogt_mesh_chunk))) : NULL;
+    if (result) {
+        // drop chunks that overlapped an instance without getting any triangles, and move positions from padded grid space to world space.
+        result->chunk_size  = chunk_size;
+        result->chunks      = (ogt_mesh_chunk*)&result[1];
+        result->meshes      = meshes;
+        result->chunk_count = 0;
+        for (uint32_t i = 0; i < chunk_count; i++) {
+            const ogt_mesh_model_range range = meshes->model_ranges[i];
+            if (!range.index_count)
+                continue;
+            const ogt_mesh_chunk& chunk = chunks[i];
+            for (uint32_t v = 0; v < range.vertex_count; v++) {
+                ogt_mesh_vec3& pos = meshes->mesh.vertices[range.vertex_offset + v].pos;
+                pos.x += (float)(chunk.min_x - 1);
+                pos.y += (float)(chunk.min_y - 1);
+                pos.z += (float)(chunk.min_z - 1);
+            }
+            result->chunks[result->chunk_count] = chunk;
+            meshes->model_ranges[result->chunk_count] = range;
+            result->chunk_count++;
+        }
+        meshes->model_count = result->chunk_count;
+    }
+    else if (meshes) {
+        ogt_mesh_models_destroy(ctx, meshes);
+    }
+    _scratch_free(ctx, data.padded_voxels);
+    _scratch_free(ctx, data.padded_grids);
+    _scratch_free(ctx, chunks);
+    _scratch_free(ctx, instance_bounds);
+    _scratch_end(ctx, scratch_mark);
+    return result;
+}
+
+#ifdef OGT_VOX_H__
+ogt_mesh_chunks* ogt_mesh_chunks_from_scene(const ogt_voxel_meshify_context* ctx, const ogt_vox_scene* scene, uint32_t layer_index, uint32_t chunk_size, ogt_mesh_algorithm algorithm, uint32_t options)
+{
+    ogt_mesh_scratch_mark scratch_mark = _scratch_begin(ctx);
+    ogt_mesh_voxel_model*    models    = (ogt_mesh_voxel_model*)_scratch_alloc(ctx, scene->num_models * sizeof(ogt_mesh_voxel_model));
+    ogt_mesh_voxel_instance* instances = (ogt_mesh_voxel_instance*)_scratch_alloc(ctx, scene->num_instances * sizeof(ogt_mesh_voxel_instance));
+    if ((!models && scene->num_models) || (!instances && scene->num_instances)) {
+        _scratch_free(ctx, instances);
+        _scratch_free(ctx, models);
+        _scratch_end(ctx, scratch_mark);
+        return NULL;
+    }
+    for (uint32_t i = 0; i < scene->num_models; i++) {
+        const ogt_vox_model* model = scene->models[i];
+        models[i].voxels = model ? model->voxel_data : NULL;
+        models[i].size_x = model ? model->size_x : 0;
+        models[i].size_y = model ? model->size_y : 0;
+        models[i].size_z = model ? model->size_z : 0;
+    }
+
+    uint32_t instance_count = 0;
+    for (uint32_t i = 0; i < scene->num_instances; i++) {
+        const ogt_vox_instance* instance = &scene->instances[i];
+        bool is_skipped = instance->hidden || instance->model_index >= scene->num_models || 
+            (layer_index != k_ogt_mesh_all_layers && instance->layer_index != layer_index) ||
+            (instance->layer_index < scene->num_layers && scene->layers[instance->layer_index].hidden);
+        for (uint32_t group_index = instance->group_index; !is_skipped && group_index < scene->num_groups; group_index = scene->groups[group_index].parent_group_index)
+            is_skipped = scene->groups[group_index].hidden;
+        if (is_skipped)
+            continue;
+
+        // transforms of instances are rotations of the model around its center voxel, which is at half its size rounded down, 
+        // followed by a whole voxel translation. Column c of the rotation is where model axis c points in world space.
+        const ogt_vox_transform transform = ogt_vox_sample_instance_transform_global(instance, 0, scene);
+        const float* columns = &transform.m00;
+        const ogt_mesh_voxel_model& model = models[instance->model_index];
+        const int32_t model_sizes[3] = { (int32_t)model.size_x, (int32_t)model.size_y, (int32_t)model.size_z };
+        ogt_mesh_voxel_instance& flat_instance = instances[instance_count++];
+        flat_instance.model_index = instance->model_index;
+        for (uint32_t a = 0; a < 3; a++) {
+            flat_instance.axes[a]   = (uint8_t)a;
+            flat_instance.negate[a] = false;
+            for (uint32_t c = 0; c < 3; c++) {
+                if (columns[c * 4 + a] != 0.0f) {
+                    flat_instance.axes[a]   = (uint8_t)c;
+                    flat_instance.negate[a] = columns[c * 4 + a] < 0.0f;
+                }
+            }
+            int32_t translation = (int32_t)columns[12 + a];
+            int32_t half_size   = model_sizes[flat_instance.axes[a]] / 2;
+            flat_instance.offset[a] = flat_instance.negate[a] ? translation + half_size - 1 : translation - half_size;
+        }
+    }
+    ogt_mesh_chunks* result = ogt_mesh_chunks_from_voxel_instances(ctx, models, scene->num_models, instances, instance_count, 
+        (const ogt_mesh_rgba*)&scene->palette.color[0], chunk_size, algorithm, options);
+    _scratch_free(ctx, instances);
+    _scratch_free(ctx, models);
+    _scratch_end(ctx, scratch_mark);
+    return result;
+}
+#endif
+
+void ogt_mesh_chunks_destroy(const ogt_voxel_meshify_context* ctx, ogt_mesh_chunks* chunks)
+{
+    if (!chunks)
+        return;
+    ogt_mesh_models_destroy(ctx, chunks->meshes);
+    _voxel_meshify_free(ctx, chunks);
+}
+
 #endif // #ifdef OGT_VOXEL_MESHIFY_IMPLEMENTATION
 
 /* -------------------------------------------------------------------------------------------------------------------------------------------------
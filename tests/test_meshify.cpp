@@ -0,0 +1,1368 @@
+/*
+    test_meshify - MIT license - Justin Paver, October 2026
+
+    A program that checks the output of the ogt_voxel_meshify.h api functions against brute force answers
+    computed from the voxels themselves: every mesher must cover exactly the visible voxel faces with the
+    right colors, variants that should be equivalent must produce equivalent meshes, and every function
+    must cope with grids that have no solid voxels at all. Returns 0 if all checks pass.
+
+    Please see the MIT license information at the end of this file, and please consider
+    sharing any improvements you make.
+*/
+
+#define OGT_VOXEL_MESHIFY_IMPLEMENTATION
+#include "../src/ogt_voxel_meshify.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+static uint32_t g_check_count   = 0;
+static uint32_t g_failure_count = 0;
+
+// records a failed check with a description of what was being tested. Only the first few failures of a run are printed.
+#define CHECK(_cond, ...)                                                       \
+    do {                                                                        \
+        g_check_count++;                                                        \
+        if (!(_cond)) {                                                         \
+            if (g_failure_count++ < 50) {                                       \
+                printf("FAILED %s:%d: %s: ", __FILE__, __LINE__, #_cond);       \
+                printf(__VA_ARGS__);                                            \
+                printf("\n");                                                   \
+            }                                                                   \
+        }                                                                       \
+    } while (0)
+
+// a small deterministic hash, so test grids are identical on every run and platform.
+uint32_t hash_u32(uint32_t x) {
+    x ^= x >> 16;
+    x *= 0x7feb352d;
+    x ^= x >> 15;
+    x *= 0x846ca68b;
+    x ^= x >> 16;
+    return x;
+}
+
+// a voxel grid to test with.
+struct test_grid {
+    std::string          name;
+    uint32_t             size_x, size_y, size_z;
+    std::vector<uint8_t> voxels;
+
+    uint8_t get(int32_t x, int32_t y, int32_t z) const {
+        if (x < 0 || y < 0 || z < 0 || x >= (int32_t)size_x || y >= (int32_t)size_y || z >= (int32_t)size_z)
+            return 0;
+        return voxels[x + (y * size_x) + (z * size_x * size_y)];
+    }
+    void set(uint32_t x, uint32_t y, uint32_t z, uint8_t color_index) {
+        voxels[x + (y * size_x) + (z * size_x * size_y)] = color_index;
+    }
+};
+
+test_grid make_grid(const char* name, uint32_t size_x, uint32_t size_y, uint32_t size_z) {
+    test_grid grid;
+    grid.name   = name;
+    grid.size_x = size_x;
+    grid.size_y = size_y;
+    grid.size_z = size_z;
+    grid.voxels.assign((size_t)size_x * size_y * size_z, 0);
+    return grid;
+}
+
+// random voxels, where solid_percent of them are solid with one of color_count colors.
+test_grid make_noise_grid(const char* name, uint32_t size_x, uint32_t size_y, uint32_t size_z, uint32_t solid_percent, uint32_t color_count, uint32_t seed) {
+    test_grid grid = make_grid(name, size_x, size_y, size_z);
+    for (uint32_t i = 0; i < grid.voxels.size(); i++) {
+        uint32_t h = hash_u32((i + 1) * 2654435761u + seed);
+        grid.voxels[i] = (h % 100) < solid_percent ? (uint8_t)(1 + ((h >> 8) % color_count)) : 0;
+    }
+    return grid;
+}
+
+// the grids that every mesher is checked against. They cover single voxels, grids that are wider than the 64 voxel occupancy
+// masks, big flat polygons with holes, enclosed space, and the best and worst cases for merging faces.
+std::vector<test_grid> make_test_grids() {
+    std::vector<test_grid> grids;
+    grids.push_back(make_grid("empty", 3, 4, 5));
+
+    test_grid single = make_grid("single", 1, 1, 1);
+    single.set(0, 0, 0, 7);
+    grids.push_back(single);
+
+    grids.push_back(make_noise_grid("noise", 19, 13, 11, 50, 3, 1));
+    grids.push_back(make_noise_grid("wide", 130, 3, 2, 60, 2, 2));
+    grids.push_back(make_noise_grid("sparse", 17, 9, 6, 10, 200, 3));
+
+    test_grid solid = make_grid("solid", 8, 8, 8);
+    std::fill(solid.voxels.begin(), solid.voxels.end(), 4);
+    grids.push_back(solid);
+
+    test_grid shell = make_grid("shell", 10, 9, 8);
+    for (uint32_t z = 0; z < shell.size_z; z++)
+        for (uint32_t y = 0; y < shell.size_y; y++)
+            for (uint32_t x = 0; x < shell.size_x; x++)
+                if (x == 0 || y == 0 || z == 0 || x == shell.size_x - 1 || y == shell.size_y - 1 || z == shell.size_z - 1)
+                    shell.set(x, y, z, (uint8_t)(1 + ((x / 4 + y / 3) % 3)));
+    grids.push_back(shell);
+
+    // a big single colored slab with random holes and a few islands of another color, which makes large polygons with holes.
+    test_grid slab = make_grid("slab_holes", 48, 40, 2);
+    for (uint32_t y = 0; y < slab.size_y; y++) {
+        for (uint32_t x = 0; x < slab.size_x; x++) {
+            uint32_t h = hash_u32(x * 977 + y * 131 + 5);
+            uint8_t color_index = (h % 100) < 8 ? 0 : ((h % 100) < 12 ? 9 : 3);
+            slab.set(x, y, 0, color_index);
+            slab.set(x, y, 1, (x % 7 == 3 || y % 5 == 2) ? 0 : 3);
+        }
+    }
+    grids.push_back(slab);
+
+    test_grid terrain = make_grid("terrain", 32, 32, 16);
+    for (uint32_t y = 0; y < terrain.size_y; y++) {
+        for (uint32_t x = 0; x < terrain.size_x; x++) {
+            uint32_t height = 4 + (uint32_t)(5.0f + 3.0f * sinf(x * 0.4f) + 2.5f * cosf(y * 0.3f));
+            for (uint32_t z = 0; z < height && z < terrain.size_z; z++)
+                terrain.set(x, y, z, (uint8_t)(z + 1 == height ? 1 : (z + 3 >= height ? 2 : 3)));
+        }
+    }
+    grids.push_back(terrain);
+
+    test_grid checker = make_grid("checker", 7, 7, 7);
+    for (uint32_t z = 0; z < checker.size_z; z++)
+        for (uint32_t y = 0; y < checker.size_y; y++)
+            for (uint32_t x = 0; x < checker.size_x; x++)
+                checker.set(x, y, z, ((x + y + z) & 1) ? 0 : (uint8_t)(1 + (x % 2)));
+    grids.push_back(checker);
+    return grids;
+}
+
+// a palette where every color index maps to a distinct, fully opaque color.
+void make_test_palette(ogt_mesh_rgba* palette) {
+    for (uint32_t i = 0; i < 256; i++) {
+        palette[i].r = (uint8_t)(i * 37);
+        palette[i].g = (uint8_t)(i * 91);
+        palette[i].b = (uint8_t)(i * 173);
+        palette[i].a = i ? 255 : 0;
+    }
+}
+
+ogt_voxel_meshify_context make_context() {
+    ogt_voxel_meshify_context ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    return ctx;
+}
+
+// runs jobs on the calling thread in reverse order, so tests catch any dependency on jobs running in order.
+void reverse_parallel_for(ogt_voxel_meshify_job_func job_func, void* job_data, uint32_t job_count, void* user_data) {
+    (void)user_data;
+    for (uint32_t i = job_count; i > 0; i--)
+        job_func(i - 1, job_data);
+}
+
+ogt_voxel_meshify_context make_parallel_context() {
+    ogt_voxel_meshify_context ctx = make_context();
+    ctx.parallel_for_func = reverse_parallel_for;
+    return ctx;
+}
+
+// a voxel face, identified by the direction it faces and the voxel that it belongs to.
+struct face_key {
+    int32_t direction;
+    int32_t x, y, z;
+    bool operator<(const face_key& other) const {
+        if (direction != other.direction) return direction < other.direction;
+        if (x != other.x) return x < other.x;
+        if (y != other.y) return y < other.y;
+        return z < other.z;
+    }
+};
+
+typedef std::map<face_key, uint8_t> face_map;   // the palette index of each face
+
+static const int32_t k_direction_offsets[6][3] = { { 1, 0, 0 }, { -1, 0, 0 }, { 0, 1, 0 }, { 0, -1, 0 }, { 0, 0, 1 }, { 0, 0, -1 } };
+
+// returns every face of a solid voxel that has an empty neighbor, with the palette index of the voxel.
+face_map expected_faces(const test_grid& grid) {
+    face_map faces;
+    for (int32_t z = 0; z < (int32_t)grid.size_z; z++) {
+        for (int32_t y = 0; y < (int32_t)grid.size_y; y++) {
+            for (int32_t x = 0; x < (int32_t)grid.size_x; x++) {
+                uint8_t color_index = grid.get(x, y, z);
+                if (!color_index)
+                    continue;
+                for (int32_t d = 0; d < 6; d++) {
+                    if (!grid.get(x + k_direction_offsets[d][0], y + k_direction_offsets[d][1], z + k_direction_offsets[d][2])) {
+                        face_key key = { d, x, y, z };
+                        faces[key] = color_index;
+                    }
+                }
+            }
+        }
+    }
+    return faces;
+}
+
+// a triangle of any kind of mesh that the library makes.
+struct test_triangle {
+    ogt_mesh_vec3 pos[3];
+    uint32_t      palette_index[3];     // UINT32_MAX where the mesh doesn't have palette indices
+    float         uv[3][2];             // only set for atlas meshes
+};
+
+static inline float vec3_axis(const ogt_mesh_vec3& v, uint32_t axis) {
+    return axis == 0 ? v.x : (axis == 1 ? v.y : v.z);
+}
+
+// returns the direction that the triangle faces, or -1 if it isn't an axis aligned triangle with integer coordinates.
+int32_t triangle_direction(const test_triangle& tri) {
+    ogt_mesh_vec3 a = { tri.pos[1].x - tri.pos[0].x, tri.pos[1].y - tri.pos[0].y, tri.pos[1].z - tri.pos[0].z };
+    ogt_mesh_vec3 b = { tri.pos[2].x - tri.pos[0].x, tri.pos[2].y - tri.pos[0].y, tri.pos[2].z - tri.pos[0].z };
+    float n[3] = { (a.y * b.z) - (a.z * b.y), (a.z * b.x) - (a.x * b.z), (a.x * b.y) - (a.y * b.x) };
+    uint32_t axis = 0;
+    for (uint32_t i = 1; i < 3; i++)
+        if (fabsf(n[i]) > fabsf(n[axis]))
+            axis = i;
+    if (n[axis] == 0.0f || n[(axis + 1) % 3] != 0.0f || n[(axis + 2) % 3] != 0.0f)
+        return -1;
+    for (uint32_t v = 0; v < 3; v++) {
+        for (uint32_t i = 0; i < 3; i++) {
+            float coordinate = vec3_axis(tri.pos[v], i);
+            if (coordinate != floorf(coordinate))
+                return -1;
+        }
+    }
+    return (int32_t)(axis * 2) + (n[axis] < 0.0f ? 1 : 0);
+}
+
+// invokes func(face, barycentric weights) for each voxel face whose sample point is within the triangle. The sample point is
+// slightly off the center of the face, so that it never lies exactly on the edge between two triangles of the same polygon.
+template <typename face_func>
+void for_each_covered_face(const test_triangle& tri, int32_t direction, face_func func) {
+    const uint32_t axis   = (uint32_t)direction / 2;
+    const uint32_t axis_u = (axis + 1) % 3;
+    const uint32_t axis_v = (axis + 2) % 3;
+    double u[3], v[3];
+    for (uint32_t i = 0; i < 3; i++) {
+        u[i] = vec3_axis(tri.pos[i], axis_u);
+        v[i] = vec3_axis(tri.pos[i], axis_v);
+    }
+    const double area = ((u[1] - u[0]) * (v[2] - v[0])) - ((u[2] - u[0]) * (v[1] - v[0]));
+    const int32_t plane = (int32_t)vec3_axis(tri.pos[0], axis);
+    const int32_t min_u = (int32_t)std::min(u[0], std::min(u[1], u[2])), max_u = (int32_t)std::max(u[0], std::max(u[1], u[2]));
+    const int32_t min_v = (int32_t)std::min(v[0], std::min(v[1], v[2])), max_v = (int32_t)std::max(v[0], std::max(v[1], v[2]));
+    for (int32_t cv = min_v; cv < max_v; cv++) {
+        for (int32_t cu = min_u; cu < max_u; cu++) {
+            double su = cu + 0.5123, sv = cv + 0.4871;
+            double w0 = (((u[1] - su) * (v[2] - sv)) - ((u[2] - su) * (v[1] - sv))) / area;
+            double w1 = (((u[2] - su) * (v[0] - sv)) - ((u[0] - su) * (v[2] - sv))) / area;
+            double w2 = 1.0 - w0 - w1;
+            if (w0 <= 0.0 || w1 <= 0.0 || w2 <= 0.0)
+                continue;
+            int32_t voxel[3];
+            voxel[axis]   = (direction & 1) ? plane : plane - 1;
+            voxel[axis_u] = cu;
+            voxel[axis_v] = cv;
+            face_key key = { direction, voxel[0], voxel[1], voxel[2] };
+            double weights[3] = { w0, w1, w2 };
+            func(key, weights);
+        }
+    }
+}
+
+// returns the area of the triangle in units of voxel faces.
+double triangle_area(const test_triangle& tri) {
+    ogt_mesh_vec3 a = { tri.pos[1].x - tri.pos[0].x, tri.pos[1].y - tri.pos[0].y, tri.pos[1].z - tri.pos[0].z };
+    ogt_mesh_vec3 b = { tri.pos[2].x - tri.pos[0].x, tri.pos[2].y - tri.pos[0].y, tri.pos[2].z - tri.pos[0].z };
+    double n[3] = { (double)(a.y * b.z) - (a.z * b.y), (double)(a.z * b.x) - (a.x * b.z), (double)(a.x * b.y) - (a.y * b.x) };
+    return 0.5 * sqrt((n[0] * n[0]) + (n[1] * n[1]) + (n[2] * n[2]));
+}
+
+// checks that the triangles cover every expected face exactly once, cover nothing else, and have the palette index of the face
+// at every vertex when check_palette is set.
+void check_covers_faces(const std::string& name, const std::vector<test_triangle>& triangles, const face_map& expected, bool check_palette) {
+    std::map<face_key, uint32_t> coverage;
+    double   area = 0.0;
+    uint32_t bad_triangle_count  = 0;
+    uint32_t bad_palette_count   = 0;
+    for (size_t t = 0; t < triangles.size(); t++) {
+        const test_triangle& tri = triangles[t];
+        int32_t direction = triangle_direction(tri);
+        if (direction < 0) {
+            bad_triangle_count++;
+            continue;
+        }
+        area += triangle_area(tri);
+        for_each_covered_face(tri, direction, [&](const face_key& key, const double*) {
+            coverage[key]++;
+            face_map::const_iterator it = expected.find(key);
+            if (check_palette && it != expected.end()) {
+                for (uint32_t v = 0; v < 3; v++)
+                    bad_palette_count += (tri.palette_index[v] != it->second) ? 1 : 0;
+            }
+        });
+    }
+    CHECK(bad_triangle_count == 0, "%s: %u triangles are degenerate or not axis aligned", name.c_str(), bad_triangle_count);
+    CHECK(bad_palette_count == 0, "%s: %u vertices have the wrong palette index", name.c_str(), bad_palette_count);
+
+    uint32_t missing_count = 0, overlap_count = 0, extra_count = 0;
+    for (face_map::const_iterator it = expected.begin(); it != expected.end(); ++it) {
+        std::map<face_key, uint32_t>::const_iterator covered = coverage.find(it->first);
+        if (covered == coverage.end())
+            missing_count++;
+        else if (covered->second > 1)
+            overlap_count++;
+    }
+    for (std::map<face_key, uint32_t>::const_iterator it = coverage.begin(); it != coverage.end(); ++it)
+        extra_count += expected.count(it->first) ? 0 : 1;
+    CHECK(missing_count == 0, "%s: %u of %u faces are not covered", name.c_str(), missing_count, (uint32_t)expected.size());
+    CHECK(overlap_count == 0, "%s: %u faces are covered more than once", name.c_str(), overlap_count);
+    CHECK(extra_count == 0, "%s: %u faces are covered that shouldn't be", name.c_str(), extra_count);
+    CHECK(fabs(area - (double)expected.size()) < 1e-3, "%s: triangles cover an area of %f rather than %u faces", name.c_str(), area, (uint32_t)expected.size());
+}
+
+std::vector<test_triangle> triangles_from_mesh(const ogt_mesh* mesh, uint32_t index_offset, uint32_t index_count) {
+    std::vector<test_triangle> triangles(index_count / 3);
+    for (uint32_t t = 0; t < triangles.size(); t++) {
+        for (uint32_t v = 0; v < 3; v++) {
+            const ogt_mesh_vertex& vertex = mesh->vertices[mesh->indices[index_offset + (t * 3) + v]];
+            triangles[t].pos[v]           = vertex.pos;
+            triangles[t].palette_index[v] = vertex.palette_index;
+        }
+    }
+    return triangles;
+}
+
+std::vector<test_triangle> triangles_from_mesh(const ogt_mesh* mesh) {
+    return triangles_from_mesh(mesh, 0, mesh->index_count);
+}
+
+// checks that indices are in range and that direction_ranges partition the indices into triangles that face each direction.
+void check_direction_ranges(const std::string& name, const ogt_mesh* mesh) {
+    uint32_t bad_index_count = 0;
+    for (uint32_t i = 0; i < mesh->index_count; i++)
+        bad_index_count += mesh->indices[i] >= mesh->vertex_count ? 1 : 0;
+    CHECK(bad_index_count == 0, "%s: %u indices are out of range", name.c_str(), bad_index_count);
+    CHECK(mesh->index_count % 3 == 0, "%s: index count %u is not a multiple of 3", name.c_str(), mesh->index_count);
+    if (bad_index_count)
+        return;
+    // the ranges may be in any order, but together they cover every index once.
+    std::vector<uint32_t> range_of_index(mesh->index_count, UINT32_MAX);
+    uint32_t bad_direction_count = 0, bad_range_count = 0;
+    for (uint32_t d = 0; d < ogt_mesh_direction_count; d++) {
+        const ogt_mesh_index_range& range = mesh->direction_ranges[d];
+        if (range.index_offset + range.index_count > mesh->index_count || range.index_offset % 3 || range.index_count % 3) {
+            bad_range_count++;
+            continue;
+        }
+        for (uint32_t i = range.index_offset; i < range.index_offset + range.index_count; i++) {
+            bad_range_count += range_of_index[i] != UINT32_MAX ? 1 : 0;
+            range_of_index[i] = d;
+        }
+        std::vector<test_triangle> triangles = triangles_from_mesh(mesh, range.index_offset, range.index_count);
+        for (size_t t = 0; t < triangles.size(); t++)
+            bad_direction_count += triangle_direction(triangles[t]) != (int32_t)d ? 1 : 0;
+    }
+    uint32_t uncovered_count = (uint32_t)std::count(range_of_index.begin(), range_of_index.end(), UINT32_MAX);
+    CHECK(bad_range_count == 0, "%s: %u direction ranges are out of bounds or overlap", name.c_str(), bad_range_count);
+    CHECK(uncovered_count == 0, "%s: %u indices are not in any direction range", name.c_str(), uncovered_count);
+    CHECK(bad_direction_count == 0, "%s: %u triangles are in the range of the wrong direction", name.c_str(), bad_direction_count);
+}
+
+// checks that the colors of vertices come from the palette and that normals point in the direction of each triangle.
+void check_vertices(const std::string& name, const ogt_mesh* mesh, const ogt_mesh_rgba* palette) {
+    uint32_t bad_color_count = 0, bad_normal_count = 0;
+    for (uint32_t i = 0; i < mesh->vertex_count; i++) {
+        const ogt_mesh_vertex& vertex = mesh->vertices[i];
+        bad_color_count += memcmp(&vertex.color, &palette[vertex.palette_index & 255], sizeof(ogt_mesh_rgba)) != 0 ? 1 : 0;
+    }
+    std::vector<test_triangle> triangles = triangles_from_mesh(mesh);
+    for (uint32_t t = 0; t < triangles.size(); t++) {
+        int32_t direction = triangle_direction(triangles[t]);
+        if (direction < 0)
+            continue;
+        for (uint32_t v = 0; v < 3; v++) {
+            const ogt_mesh_vec3& normal = mesh->vertices[mesh->indices[t * 3 + v]].normal;
+            bad_normal_count += (normal.x != (float)k_direction_offsets[direction][0] || normal.y != (float)k_direction_offsets[direction][1] ||
+                                 normal.z != (float)k_direction_offsets[direction][2]) ? 1 : 0;
+        }
+    }
+    CHECK(bad_color_count == 0, "%s: %u vertices don't have the color of their palette index", name.c_str(), bad_color_count);
+    CHECK(bad_normal_count == 0, "%s: %u vertices have a normal that doesn't match their triangle", name.c_str(), bad_normal_count);
+}
+
+static const char* k_algorithm_names[4] = { "simple", "simple_shared", "greedy", "polygon" };
+
+ogt_mesh* mesh_grid(const ogt_voxel_meshify_context* ctx, const test_grid& grid, const ogt_mesh_rgba* palette, ogt_mesh_algorithm algorithm) {
+    switch (algorithm) {
+        case ogt_mesh_algorithm_simple:        return ogt_mesh_from_paletted_voxels_simple(ctx, grid.voxels.data(), grid.size_x, grid.size_y, grid.size_z, palette);
+        case ogt_mesh_algorithm_simple_shared: return ogt_mesh_from_paletted_voxels_simple_shared(ctx, grid.voxels.data(), grid.size_x, grid.size_y, grid.size_z, palette);
+        case ogt_mesh_algorithm_greedy:        return ogt_mesh_from_paletted_voxels_greedy(ctx, grid.voxels.data(), grid.size_x, grid.size_y, grid.size_z, palette);
+        case ogt_mesh_algorithm_polygon:       return ogt_mesh_from_paletted_voxels_polygon(ctx, grid.voxels.data(), grid.size_x, grid.size_y, grid.size_z, palette);
+    }
+    return NULL;
+}
+
+// orders vertices by their contents, so meshes can be compared regardless of vertex order.
+bool vertex_less(const ogt_mesh_vertex& a, const ogt_mesh_vertex& b) {
+    return memcmp(&a, &b, sizeof(ogt_mesh_vertex)) < 0;
+}
+
+// a triangle as the contents of its vertices, rotated so that the smallest vertex is first, so that triangles can be compared
+// regardless of vertex and triangle order.
+struct vertex_triangle {
+    ogt_mesh_vertex v[3];
+    bool operator<(const vertex_triangle& other) const {
+        return memcmp(v, other.v, sizeof(v)) < 0;
+    }
+    bool operator==(const vertex_triangle& other) const {
+        return memcmp(v, other.v, sizeof(v)) == 0;
+    }
+};
+
+std::vector<vertex_triangle> sorted_vertex_triangles(const ogt_mesh* mesh) {
+    std::vector<vertex_triangle> triangles(mesh->index_count / 3);
+    for (uint32_t t = 0; t < triangles.size(); t++) {
+        uint32_t first = 0;
+        for (uint32_t v = 1; v < 3; v++)
+            if (vertex_less(mesh->vertices[mesh->indices[t * 3 + v]], mesh->vertices[mesh->indices[t * 3 + first]]))
+                first = v;
+        for (uint32_t v = 0; v < 3; v++)
+            triangles[t].v[v] = mesh->vertices[mesh->indices[t * 3 + ((first + v) % 3)]];
+    }
+    std::sort(triangles.begin(), triangles.end());
+    return triangles;
+}
+
+// returns the number of vertices that are identical to another vertex.
+uint32_t count_duplicate_vertices(const ogt_mesh* mesh) {
+    std::vector<ogt_mesh_vertex> vertices(mesh->vertices, mesh->vertices + mesh->vertex_count);
+    std::sort(vertices.begin(), vertices.end(), vertex_less);
+    uint32_t duplicate_count = 0;
+    for (size_t i = 1; i < vertices.size(); i++)
+        duplicate_count += memcmp(&vertices[i - 1], &vertices[i], sizeof(ogt_mesh_vertex)) == 0 ? 1 : 0;
+    return duplicate_count;
+}
+
+bool meshes_identical(const ogt_mesh* a, const ogt_mesh* b) {
+    return a->vertex_count == b->vertex_count && a->index_count == b->index_count &&
+           memcmp(a->vertices, b->vertices, a->vertex_count * sizeof(ogt_mesh_vertex)) == 0 &&
+           memcmp(a->indices, b->indices, a->index_count * sizeof(uint32_t)) == 0;
+}
+
+// returns the ao of a vertex, which is always 3 when OGT_VOXEL_MESHIFY_VERTEX_AO isn't defined.
+uint8_t vertex_ao(const ogt_mesh_vertex& vertex) {
+#ifdef OGT_VOXEL_MESHIFY_VERTEX_AO
+    return vertex.ao;
+#else
+    (void)vertex;
+    return 3;
+#endif
+}
+
+// returns the ambient occlusion of the corner of a voxel face as documented: 3 minus the number of solid voxels around the
+// corner in front of the face, or 0 if both voxels along the edges of the face are solid.
+uint8_t expected_corner_ao(const test_grid& grid, const face_key& face, const ogt_mesh_vec3& corner) {
+    const uint32_t axis   = (uint32_t)face.direction / 2;
+    const uint32_t axis_u = (axis + 1) % 3;
+    const uint32_t axis_v = (axis + 2) % 3;
+    int32_t front[3] = { face.x + k_direction_offsets[face.direction][0], face.y + k_direction_offsets[face.direction][1], face.z + k_direction_offsets[face.direction][2] };
+    // step from the voxel in front of the face toward the corner along each of the other axes.
+    int32_t step_u = (vec3_axis(corner, axis_u) > (float)front[axis_u]) ? 1 : -1;
+    int32_t step_v = (vec3_axis(corner, axis_v) > (float)front[axis_v]) ? 1 : -1;
+    int32_t side_u[3] = { front[0], front[1], front[2] };
+    int32_t side_v[3] = { front[0], front[1], front[2] };
+    side_u[axis_u] += step_u;
+    side_v[axis_v] += step_v;
+    int32_t diagonal[3] = { side_u[0], side_u[1], side_u[2] };
+    diagonal[axis_v] += step_v;
+    bool solid_u = grid.get(side_u[0], side_u[1], side_u[2]) != 0;
+    bool solid_v = grid.get(side_v[0], side_v[1], side_v[2]) != 0;
+    bool solid_d = grid.get(diagonal[0], diagonal[1], diagonal[2]) != 0;
+    if (solid_u && solid_v)
+        return 0;
+    return (uint8_t)(3 - (solid_u ? 1 : 0) - (solid_v ? 1 : 0) - (solid_d ? 1 : 0));
+}
+
+// checks the ao of every vertex of a mesh made of single voxel faces against the brute force ao of its corner.
+void check_simple_ao(const std::string& name, const test_grid& grid, const ogt_mesh* mesh) {
+    uint32_t bad_ao_count = 0;
+    std::vector<test_triangle> triangles = triangles_from_mesh(mesh);
+    for (uint32_t t = 0; t < triangles.size(); t++) {
+        int32_t direction = triangle_direction(triangles[t]);
+        if (direction < 0)
+            continue;
+        for_each_covered_face(triangles[t], direction, [&](const face_key& key, const double*) {
+            for (uint32_t v = 0; v < 3; v++) {
+                const ogt_mesh_vertex& vertex = mesh->vertices[mesh->indices[t * 3 + v]];
+                bad_ao_count += vertex_ao(vertex) != expected_corner_ao(grid, key, vertex.pos) ? 1 : 0;
+            }
+        });
+    }
+    CHECK(bad_ao_count == 0, "%s: %u vertices have the wrong ao", name.c_str(), bad_ao_count);
+}
+
+// every mesher covers exactly the visible faces, with the right colors, normals and direction ranges.
+void test_meshers(const std::vector<test_grid>& grids, const ogt_mesh_rgba* palette) {
+    ogt_voxel_meshify_context ctx = make_context();
+    for (size_t g = 0; g < grids.size(); g++) {
+        const test_grid& grid = grids[g];
+        face_map expected = expected_faces(grid);
+        uint32_t face_count = ogt_face_count_from_paletted_voxels_simple(grid.voxels.data(), grid.size_x, grid.size_y, grid.size_z);
+        CHECK(face_count == expected.size(), "%s: face count is %u rather than %u", grid.name.c_str(), face_count, (uint32_t)expected.size());
+        for (uint32_t a = 0; a < 4; a++) {
+            std::string name = grid.name + "/" + k_algorithm_names[a];
+            ogt_mesh* mesh = mesh_grid(&ctx, grid, palette, (ogt_mesh_algorithm)a);
+            CHECK(mesh != NULL, "%s: no mesh", name.c_str());
+            if (!mesh)
+                continue;
+            check_covers_faces(name, triangles_from_mesh(mesh), expected, true);
+            check_direction_ranges(name, mesh);
+            check_vertices(name, mesh, palette);
+            ogt_mesh_destroy(&ctx, mesh);
+        }
+    }
+}
+
+// the shared simple mesher makes the same mesh as removing duplicate vertices from the simple mesh, and removing duplicates
+// gives the same result whether or not it runs in jobs.
+void test_shared_vertices(const std::vector<test_grid>& grids, const ogt_mesh_rgba* palette) {
+    ogt_voxel_meshify_context ctx = make_context();
+    ogt_voxel_meshify_context parallel_ctx = make_parallel_context();
+    for (size_t g = 0; g < grids.size(); g++) {
+        const test_grid& grid = grids[g];
+        ogt_mesh* simple   = mesh_grid(&ctx, grid, palette, ogt_mesh_algorithm_simple);
+        ogt_mesh* deduped  = mesh_grid(&ctx, grid, palette, ogt_mesh_algorithm_simple);
+        ogt_mesh* shared   = mesh_grid(&ctx, grid, palette, ogt_mesh_algorithm_simple_shared);
+        ogt_mesh_remove_duplicate_vertices(&ctx, deduped);
+
+        const char* name = grid.name.c_str();
+        CHECK(count_duplicate_vertices(deduped) == 0, "%s: duplicates remain after ogt_mesh_remove_duplicate_vertices", name);
+        CHECK(count_duplicate_vertices(shared) == 0, "%s: simple_shared mesh has duplicate vertices", name);
+        CHECK(shared->vertex_count == deduped->vertex_count, "%s: simple_shared has %u vertices rather than %u", name, shared->vertex_count, deduped->vertex_count);
+        CHECK(sorted_vertex_triangles(shared) == sorted_vertex_triangles(deduped), "%s: simple_shared triangles differ from deduplicated simple triangles", name);
+        ogt_mesh* parallel = mesh_grid(&ctx, grid, palette, ogt_mesh_algorithm_simple);
+        ogt_mesh_remove_duplicate_vertices(&parallel_ctx, parallel);
+        CHECK(deduped->vertex_count <= simple->vertex_count, "%s: removing duplicates added vertices", name);
+        CHECK(meshes_identical(deduped, parallel), "%s: removing duplicates in jobs gives a different mesh", name);
+        CHECK(sorted_vertex_triangles(simple) == sorted_vertex_triangles(deduped), "%s: removing duplicates changed the triangles", name);
+        ogt_mesh_destroy(&ctx, parallel);
+
+        ogt_mesh_destroy(&ctx, shared);
+        ogt_mesh_destroy(&ctx, deduped);
+        ogt_mesh_destroy(&ctx, simple);
+    }
+}
+
+// collects the batches of the batched stream into one mesh.
+struct stream_collector {
+    std::vector<ogt_mesh_vertex> vertices;
+    std::vector<uint32_t>        indices;
+    uint32_t                     max_batch_index_count;
+    uint32_t                     bad_index_count;       // indices that don't refer to a vertex streamed so far
+};
+
+void collect_stream_batch(const ogt_mesh_vertex* vertices, uint32_t vertex_count, const uint32_t* indices, uint32_t index_count, void* user_data) {
+    stream_collector* collector = (stream_collector*)user_data;
+    collector->vertices.insert(collector->vertices.end(), vertices, vertices + vertex_count);
+    for (uint32_t i = 0; i < index_count; i++)
+        collector->bad_index_count += indices[i] >= collector->vertices.size() ? 1 : 0;
+    collector->indices.insert(collector->indices.end(), indices, indices + index_count);
+    collector->max_batch_index_count = std::max(collector->max_batch_index_count, index_count);
+}
+
+void init_stream_collector(stream_collector& collector) {
+    collector.max_batch_index_count = 0;
+    collector.bad_index_count       = 0;
+}
+
+// the batched stream produces the triangles of the simple mesh whatever the batch size, in batches no bigger than requested.
+void test_batched_stream(const std::vector<test_grid>& grids, const ogt_mesh_rgba* palette) {
+    const uint32_t k_batch_sizes[4] = { 0, 1, 7, 100000 };
+    for (size_t g = 0; g < grids.size(); g++) {
+        const test_grid& grid = grids[g];
+        ogt_voxel_meshify_context ctx = make_context();
+        ctx.ambient_occlusion = (g & 1) != 0;
+        ogt_mesh* simple = mesh_grid(&ctx, grid, palette, ogt_mesh_algorithm_simple);
+        std::vector<vertex_triangle> expected = sorted_vertex_triangles(simple);
+        for (uint32_t b = 0; b < 4; b++) {
+            std::string name = grid.name + "/batched stream " + std::to_string(k_batch_sizes[b]);
+            stream_collector collector;
+            init_stream_collector(collector);
+            ogt_stream_from_paletted_voxels_simple_batched(&ctx, grid.voxels.data(), grid.size_x, grid.size_y, grid.size_z, palette, k_batch_sizes[b], collect_stream_batch, &collector);
+            CHECK(collector.bad_index_count == 0, "%s: %u indices refer to vertices that haven't been streamed", name.c_str(), collector.bad_index_count);
+            if (collector.bad_index_count)
+                continue;
+            // a batch always has room for the 6 faces of a voxel.
+            uint32_t max_batch_face_count = k_batch_sizes[b] ? std::max(k_batch_sizes[b], 6u) : 4096;
+            CHECK(collector.max_batch_index_count <= max_batch_face_count * 6, "%s: a batch has %u indices", name.c_str(), collector.max_batch_index_count);
+            ogt_mesh streamed;
+            memset(&streamed, 0, sizeof(streamed));
+            streamed.vertices     = collector.vertices.data();
+            streamed.vertex_count = (uint32_t)collector.vertices.size();
+            streamed.indices      = collector.indices.data();
+            streamed.index_count  = (uint32_t)collector.indices.size();
+            CHECK(sorted_vertex_triangles(&streamed) == expected, "%s: streamed triangles differ from the simple mesh", name.c_str());
+        }
+        ogt_mesh_destroy(&ctx, simple);
+    }
+}
+
+// meshing with a scratch arena gives identical meshes to meshing without one, including when the arena is reused.
+void test_scratch(const std::vector<test_grid>& grids, const ogt_mesh_rgba* palette) {
+    ogt_voxel_meshify_context ctx = make_context();
+    ogt_voxel_meshify_context scratch_ctx = make_context();
+    scratch_ctx.scratch = ogt_voxel_meshify_scratch_create(&ctx, 256);
+    for (uint32_t pass = 0; pass < 2; pass++) {
+        for (size_t g = 0; g < grids.size(); g++) {
+            for (uint32_t a = 0; a < 4; a++) {
+                ogt_mesh* mesh = mesh_grid(&ctx, grids[g], palette, (ogt_mesh_algorithm)a);
+                ogt_mesh* scratch_mesh = mesh_grid(&scratch_ctx, grids[g], palette, (ogt_mesh_algorithm)a);
+                CHECK(meshes_identical(mesh, scratch_mesh), "%s/%s: meshing with a scratch arena differs on pass %u", grids[g].name.c_str(), k_algorithm_names[a], pass);
+                ogt_mesh_destroy(&ctx, scratch_mesh);
+                ogt_mesh_destroy(&ctx, mesh);
+            }
+        }
+    }
+    ogt_voxel_meshify_scratch_destroy(&ctx, scratch_ctx.scratch);
+}
+
+// smoothing gives unit normals and the same result whether or not it runs in jobs. An angle under 90 degrees never smooths
+// across voxel edges, so normals stay as they were.
+void test_smooth_normals(const std::vector<test_grid>& grids, const ogt_mesh_rgba* palette) {
+    for (size_t g = 0; g < grids.size(); g++) {
+        const test_grid& grid = grids[g];
+        const char* name = grid.name.c_str();
+        ogt_voxel_meshify_context ctx = make_context();
+        ogt_voxel_meshify_context parallel_ctx = make_parallel_context();
+        ogt_mesh* serial   = mesh_grid(&ctx, grid, palette, ogt_mesh_algorithm_simple);
+        ogt_mesh* parallel = mesh_grid(&ctx, grid, palette, ogt_mesh_algorithm_simple);
+        ogt_mesh* angled   = mesh_grid(&ctx, grid, palette, ogt_mesh_algorithm_simple);
+        ogt_mesh* original = mesh_grid(&ctx, grid, palette, ogt_mesh_algorithm_simple);
+        ogt_mesh_smooth_normals(&ctx, serial);
+        ogt_mesh_smooth_normals(&parallel_ctx, parallel);
+        ogt_mesh_smooth_normals_with_angle(&parallel_ctx, angled, 60.0f);
+
+        uint32_t bad_length_count = 0, mismatch_count = 0, angled_count = 0;
+        for (uint32_t i = 0; i < serial->vertex_count; i++) {
+            const ogt_mesh_vec3& a = serial->vertices[i].normal;
+            const ogt_mesh_vec3& b = parallel->vertices[i].normal;
+            bad_length_count += fabsf(sqrtf((a.x * a.x) + (a.y * a.y) + (a.z * a.z)) - 1.0f) > 1e-4f ? 1 : 0;
+            mismatch_count   += (fabsf(a.x - b.x) > 1e-5f || fabsf(a.y - b.y) > 1e-5f || fabsf(a.z - b.z) > 1e-5f) ? 1 : 0;
+            angled_count     += memcmp(&angled->vertices[i].normal, &original->vertices[i].normal, sizeof(ogt_mesh_vec3)) != 0 ? 1 : 0;
+        }
+        CHECK(bad_length_count == 0, "%s: %u smoothed normals are not unit length", name, bad_length_count);
+        CHECK(mismatch_count == 0, "%s: %u smoothed normals differ when smoothing in jobs", name, mismatch_count);
+        CHECK(angled_count == 0, "%s: %u normals changed when smoothing with a 60 degree angle", name, angled_count);
+        if (grid.name == "single") {
+            // every corner of a lone voxel is smoothed across its 3 faces, so it points away from the voxel on every axis.
+            uint32_t outward_count = 0;
+            for (uint32_t i = 0; i < serial->vertex_count; i++) {
+                const ogt_mesh_vec3& n = serial->vertices[i].normal;
+                const ogt_mesh_vec3& p = serial->vertices[i].pos;
+                outward_count += ((n.x > 0.0f) == (p.x > 0.5f) && (n.y > 0.0f) == (p.y > 0.5f) && (n.z > 0.0f) == (p.z > 0.5f) && n.x != 0.0f && n.y != 0.0f && n.z != 0.0f) ? 1 : 0;
+            }
+            CHECK(outward_count == serial->vertex_count, "%s: %u of %u corner normals point outward", name, outward_count, serial->vertex_count);
+        }
+        ogt_mesh_destroy(&ctx, original);
+        ogt_mesh_destroy(&ctx, angled);
+        ogt_mesh_destroy(&ctx, parallel);
+        ogt_mesh_destroy(&ctx, serial);
+    }
+}
+
+// applies the k_ogt_mesh_option_* flags to a single mesh as ogt_mesh_from_paletted_voxel_models documents.
+void apply_mesh_options(const ogt_voxel_meshify_context* ctx, ogt_mesh* mesh, uint32_t options) {
+    if (options & k_ogt_mesh_option_remove_duplicate_vertices)
+        ogt_mesh_remove_duplicate_vertices(ctx, mesh);
+    if (options & k_ogt_mesh_option_smooth_normals)
+        ogt_mesh_smooth_normals(ctx, mesh);
+}
+
+// checks that the range of a combined mesh is the same as a mesh of its own, apart from the offset of its indices.
+void check_model_range(const std::string& name, const ogt_mesh_models* models, uint32_t model_index, const ogt_mesh* expected) {
+    const ogt_mesh_model_range& range = models->model_ranges[model_index];
+    CHECK(range.vertex_count == expected->vertex_count && range.index_count == expected->index_count, "%s: range has %u vertices and %u indices rather than %u and %u",
+        name.c_str(), range.vertex_count, range.index_count, expected->vertex_count, expected->index_count);
+    if (range.vertex_count != expected->vertex_count || range.index_count != expected->index_count)
+        return;
+    uint32_t bad_vertex_count = 0, bad_index_count = 0;
+    for (uint32_t i = 0; i < range.vertex_count; i++) {
+        const ogt_mesh_vertex& a = models->mesh.vertices[range.vertex_offset + i];
+        const ogt_mesh_vertex& b = expected->vertices[i];
+        bool same = memcmp(&a.pos, &b.pos, sizeof(a.pos)) == 0 && memcmp(&a.color, &b.color, sizeof(a.color)) == 0 && a.palette_index == b.palette_index &&
+                    vertex_ao(a) == vertex_ao(b) &&
+                    fabsf(a.normal.x - b.normal.x) < 1e-5f && fabsf(a.normal.y - b.normal.y) < 1e-5f && fabsf(a.normal.z - b.normal.z) < 1e-5f;
+        bad_vertex_count += same ? 0 : 1;
+    }
+    for (uint32_t i = 0; i < range.index_count; i++)
+        bad_index_count += models->mesh.indices[range.index_offset + i] != expected->indices[i] + range.vertex_offset ? 1 : 0;
+    CHECK(bad_vertex_count == 0, "%s: %u vertices differ from meshing the model on its own", name.c_str(), bad_vertex_count);
+    CHECK(bad_index_count == 0, "%s: %u indices differ from meshing the model on its own", name.c_str(), bad_index_count);
+    for (uint32_t d = 0; d < ogt_mesh_direction_count; d++) {
+        CHECK(range.direction_ranges[d].index_count == expected->direction_ranges[d].index_count &&
+              range.direction_ranges[d].index_offset == expected->direction_ranges[d].index_offset + range.index_offset,
+              "%s: direction range %u differs from meshing the model on its own", name.c_str(), d);
+    }
+}
+
+// meshing many models at once gives the same mesh for each model as meshing it on its own, for every algorithm and option.
+void test_models(const std::vector<test_grid>& grids, const ogt_mesh_rgba* palette) {
+    std::vector<ogt_mesh_voxel_model> voxel_models(grids.size());
+    for (size_t g = 0; g < grids.size(); g++) {
+        voxel_models[g].voxels = grids[g].voxels.data();
+        voxel_models[g].size_x = grids[g].size_x;
+        voxel_models[g].size_y = grids[g].size_y;
+        voxel_models[g].size_z = grids[g].size_z;
+    }
+    const uint32_t k_options[4] = { 0, k_ogt_mesh_option_remove_duplicate_vertices, k_ogt_mesh_option_smooth_normals,
+                                    k_ogt_mesh_option_remove_duplicate_vertices | k_ogt_mesh_option_smooth_normals };
+    for (uint32_t parallel = 0; parallel < 2; parallel++) {
+        ogt_voxel_meshify_context ctx = parallel ? make_parallel_context() : make_context();
+        for (uint32_t a = 0; a < 4; a++) {
+            for (uint32_t o = 0; o < 4; o++) {
+                ogt_mesh_models* models = ogt_mesh_from_paletted_voxel_models(&ctx, voxel_models.data(), (uint32_t)voxel_models.size(), palette, (ogt_mesh_algorithm)a, k_options[o]);
+                CHECK(models && models->model_count == grids.size(), "%s: no combined mesh for options %u", k_algorithm_names[a], k_options[o]);
+                if (!models)
+                    continue;
+                uint32_t next_vertex = 0, next_index = 0;
+                for (size_t g = 0; g < grids.size(); g++) {
+                    std::string name = grids[g].name + "/" + k_algorithm_names[a] + "/models options " + std::to_string(k_options[o]) + (parallel ? "/parallel" : "");
+                    const ogt_mesh_model_range& range = models->model_ranges[g];
+                    CHECK(range.vertex_offset == next_vertex && range.index_offset == next_index, "%s: ranges are not contiguous", name.c_str());
+                    next_vertex = range.vertex_offset + range.vertex_count;
+                    next_index  = range.index_offset + range.index_count;
+                    ogt_mesh* expected = mesh_grid(&ctx, grids[g], palette, (ogt_mesh_algorithm)a);
+                    apply_mesh_options(&ctx, expected, k_options[o]);
+                    check_model_range(name, models, (uint32_t)g, expected);
+                    ogt_mesh_destroy(&ctx, expected);
+                }
+                CHECK(next_vertex == models->mesh.vertex_count && next_index == models->mesh.index_count, "%s: ranges don't cover the combined mesh", k_algorithm_names[a]);
+                ogt_mesh_models_destroy(&ctx, models);
+            }
+        }
+    }
+}
+
+// optimizing a mesh changes the order of triangles and vertices, but not what they cover, and doesn't make vertex cache use worse.
+void test_optimize(const std::vector<test_grid>& grids, const ogt_mesh_rgba* palette) {
+    ogt_voxel_meshify_context ctx = make_context();
+    for (size_t g = 0; g < grids.size(); g++) {
+        face_map expected = expected_faces(grids[g]);
+        for (uint32_t a = 0; a < 4; a++) {
+            std::string name = grids[g].name + "/" + k_algorithm_names[a] + "/optimized";
+            ogt_mesh* mesh = mesh_grid(&ctx, grids[g], palette, (ogt_mesh_algorithm)a);
+            float acmr_before = ogt_mesh_get_acmr(&ctx, mesh, 0);
+            uint32_t vertex_count_before = mesh->vertex_count;
+            ogt_mesh_optimize(&ctx, mesh, 0);
+            float acmr_after = ogt_mesh_get_acmr(&ctx, mesh, 0);
+            check_covers_faces(name, triangles_from_mesh(mesh), expected, true);
+            check_direction_ranges(name, mesh);
+            std::vector<bool> is_used(mesh->vertex_count, false);
+            for (uint32_t i = 0; i < mesh->index_count; i++)
+                is_used[mesh->indices[i]] = true;
+            CHECK(std::find(is_used.begin(), is_used.end(), false) == is_used.end(), "%s: unused vertices remain", name.c_str());
+            CHECK(mesh->vertex_count <= vertex_count_before, "%s: optimizing added vertices", name.c_str());
+            CHECK(acmr_after <= acmr_before + 1e-4f, "%s: acmr went from %f to %f", name.c_str(), acmr_before, acmr_after);
+            ogt_mesh_destroy(&ctx, mesh);
+        }
+    }
+}
+
+// sorting triangles by direction and palette index gives ranges that only contain triangles of that direction and palette index.
+void test_sort_by_direction(const std::vector<test_grid>& grids, const ogt_mesh_rgba* palette) {
+    ogt_voxel_meshify_context ctx = make_context();
+    std::vector<ogt_mesh_index_range> palette_ranges(ogt_mesh_direction_count * 256);
+    for (size_t g = 0; g < grids.size(); g++) {
+        std::string name = grids[g].name + "/sorted";
+        face_map expected = expected_faces(grids[g]);
+        ogt_mesh* mesh = mesh_grid(&ctx, grids[g], palette, ogt_mesh_algorithm_greedy);
+        // reverse the triangles and forget the ranges, so the sort has some work to do.
+        for (uint32_t t = 0; t < mesh->index_count / 6; t++)
+            std::swap_ranges(&mesh->indices[t * 3], &mesh->indices[t * 3 + 3], &mesh->indices[mesh->index_count - 3 - (t * 3)]);
+        memset(mesh->direction_ranges, 0, sizeof(mesh->direction_ranges));
+        ogt_mesh_sort_triangles_by_direction(&ctx, mesh, palette_ranges.data());
+        check_direction_ranges(name, mesh);
+        check_covers_faces(name, triangles_from_mesh(mesh), expected, true);
+        uint32_t bad_count = 0, covered_index_count = 0;
+        for (uint32_t d = 0; d < ogt_mesh_direction_count; d++) {
+            for (uint32_t p = 0; p < 256; p++) {
+                const ogt_mesh_index_range& range = palette_ranges[d * 256 + p];
+                covered_index_count += range.index_count;
+                std::vector<test_triangle> triangles = triangles_from_mesh(mesh, range.index_offset, range.index_count);
+                for (size_t t = 0; t < triangles.size(); t++)
+                    bad_count += (triangle_direction(triangles[t]) != (int32_t)d || triangles[t].palette_index[0] != p) ? 1 : 0;
+            }
+        }
+        CHECK(bad_count == 0, "%s: %u triangles are in the wrong palette range", name.c_str(), bad_count);
+        CHECK(covered_index_count == mesh->index_count, "%s: palette ranges cover %u of %u indices", name.c_str(), covered_index_count, mesh->index_count);
+        ogt_mesh_destroy(&ctx, mesh);
+    }
+}
+
+// every triangle is in exactly one meshlet, meshlets respect their limits, and their bounds contain their triangles.
+void test_meshlets(const std::vector<test_grid>& grids, const ogt_mesh_rgba* palette) {
+    const uint32_t k_limits[3][2] = { { 0, 0 }, { 3, 1 }, { 256, 512 } };
+    ogt_voxel_meshify_context ctx = make_context();
+    for (size_t g = 0; g < grids.size(); g++) {
+        for (uint32_t a = 0; a < 4; a++) {
+            ogt_mesh* mesh = mesh_grid(&ctx, grids[g], palette, (ogt_mesh_algorithm)a);
+            for (uint32_t l = 0; l < 3; l++) {
+                std::string name = grids[g].name + "/" + k_algorithm_names[a] + "/meshlets " + std::to_string(k_limits[l][0]) + "," + std::to_string(k_limits[l][1]);
+                ogt_mesh_meshlets* meshlets = ogt_mesh_build_meshlets(&ctx, mesh, k_limits[l][0], k_limits[l][1]);
+                CHECK(meshlets != NULL, "%s: no meshlets", name.c_str());
+                if (!meshlets)
+                    continue;
+                uint32_t max_vertices  = k_limits[l][0] ? k_limits[l][0] : 64;
+                uint32_t max_triangles = k_limits[l][1] ? k_limits[l][1] : 124;
+                std::vector<uint32_t> mesh_triangles, meshlet_triangles;
+                for (uint32_t i = 0; i < mesh->index_count; i += 3) {
+                    uint32_t tri[3] = { mesh->indices[i], mesh->indices[i + 1], mesh->indices[i + 2] };
+                    mesh_triangles.insert(mesh_triangles.end(), tri, tri + 3);
+                }
+                uint32_t bad_limit_count = 0, bad_direction_count = 0, bad_bounds_count = 0, triangle_count = 0;
+                for (uint32_t m = 0; m < meshlets->meshlet_count; m++) {
+                    const ogt_mesh_meshlet& meshlet = meshlets->meshlets[m];
+                    bad_limit_count += (meshlet.vertex_count > max_vertices || meshlet.triangle_count > max_triangles || !meshlet.triangle_count) ? 1 : 0;
+                    triangle_count += meshlet.triangle_count;
+                    for (uint32_t t = 0; t < meshlet.triangle_count; t++) {
+                        test_triangle tri;
+                        for (uint32_t v = 0; v < 3; v++) {
+                            uint32_t vertex_index = meshlets->vertices[meshlet.vertex_offset + meshlets->triangles[meshlet.triangle_offset + (t * 3) + v]];
+                            meshlet_triangles.push_back(vertex_index);
+                            tri.pos[v] = mesh->vertices[vertex_index].pos;
+                            const ogt_mesh_vec3& p = tri.pos[v];
+                            float dx = p.x - meshlet.center.x, dy = p.y - meshlet.center.y, dz = p.z - meshlet.center.z;
+                            bad_bounds_count += (p.x < meshlet.aabb_min.x || p.y < meshlet.aabb_min.y || p.z < meshlet.aabb_min.z ||
+                                                 p.x > meshlet.aabb_max.x || p.y > meshlet.aabb_max.y || p.z > meshlet.aabb_max.z ||
+                                                 sqrtf((dx * dx) + (dy * dy) + (dz * dz)) > meshlet.radius + 1e-4f) ? 1 : 0;
+                        }
+                        bad_direction_count += triangle_direction(tri) != (int32_t)meshlet.direction ? 1 : 0;
+                    }
+                }
+                CHECK(bad_limit_count == 0, "%s: %u meshlets are empty or over their limits", name.c_str(), bad_limit_count);
+                CHECK(bad_direction_count == 0, "%s: %u triangles don't face the direction of their meshlet", name.c_str(), bad_direction_count);
+                CHECK(bad_bounds_count == 0, "%s: %u vertices are outside the bounds of their meshlet", name.c_str(), bad_bounds_count);
+                CHECK(triangle_count == meshlets->triangle_count && triangle_count == mesh->index_count / 3, "%s: meshlets have %u triangles rather than %u", name.c_str(), triangle_count, mesh->index_count / 3);
+                // compare the triangles as sorted triples of vertex indices.
+                std::vector<std::vector<uint32_t> > a_sorted, b_sorted;
+                for (size_t i = 0; i + 2 < mesh_triangles.size(); i += 3)
+                    a_sorted.push_back(std::vector<uint32_t>(mesh_triangles.begin() + i, mesh_triangles.begin() + i + 3));
+                for (size_t i = 0; i + 2 < meshlet_triangles.size(); i += 3)
+                    b_sorted.push_back(std::vector<uint32_t>(meshlet_triangles.begin() + i, meshlet_triangles.begin() + i + 3));
+                std::sort(a_sorted.begin(), a_sorted.end());
+                std::sort(b_sorted.begin(), b_sorted.end());
+                CHECK(a_sorted == b_sorted, "%s: meshlet triangles differ from mesh triangles", name.c_str());
+                ogt_mesh_meshlets_destroy(&ctx, meshlets);
+            }
+            ogt_mesh_destroy(&ctx, mesh);
+        }
+    }
+}
+
+// occluders cover all visible faces regardless of color, with a single vertex at each position.
+void test_occluders(const std::vector<test_grid>& grids) {
+    ogt_voxel_meshify_context ctx = make_context();
+    for (size_t g = 0; g < grids.size(); g++) {
+        face_map expected = expected_faces(grids[g]);
+        for (uint32_t a = 0; a < 4; a++) {
+            std::string name = grids[g].name + "/" + k_algorithm_names[a] + "/occluder";
+            ogt_mesh_occluder* occluder = ogt_mesh_occluder_from_voxels(&ctx, grids[g].voxels.data(), grids[g].size_x, grids[g].size_y, grids[g].size_z, (ogt_mesh_algorithm)a);
+            CHECK(occluder != NULL, "%s: no occluder", name.c_str());
+            if (!occluder)
+                continue;
+            std::vector<test_triangle> triangles(occluder->index_count / 3);
+            for (uint32_t t = 0; t < triangles.size(); t++) {
+                for (uint32_t v = 0; v < 3; v++) {
+                    triangles[t].pos[v] = occluder->positions[occluder->indices[t * 3 + v]];
+                    triangles[t].palette_index[v] = UINT32_MAX;
+                }
+            }
+            check_covers_faces(name, triangles, expected, false);
+            uint32_t bad_direction_count = 0, range_index_count = 0;
+            for (uint32_t d = 0; d < ogt_mesh_direction_count; d++) {
+                const ogt_mesh_index_range& range = occluder->direction_ranges[d];
+                range_index_count += range.index_count;
+                for (uint32_t t = range.index_offset / 3; t < (range.index_offset + range.index_count) / 3; t++)
+                    bad_direction_count += triangle_direction(triangles[t]) != (int32_t)d ? 1 : 0;
+            }
+            CHECK(bad_direction_count == 0 && range_index_count == occluder->index_count, "%s: direction ranges are wrong", name.c_str());
+            std::vector<std::vector<float> > positions;
+            for (uint32_t i = 0; i < occluder->vertex_count; i++) {
+                const ogt_mesh_vec3& p = occluder->positions[i];
+                float values[3] = { p.x, p.y, p.z };
+                positions.push_back(std::vector<float>(values, values + 3));
+            }
+            std::sort(positions.begin(), positions.end());
+            CHECK(std::adjacent_find(positions.begin(), positions.end()) == positions.end(), "%s: positions are not welded", name.c_str());
+            ogt_mesh_occluder_destroy(&ctx, occluder);
+        }
+    }
+}
+
+bool boxes_equal(const ogt_mesh_box& a, const ogt_mesh_box& b) {
+    return a.min_x == b.min_x && a.min_y == b.min_y && a.min_z == b.min_z && a.max_x == b.max_x && a.max_y == b.max_y && a.max_z == b.max_z &&
+           a.palette_index == b.palette_index;
+}
+
+// counts how many boxes cover each voxel.
+std::vector<uint32_t> box_coverage(const test_grid& grid, const ogt_mesh_boxes* boxes, uint32_t* out_bad_box_count) {
+    std::vector<uint32_t> coverage(grid.voxels.size(), 0);
+    *out_bad_box_count = 0;
+    for (uint32_t b = 0; b < boxes->box_count; b++) {
+        const ogt_mesh_box& box = boxes->boxes[b];
+        if (box.min_x >= box.max_x || box.min_y >= box.max_y || box.min_z >= box.max_z || box.max_x > grid.size_x || box.max_y > grid.size_y || box.max_z > grid.size_z) {
+            (*out_bad_box_count)++;
+            continue;
+        }
+        for (uint32_t z = box.min_z; z < box.max_z; z++)
+            for (uint32_t y = box.min_y; y < box.max_y; y++)
+                for (uint32_t x = box.min_x; x < box.max_x; x++)
+                    coverage[x + (y * grid.size_x) + (z * grid.size_x * grid.size_y)]++;
+    }
+    return coverage;
+}
+
+// boxes cover exactly the solid voxels without overlapping, or a superset of them when they have to fit a budget.
+void test_boxes(const std::vector<test_grid>& grids) {
+    ogt_voxel_meshify_context ctx = make_context();
+    for (size_t g = 0; g < grids.size(); g++) {
+        const test_grid& grid = grids[g];
+        for (uint32_t options = 0; options < 4; options++) {
+            std::string name = grid.name + "/boxes options " + std::to_string(options);
+            ogt_mesh_boxes* exact = ogt_boxes_from_paletted_voxels(&ctx, grid.voxels.data(), grid.size_x, grid.size_y, grid.size_z, 0, options);
+            CHECK(exact != NULL, "%s: no boxes", name.c_str());
+            if (!exact)
+                continue;
+            uint32_t bad_box_count = 0;
+            std::vector<uint32_t> coverage = box_coverage(grid, exact, &bad_box_count);
+            uint32_t missing_count = 0, overlap_count = 0, empty_count = 0, mixed_count = 0;
+            for (size_t i = 0; i < coverage.size(); i++) {
+                missing_count += (grid.voxels[i] && !coverage[i]) ? 1 : 0;
+                overlap_count += coverage[i] > 1 ? 1 : 0;
+                empty_count   += (!grid.voxels[i] && coverage[i]) ? 1 : 0;
+            }
+            if (options & k_ogt_boxes_option_split_by_palette) {
+                for (uint32_t b = 0; b < exact->box_count; b++) {
+                    const ogt_mesh_box& box = exact->boxes[b];
+                    for (uint32_t z = box.min_z; z < box.max_z; z++)
+                        for (uint32_t y = box.min_y; y < box.max_y; y++)
+                            for (uint32_t x = box.min_x; x < box.max_x; x++)
+                                mixed_count += grid.get(x, y, z) != box.palette_index ? 1 : 0;
+                }
+            }
+            CHECK(bad_box_count == 0, "%s: %u boxes are empty or outside the grid", name.c_str(), bad_box_count);
+            CHECK(exact->scale == 1, "%s: scale is %u without a budget", name.c_str(), exact->scale);
+            CHECK(missing_count == 0, "%s: %u solid voxels are not covered", name.c_str(), missing_count);
+            CHECK(overlap_count == 0, "%s: %u voxels are covered by more than one box", name.c_str(), overlap_count);
+            // only enclosed space may be covered when filling the interior, and it is in its own boxes when splitting by palette.
+            if (!(options & k_ogt_boxes_option_fill_interior))
+                CHECK(empty_count == 0, "%s: %u empty voxels are covered", name.c_str(), empty_count);
+            CHECK(mixed_count == 0, "%s: %u voxels have a different palette index to their box", name.c_str(), mixed_count);
+            if (grid.name == "shell" && (options & k_ogt_boxes_option_fill_interior))
+                CHECK(empty_count == (grid.size_x - 2) * (grid.size_y - 2) * (grid.size_z - 2), "%s: %u voxels of the interior are covered", name.c_str(), empty_count);
+            if (grid.name == "solid")
+                CHECK(exact->box_count == 1, "%s: a solid grid has %u boxes", name.c_str(), exact->box_count);
+
+            const uint32_t k_budgets[4] = { 1, 3, 20, exact->box_count };
+            for (uint32_t b = 0; b < 4; b++) {
+                std::string budget_name = name + " budget " + std::to_string(k_budgets[b]);
+                ogt_mesh_boxes* boxes = ogt_boxes_from_paletted_voxels(&ctx, grid.voxels.data(), grid.size_x, grid.size_y, grid.size_z, k_budgets[b], options);
+                CHECK(boxes != NULL, "%s: no boxes", budget_name.c_str());
+                if (!boxes)
+                    continue;
+                std::vector<uint32_t> budget_coverage = box_coverage(grid, boxes, &bad_box_count);
+                uint32_t budget_missing_count = 0, budget_overlap_count = 0;
+                for (size_t i = 0; i < budget_coverage.size(); i++) {
+                    budget_missing_count += (grid.voxels[i] && !budget_coverage[i]) ? 1 : 0;
+                    budget_overlap_count += budget_coverage[i] > 1 ? 1 : 0;
+                }
+                CHECK(bad_box_count == 0, "%s: %u boxes are empty or outside the grid", budget_name.c_str(), bad_box_count);
+                CHECK(boxes->box_count <= k_budgets[b] || !exact->box_count, "%s: %u boxes are over budget", budget_name.c_str(), boxes->box_count);
+                CHECK(budget_missing_count == 0, "%s: %u solid voxels are not covered", budget_name.c_str(), budget_missing_count);
+                CHECK(budget_overlap_count == 0, "%s: %u voxels are covered by more than one box", budget_name.c_str(), budget_overlap_count);
+                bool is_exact = boxes->box_count == exact->box_count;
+                for (uint32_t i = 0; is_exact && i < exact->box_count; i++)
+                    is_exact = boxes_equal(boxes->boxes[i], exact->boxes[i]);
+                CHECK((boxes->scale == 1) == (exact->box_count <= k_budgets[b]), "%s: scale is %u", budget_name.c_str(), boxes->scale);
+                CHECK(boxes->scale != 1 || is_exact, "%s: boxes within budget differ from boxes without one", budget_name.c_str());
+                ogt_boxes_destroy(&ctx, boxes);
+            }
+            ogt_boxes_destroy(&ctx, exact);
+        }
+    }
+}
+
+// each level of detail is downsampled from the previous one as per its filter, and meshing the levels lines them all up with the
+// full resolution grid.
+void test_lods(const std::vector<test_grid>& grids, const ogt_mesh_rgba* palette) {
+    ogt_voxel_meshify_context ctx = make_parallel_context();
+    for (size_t g = 0; g < grids.size(); g++) {
+        for (uint32_t f = 0; f < 2; f++) {
+            for (uint32_t options = 0; options < 2; options++) {
+                std::string name = grids[g].name + (f ? "/lods conservative" : "/lods majority") + (options ? " preserve_surface" : "");
+                const test_grid& grid = grids[g];
+                ogt_mesh_voxel_lods* lods = ogt_mesh_voxel_lods_create(&ctx, grid.voxels.data(), grid.size_x, grid.size_y, grid.size_z, 0, (ogt_mesh_lod_filter)f, options);
+                CHECK(lods != NULL && lods->lod_count > 0, "%s: no levels", name.c_str());
+                if (!lods || !lods->lod_count)
+                    continue;
+                const ogt_mesh_voxel_model& first = lods->lods[0];
+                CHECK(first.size_x == grid.size_x && first.size_y == grid.size_y && first.size_z == grid.size_z &&
+                      memcmp(first.voxels, grid.voxels.data(), grid.voxels.size()) == 0, "%s: the first level isn't the full resolution grid", name.c_str());
+                const ogt_mesh_voxel_model& last = lods->lods[lods->lod_count - 1];
+                CHECK(last.size_x == 1 && last.size_y == 1 && last.size_z == 1, "%s: the last level is %ux%ux%u", name.c_str(), last.size_x, last.size_y, last.size_z);
+
+                std::vector<test_grid> levels;
+                for (uint32_t l = 0; l < lods->lod_count; l++) {
+                    const ogt_mesh_voxel_model& lod = lods->lods[l];
+                    test_grid level = make_grid(name.c_str(), lod.size_x, lod.size_y, lod.size_z);
+                    memcpy(level.voxels.data(), lod.voxels, level.voxels.size());
+                    levels.push_back(level);
+                    if (!l)
+                        continue;
+                    const test_grid& prev = levels[l - 1];
+                    CHECK(lod.size_x == (prev.size_x + 1) / 2 && lod.size_y == (prev.size_y + 1) / 2 && lod.size_z == (prev.size_z + 1) / 2, "%s: level %u has the wrong size", name.c_str(), l);
+                    uint32_t bad_solid_count = 0, bad_color_count = 0;
+                    for (uint32_t z = 0; z < level.size_z; z++) {
+                        for (uint32_t y = 0; y < level.size_y; y++) {
+                            for (uint32_t x = 0; x < level.size_x; x++) {
+                                uint32_t voxel_count = 0, solid_count = 0;
+                                bool has_color = false;
+                                uint8_t color_index = level.get(x, y, z);
+                                for (uint32_t k = z * 2; k < z * 2 + 2 && k < prev.size_z; k++) {
+                                    for (uint32_t j = y * 2; j < y * 2 + 2 && j < prev.size_y; j++) {
+                                        for (uint32_t i = x * 2; i < x * 2 + 2 && i < prev.size_x; i++) {
+                                            voxel_count++;
+                                            solid_count += prev.get(i, j, k) ? 1 : 0;
+                                            has_color |= prev.get(i, j, k) == color_index;
+                                        }
+                                    }
+                                }
+                                bool is_solid = f ? solid_count > 0 : (solid_count && solid_count * 2 >= voxel_count);
+                                bad_solid_count += (color_index != 0) != is_solid ? 1 : 0;
+                                bad_color_count += (color_index && !has_color) ? 1 : 0;
+                            }
+                        }
+                    }
+                    CHECK(bad_solid_count == 0, "%s: %u voxels of level %u don't follow the filter", name.c_str(), bad_solid_count, l);
+                    CHECK(bad_color_count == 0, "%s: %u voxels of level %u have a color that isn't in their 2x2x2 cell", name.c_str(), bad_color_count, l);
+                }
+
+                ogt_mesh_models* meshes = ogt_mesh_voxel_lods_meshify(&ctx, lods, palette, ogt_mesh_algorithm_greedy, 0);
+                CHECK(meshes && meshes->model_count == lods->lod_count, "%s: no mesh for each level", name.c_str());
+                if (meshes && meshes->model_count == lods->lod_count) {
+                    for (uint32_t l = 0; l < lods->lod_count; l++) {
+                        const ogt_mesh_model_range& range = meshes->model_ranges[l];
+                        std::vector<test_triangle> triangles = triangles_from_mesh(&meshes->mesh, range.index_offset, range.index_count);
+                        float inv_scale = 1.0f / (float)(1u << l);
+                        for (size_t t = 0; t < triangles.size(); t++) {
+                            for (uint32_t v = 0; v < 3; v++) {
+                                triangles[t].pos[v].x *= inv_scale;
+                                triangles[t].pos[v].y *= inv_scale;
+                                triangles[t].pos[v].z *= inv_scale;
+                            }
+                        }
+                        check_covers_faces(name + "/level " + std::to_string(l), triangles, expected_faces(levels[l]), true);
+                    }
+                }
+                ogt_mesh_models_destroy(&ctx, meshes);
+                ogt_mesh_voxel_lods_destroy(&ctx, lods);
+            }
+        }
+    }
+}
+
+// atlas quads cover all visible faces, and the atlas texel under each face is the palette index of its voxel.
+void test_atlas(const std::vector<test_grid>& grids) {
+    ogt_voxel_meshify_context ctx = make_context();
+    for (size_t g = 0; g < grids.size(); g++) {
+        const test_grid& grid = grids[g];
+        std::string name = grid.name + "/atlas";
+        face_map expected = expected_faces(grid);
+        ogt_mesh_atlas* atlas = ogt_mesh_atlas_from_paletted_voxels(&ctx, grid.voxels.data(), grid.size_x, grid.size_y, grid.size_z);
+        CHECK(atlas != NULL, "%s: no atlas", name.c_str());
+        if (!atlas)
+            continue;
+        std::vector<test_triangle> triangles(atlas->index_count / 3);
+        for (uint32_t t = 0; t < triangles.size(); t++) {
+            for (uint32_t v = 0; v < 3; v++) {
+                const ogt_mesh_atlas_vertex& vertex = atlas->vertices[atlas->indices[t * 3 + v]];
+                triangles[t].pos[v] = vertex.pos;
+                triangles[t].palette_index[v] = UINT32_MAX;
+                triangles[t].uv[v][0] = vertex.u;
+                triangles[t].uv[v][1] = vertex.v;
+            }
+        }
+        check_covers_faces(name, triangles, expected, false);
+        uint32_t bad_texel_count = 0;
+        for (size_t t = 0; t < triangles.size(); t++) {
+            int32_t direction = triangle_direction(triangles[t]);
+            if (direction < 0)
+                continue;
+            for_each_covered_face(triangles[t], direction, [&](const face_key& key, const double* weights) {
+                double u = 0.0, v = 0.0;
+                for (uint32_t i = 0; i < 3; i++) {
+                    u += weights[i] * triangles[t].uv[i][0];
+                    v += weights[i] * triangles[t].uv[i][1];
+                }
+                int32_t texel_x = (int32_t)floor(u * atlas->atlas_width);
+                int32_t texel_y = (int32_t)floor(v * atlas->atlas_height);
+                face_map::const_iterator it = expected.find(key);
+                bool is_inside = texel_x >= 0 && texel_y >= 0 && texel_x < (int32_t)atlas->atlas_width && texel_y < (int32_t)atlas->atlas_height;
+                bad_texel_count += (!is_inside || it == expected.end() || atlas->atlas[texel_x + (texel_y * atlas->atlas_width)] != it->second) ? 1 : 0;
+            });
+        }
+        CHECK(bad_texel_count == 0, "%s: %u faces map to a texel of the wrong palette index", name.c_str(), bad_texel_count);
+        ogt_mesh_atlas_destroy(&ctx, atlas);
+    }
+}
+
+// with ambient_occlusion set, the simple and simple_shared meshers give every vertex the ao of its corner, and every mesher still
+// covers exactly the visible faces. ctx->ambient_occlusion is ignored unless OGT_VOXEL_MESHIFY_VERTEX_AO is defined.
+void test_ao(const std::vector<test_grid>& grids, const ogt_mesh_rgba* palette) {
+#ifdef OGT_VOXEL_MESHIFY_VERTEX_AO
+    const bool vertex_ao_enabled = true;
+    CHECK(sizeof(ogt_mesh_vertex) == 36, "ogt_mesh_vertex is %u bytes rather than 36", (uint32_t)sizeof(ogt_mesh_vertex));
+#else
+    const bool vertex_ao_enabled = false;
+    CHECK(sizeof(ogt_mesh_vertex) == 32, "ogt_mesh_vertex is %u bytes rather than 32", (uint32_t)sizeof(ogt_mesh_vertex));
+#endif
+    ogt_voxel_meshify_context ctx = make_context();
+    ogt_voxel_meshify_context ao_ctx = make_context();
+    ao_ctx.ambient_occlusion = true;
+    for (size_t g = 0; g < grids.size(); g++) {
+        const test_grid& grid = grids[g];
+        face_map expected = expected_faces(grid);
+        for (uint32_t a = 0; a < 4; a++) {
+            std::string name = grid.name + "/" + k_algorithm_names[a] + "/ao";
+            ogt_mesh* mesh    = mesh_grid(&ctx, grid, palette, (ogt_mesh_algorithm)a);
+            ogt_mesh* ao_mesh = mesh_grid(&ao_ctx, grid, palette, (ogt_mesh_algorithm)a);
+            check_covers_faces(name, triangles_from_mesh(ao_mesh), expected, true);
+            check_direction_ranges(name, ao_mesh);
+            check_vertices(name, ao_mesh, palette);
+            uint32_t bad_ao_count = 0;
+            for (uint32_t i = 0; i < mesh->vertex_count; i++)
+                bad_ao_count += vertex_ao(mesh->vertices[i]) != 3 ? 1 : 0;
+            CHECK(bad_ao_count == 0, "%s: %u vertices have ao without ambient_occlusion set", name.c_str(), bad_ao_count);
+            if (!vertex_ao_enabled)
+                CHECK(meshes_identical(mesh, ao_mesh), "%s: ambient_occlusion changed the mesh without OGT_VOXEL_MESHIFY_VERTEX_AO", name.c_str());
+            else if (a == ogt_mesh_algorithm_simple || a == ogt_mesh_algorithm_simple_shared)
+                check_simple_ao(name, grid, ao_mesh);
+            ogt_mesh_destroy(&ctx, ao_mesh);
+            ogt_mesh_destroy(&ctx, mesh);
+        }
+    }
+}
+
+// chunked meshes of instances cover exactly the visible faces of the world that the instances make, with faces between touching
+// instances removed, and every triangle within its chunk.
+void test_chunks(const std::vector<test_grid>& grids, const ogt_mesh_rgba* palette) {
+    const test_grid* noise  = NULL;
+    const test_grid* solid  = NULL;
+    const test_grid* single = NULL;
+    const test_grid* empty  = NULL;
+    for (size_t g = 0; g < grids.size(); g++) {
+        if (grids[g].name == "noise")  noise  = &grids[g];
+        if (grids[g].name == "solid")  solid  = &grids[g];
+        if (grids[g].name == "single") single = &grids[g];
+        if (grids[g].name == "empty")  empty  = &grids[g];
+    }
+    const test_grid* grid_of_model[4] = { noise, solid, single, empty };
+    ogt_mesh_voxel_model models[4];
+    for (uint32_t m = 0; m < 4; m++) {
+        models[m].voxels = grid_of_model[m]->voxels.data();
+        models[m].size_x = grid_of_model[m]->size_x;
+        models[m].size_y = grid_of_model[m]->size_y;
+        models[m].size_z = grid_of_model[m]->size_z;
+    }
+    // touching, overlapping, rotated, mirrored and negative instances, and one of an empty model.
+    const ogt_mesh_voxel_instance instances[7] = {
+        { 0, { 0, 1, 2 }, { false, false, false }, { 0, 0, 0 } },
+        { 1, { 0, 1, 2 }, { false, false, false }, { 19, 0, 0 } },
+        { 1, { 1, 2, 0 }, { true, false, false }, { 3, 2, 4 } },
+        { 0, { 2, 0, 1 }, { false, true, true }, { -30, -5, -2 } },
+        { 2, { 0, 1, 2 }, { false, false, false }, { 27, 3, 3 } },
+        { 3, { 0, 1, 2 }, { false, false, false }, { 40, 40, 40 } },
+        { 1, { 0, 1, 2 }, { false, false, true }, { -8, 13, 10 } },
+    };
+
+    // rasterize the instances into a world grid, in instance order.
+    int32_t world_min[3] = { -64, -64, -64 };
+    test_grid world = make_grid("world", 128, 128, 128);
+    for (uint32_t i = 0; i < 7; i++) {
+        const ogt_mesh_voxel_instance& instance = instances[i];
+        const test_grid& model = *grid_of_model[instance.model_index];
+        for (uint32_t z = 0; z < model.size_z; z++) {
+            for (uint32_t y = 0; y < model.size_y; y++) {
+                for (uint32_t x = 0; x < model.size_x; x++) {
+                    uint8_t color_index = model.get(x, y, z);
+                    if (!color_index)
+                        continue;
+                    int32_t v[3] = { (int32_t)x, (int32_t)y, (int32_t)z };
+                    int32_t w[3];
+                    for (uint32_t a = 0; a < 3; a++)
+                        w[a] = instance.negate[a] ? instance.offset[a] - v[instance.axes[a]] : instance.offset[a] + v[instance.axes[a]];
+                    world.set(w[0] - world_min[0], w[1] - world_min[1], w[2] - world_min[2], color_index);
+                }
+            }
+        }
+    }
+    face_map world_faces = expected_faces(world);
+    face_map expected;
+    for (face_map::const_iterator it = world_faces.begin(); it != world_faces.end(); ++it) {
+        face_key key = { it->first.direction, it->first.x + world_min[0], it->first.y + world_min[1], it->first.z + world_min[2] };
+        expected[key] = it->second;
+    }
+
+    const uint32_t k_chunk_sizes[3] = { 0, 4, 7 };
+    for (uint32_t parallel = 0; parallel < 2; parallel++) {
+        ogt_voxel_meshify_context ctx = parallel ? make_parallel_context() : make_context();
+        for (uint32_t c = 0; c < 3; c++) {
+            for (uint32_t a = 0; a < 4; a++) {
+                std::string name = std::string("chunks ") + std::to_string(k_chunk_sizes[c]) + "/" + k_algorithm_names[a] + (parallel ? "/parallel" : "");
+                ogt_mesh_chunks* chunks = ogt_mesh_chunks_from_voxel_instances(&ctx, models, 4, instances, 7, palette, k_chunk_sizes[c], (ogt_mesh_algorithm)a, k_ogt_mesh_option_remove_duplicate_vertices);
+                CHECK(chunks != NULL, "%s: no chunks", name.c_str());
+                if (!chunks)
+                    continue;
+                CHECK(chunks->chunk_size == (k_chunk_sizes[c] ? k_chunk_sizes[c] : 32), "%s: chunk size is %u", name.c_str(), chunks->chunk_size);
+                CHECK(chunks->meshes && chunks->meshes->model_count == chunks->chunk_count, "%s: no mesh range for each chunk", name.c_str());
+                std::vector<test_triangle> triangles = triangles_from_mesh(&chunks->meshes->mesh);
+                check_covers_faces(name, triangles, expected, true);
+                uint32_t outside_count = 0, empty_chunk_count = 0;
+                const float size = (float)chunks->chunk_size;
+                for (uint32_t i = 0; i < chunks->chunk_count; i++) {
+                    const ogt_mesh_chunk& chunk = chunks->chunks[i];
+                    const ogt_mesh_model_range& range = chunks->meshes->model_ranges[i];
+                    empty_chunk_count += range.index_count ? 0 : 1;
+                    CHECK(chunk.min_x % (int32_t)chunks->chunk_size == 0 && chunk.min_y % (int32_t)chunks->chunk_size == 0 && chunk.min_z % (int32_t)chunks->chunk_size == 0,
+                        "%s: chunk %u is not aligned", name.c_str(), i);
+                    for (uint32_t j = 0; j < range.index_count; j++) {
+                        const ogt_mesh_vec3& p = chunks->meshes->mesh.vertices[chunks->meshes->mesh.indices[range.index_offset + j]].pos;
+                        outside_count += (p.x < chunk.min_x || p.y < chunk.min_y || p.z < chunk.min_z ||
+                                          p.x > chunk.min_x + size || p.y > chunk.min_y + size || p.z > chunk.min_z + size) ? 1 : 0;
+                    }
+                }
+                CHECK(outside_count == 0, "%s: %u vertices are outside their chunk", name.c_str(), outside_count);
+                CHECK(empty_chunk_count == 0, "%s: %u chunks have no triangles", name.c_str(), empty_chunk_count);
+                ogt_mesh_chunks_destroy(&ctx, chunks);
+            }
+        }
+    }
+}
+
+// meshes and post processing of grids with no solid voxels are empty, and nothing reads or writes memory it doesn't own.
+void test_empty(const ogt_voxel_meshify_context* ctx, const ogt_mesh_rgba* palette) {
+    const char* suffix = ctx->parallel_for_func ? "/parallel" : "";
+    test_grid grids[2] = { make_grid("empty", 5, 4, 3), make_grid("empty_single", 1, 1, 1) };
+    for (uint32_t g = 0; g < 2; g++) {
+        const test_grid& grid = grids[g];
+        for (uint32_t a = 0; a < 4; a++) {
+            std::string name = grid.name + "/" + k_algorithm_names[a] + suffix;
+            ogt_mesh* mesh = mesh_grid(ctx, grid, palette, (ogt_mesh_algorithm)a);
+            CHECK(mesh && mesh->vertex_count == 0 && mesh->index_count == 0, "%s: mesh is not empty", name.c_str());
+            if (!mesh)
+                continue;
+            ogt_mesh_remove_duplicate_vertices(ctx, mesh);
+            ogt_mesh_smooth_normals(ctx, mesh);
+            ogt_mesh_smooth_normals_with_angle(ctx, mesh, 45.0f);
+            ogt_mesh_optimize(ctx, mesh, 0);
+            CHECK(ogt_mesh_get_acmr(ctx, mesh, 0) == 0.0f, "%s: acmr of an empty mesh is not 0", name.c_str());
+            ogt_mesh_sort_triangles_by_direction(ctx, mesh, NULL);
+            ogt_mesh_meshlets* meshlets = ogt_mesh_build_meshlets(ctx, mesh, 0, 0);
+            CHECK(!meshlets || meshlets->meshlet_count == 0, "%s: an empty mesh has meshlets", name.c_str());
+            ogt_mesh_meshlets_destroy(ctx, meshlets);
+            CHECK(mesh->vertex_count == 0 && mesh->index_count == 0, "%s: post processing added to an empty mesh", name.c_str());
+            ogt_mesh_destroy(ctx, mesh);
+
+            ogt_mesh_voxel_model model = { grid.voxels.data(), grid.size_x, grid.size_y, grid.size_z };
+            for (uint32_t options = 0; options < 4; options++) {
+                ogt_mesh_models* models = ogt_mesh_from_paletted_voxel_models(ctx, &model, 1, palette, (ogt_mesh_algorithm)a, options);
+                CHECK(models && models->model_count == 1 && models->mesh.index_count == 0, "%s: models with options %u are not empty", name.c_str(), options);
+                ogt_mesh_models_destroy(ctx, models);
+            }
+            ogt_mesh_occluder* occluder = ogt_mesh_occluder_from_voxels(ctx, grid.voxels.data(), grid.size_x, grid.size_y, grid.size_z, (ogt_mesh_algorithm)a);
+            CHECK(occluder && occluder->index_count == 0, "%s: occluder is not empty", name.c_str());
+            ogt_mesh_occluder_destroy(ctx, occluder);
+
+            ogt_mesh_voxel_instance instance = { 0, { 0, 1, 2 }, { false, false, false }, { 0, 0, 0 } };
+            ogt_mesh_chunks* chunks = ogt_mesh_chunks_from_voxel_instances(ctx, &model, 1, &instance, 1, palette, 0, (ogt_mesh_algorithm)a, k_ogt_mesh_option_smooth_normals);
+            CHECK(chunks && chunks->chunk_count == 0, "%s: chunks are not empty", name.c_str());
+            ogt_mesh_chunks_destroy(ctx, chunks);
+        }
+        std::string name = grid.name + suffix;
+        stream_collector collector;
+        init_stream_collector(collector);
+        ogt_stream_from_paletted_voxels_simple_batched(ctx, grid.voxels.data(), grid.size_x, grid.size_y, grid.size_z, palette, 0, collect_stream_batch, &collector);
+        CHECK(collector.indices.empty(), "%s: stream is not empty", name.c_str());
+        ogt_mesh_boxes* boxes = ogt_boxes_from_paletted_voxels(ctx, grid.voxels.data(), grid.size_x, grid.size_y, grid.size_z, 1, k_ogt_boxes_option_fill_interior);
+        CHECK(boxes && boxes->box_count == 0, "%s: boxes are not empty", name.c_str());
+        ogt_boxes_destroy(ctx, boxes);
+        ogt_mesh_voxel_lods* lods = ogt_mesh_voxel_lods_create(ctx, grid.voxels.data(), grid.size_x, grid.size_y, grid.size_z, 0, ogt_mesh_lod_filter_conservative, k_ogt_mesh_lod_option_preserve_surface);
+        ogt_mesh_models* lod_meshes = lods ? ogt_mesh_voxel_lods_meshify(ctx, lods, palette, ogt_mesh_algorithm_polygon, k_ogt_mesh_option_smooth_normals) : NULL;
+        CHECK(lod_meshes && lod_meshes->mesh.index_count == 0, "%s: lod meshes are not empty", name.c_str());
+        ogt_mesh_models_destroy(ctx, lod_meshes);
+        ogt_mesh_voxel_lods_destroy(ctx, lods);
+        ogt_mesh_atlas* atlas = ogt_mesh_atlas_from_paletted_voxels(ctx, grid.voxels.data(), grid.size_x, grid.size_y, grid.size_z);
+        CHECK(atlas && atlas->index_count == 0, "%s: atlas is not empty", name.c_str());
+        ogt_mesh_atlas_destroy(ctx, atlas);
+    }
+}
+
+int main(int argc, char** argv) {
+    (void)argc;
+    (void)argv;
+    ogt_mesh_rgba palette[256];
+    make_test_palette(palette);
+    std::vector<test_grid> grids = make_test_grids();
+    ogt_voxel_meshify_context ctx = make_context();
+    ogt_voxel_meshify_context parallel_ctx = make_parallel_context();
+
+    struct { const char* name; uint32_t failure_count; } results[32];
+    uint32_t result_count = 0;
+#define RUN_TEST(_call) do { uint32_t failures = g_failure_count; _call; results[result_count].name = #_call; results[result_count++].failure_count = g_failure_count - failures; } while (0)
+    RUN_TEST(test_meshers(grids, palette));
+    RUN_TEST(test_batched_stream(grids, palette));
+    RUN_TEST(test_shared_vertices(grids, palette));
+    RUN_TEST(test_scratch(grids, palette));
+    RUN_TEST(test_smooth_normals(grids, palette));
+    RUN_TEST(test_models(grids, palette));
+    RUN_TEST(test_optimize(grids, palette));
+    RUN_TEST(test_meshlets(grids, palette));
+    RUN_TEST(test_sort_by_direction(grids, palette));
+    RUN_TEST(test_occluders(grids));
+    RUN_TEST(test_boxes(grids));
+    RUN_TEST(test_lods(grids, palette));
+    RUN_TEST(test_atlas(grids));
+    RUN_TEST(test_ao(grids, palette));
+    RUN_TEST(test_chunks(grids, palette));
+    RUN_TEST(test_empty(&ctx, palette));
+    RUN_TEST(test_empty(&parallel_ctx, palette));
+#undef RUN_TEST
+
+    for (uint32_t i = 0; i < result_count; i++)
+        printf("%-8s %s\n", results[i].failure_count ? "FAILED" : "passed", results[i].name);
+    printf("%u of %u checks failed\n", g_failure_count, g_check_count);
+    return g_failure_count ? 1 : 0;
+}
+
+/* -------------------------------------------------------------------------------------------------------------------------------------------------
+
+    MIT License
+
+    Copyright (c) 2026 Justin Paver
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+    IN THE SOFTWARE.
+
+------------------------------------------------------------------------------------------------------------------------------------------------- */